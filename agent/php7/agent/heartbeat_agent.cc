@@ -15,6 +15,7 @@
  */
 
 #include "utils/json_reader.h"
+#include "utils/config_image.h"
 #include "utils/file.h"
 #include "utils/validator.h"
 #include "openrasp_agent.h"
@@ -187,8 +188,10 @@ bool HeartBeatAgent::do_heartbeat()
 					}
 					oam->set_webdir_scan_regex(scan_regex.c_str());
 				}
+				//只在 agent 中解析、校验一次，工作进程直接读取共享内存中的配置镜像
+				openrasp::ConfigImageWriter image_writer(&config_reader);
 				openrasp::ConfigHolder dummy;
-				dummy.update(&config_reader);
+				dummy.update(&image_writer);
 				/************************************OPENRASP_G(config)************************************/
 				std::string cloud_config_file_path = std::string(openrasp_ini.root_dir) + "/conf/cloud-config.json";
 #ifndef _WIN32
@@ -203,7 +206,7 @@ bool HeartBeatAgent::do_heartbeat()
 #endif
 				if (write_ok)
 				{
-					scm->set_config_last_update(config_time);
+					scm->publish_config(config_time, image_writer.build(config_time));
 					openrasp_error(LEVEL_DEBUG, HEARTBEAT_ERROR, _("Successfully update config, config time: %ld."),
 								   config_time);
 					result = true;
@@ -28,7 +28,8 @@ enum ShmemSecKey
   SHMEM_SEC_PLUGIN_BLOCK,
   SHMEM_SEC_WEBDIR_BLOCK,
   SHMEM_SEC_CONF_BLOCK,
-  SHMEM_SEC_LOG_BLOCK
+  SHMEM_SEC_LOG_BLOCK,
+  SHMEM_SEC_DNS_BLOCK
 };
 
 class ShmemSecMeta
@@ -20,21 +20,172 @@
 #include "openrasp_hook.h"
 #include "utils/double_array_trie.h"
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <sched.h>
 
 namespace openrasp
 {
+/**
+ * 共享配置在进程（线程）内的副本，generation 为奇数表示尚未加载
+ */
+struct SharedConfigSnapshot
+{
+  uint64_t generation = 1;
+  long config_update_time = 0;
+  long log_max_backup = 0;
+  long debug_level = 0;
+  OpenRASPActionType actions[ALL_TYPE] = {AC_IGNORE};
+  std::string check_type_white_array;
+  std::string weak_password_array;
+  std::string pg_error_array;
+  std::string env_key_array;
+  std::string config_image;
+  std::vector<long> mysql_error_codes;
+  std::vector<long> sqlite_error_codes;
+};
+
+/**
+ * 写入方仍由进程间读写锁互斥，并在写入前后各递增一次 generation（seqlock）；
+ * 读取方不加锁，两次读到相同的偶数 generation 时复制出的内容才是一致的
+ */
 class SharedConfigBlock
 {
 public:
-  static const int WHITE_ARRAY_MAX_SIZE = (200 * 200 * (DoubleArrayTrie::unit_size()) * 2);
+  static const int SEQLOCK_MAX_RETRY = 1000;
+  static const int RELOAD_BUILD_STALE_SECONDS = 120;
+  //hook.white 编译为 UrlMatcher 后的字节数上限，不限制条目数；实测 20000 条规则编译后为 0.75~2.5MB，视路径长度而定
+  static const int WHITE_ARRAY_MAX_SIZE = 4 * 1024 * 1024;
   static const int WEAK_PASSWORD_ARRAY_MAX_SIZE = (200 * 16 * (DoubleArrayTrie::unit_size()) * 2);
   static const int PG_ERROR_ARRAY_MAX_SIZE = (200 * 5 * (DoubleArrayTrie::unit_size()) * 2);
   static const int ENV_KEY_ARRAY_MAX_SIZE = (200 * 50 * (DoubleArrayTrie::unit_size()) * 2);
   static const int MYSQL_ERROR_CODE_MAX_SIZE = 100;
   static const int PGSQL_ERROR_CODE_MAX_SIZE = 100;
   static const int SQLITE_ERROR_CODE_MAX_SIZE = 100;
+  static const int CONFIG_IMAGE_MAX_SIZE = 256 * 1024;
   static const int WEBSHELL_ENV_KEY_MAX_SIZE = 200;
 
+  inline void init_generation(uint64_t seed)
+  {
+    __atomic_store_n(&generation, seed & ~static_cast<uint64_t>(1), __ATOMIC_RELEASE);
+  }
+
+  inline uint64_t get_generation() const
+  {
+    return __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+  }
+
+  inline void write_begin()
+  {
+    __atomic_store_n(&generation, generation + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+  }
+
+  inline void write_end()
+  {
+    __atomic_store_n(&generation, generation + 1, __ATOMIC_RELEASE);
+  }
+
+  /**
+   * 复制出一致的快照，写入方长时间未完成（如写入进程崩溃）时放弃并返回 false
+   */
+  inline bool read_snapshot(SharedConfigSnapshot &snapshot) const
+  {
+    for (int retry = 0; retry < SEQLOCK_MAX_RETRY; ++retry)
+    {
+      uint64_t begin = get_generation();
+      if (begin & 1)
+      {
+        sched_yield();
+        continue;
+      }
+      snapshot.config_update_time = config_update_time;
+      snapshot.log_max_backup = log_max_backup;
+      snapshot.debug_level = debug_level;
+      memcpy(snapshot.actions, actions, sizeof(actions));
+      //读取过程中可能与写入交错，长度先截断到上限，结果在校验 generation 后才会被使用
+      snapshot.check_type_white_array.assign(check_type_white_array, clamp_size(white_array_size, WHITE_ARRAY_MAX_SIZE));
+      snapshot.weak_password_array.assign(weak_password_array, clamp_size(weak_password_array_size, WEAK_PASSWORD_ARRAY_MAX_SIZE));
+      snapshot.pg_error_array.assign(pg_error_array, clamp_size(pg_error_array_size, PG_ERROR_ARRAY_MAX_SIZE));
+      snapshot.env_key_array.assign(env_key_array, clamp_size(env_key_array_size, ENV_KEY_ARRAY_MAX_SIZE));
+      snapshot.config_image.assign(config_image, clamp_size(config_image_size, CONFIG_IMAGE_MAX_SIZE));
+      snapshot.mysql_error_codes.assign(mysql_error_codes, mysql_error_codes + clamp_size(mysql_error_codes_size, MYSQL_ERROR_CODE_MAX_SIZE));
+      snapshot.sqlite_error_codes.assign(sqlite_error_codes, sqlite_error_codes + clamp_size(sqlite_error_codes_size, SQLITE_ERROR_CODE_MAX_SIZE));
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&generation, __ATOMIC_RELAXED) == begin)
+      {
+        snapshot.generation = begin;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * 本地模式热加载：fswatch 递增 reload_requested 并领取，由单独的构建进程重建，完成后写入 reload_done；
+   * 重建失败时 reload_snapshot_timestamp 保持不变，工作进程继续使用旧快照
+   * 领取与完成都在进程间写锁内调用，读取方只读 reload_done 与 reload_snapshot_timestamp
+   */
+  inline uint64_t request_reload()
+  {
+    return __atomic_add_fetch(&reload_requested, 1, __ATOMIC_ACQ_REL);
+  }
+
+  inline uint64_t get_reload_requested() const
+  {
+    return __atomic_load_n(&reload_requested, __ATOMIC_ACQUIRE);
+  }
+
+  inline uint64_t get_reload_done() const
+  {
+    return __atomic_load_n(&reload_done, __ATOMIC_ACQUIRE);
+  }
+
+  inline int64_t get_reload_snapshot_timestamp() const
+  {
+    return __atomic_load_n(&reload_snapshot_timestamp, __ATOMIC_ACQUIRE);
+  }
+
+  /**
+   * 已有未完成的重建且开始时间不超过 RELOAD_BUILD_STALE_SECONDS 时领取失败；
+   * 超时的重建视为构建方已退出，由本次领取接替，stale 返回被接替的请求序号，否则为 0
+   */
+  inline bool try_begin_reload(uint64_t requested, int64_t now, uint64_t &stale)
+  {
+    stale = 0;
+    if (requested <= reload_done)
+    {
+      return false;
+    }
+    if (reload_building > reload_done)
+    {
+      if (now - reload_build_started < RELOAD_BUILD_STALE_SECONDS)
+      {
+        return false;
+      }
+      stale = reload_building;
+    }
+    reload_building = requested;
+    reload_build_started = now;
+    return true;
+  }
+
+  //被接替的重建晚于接替者完成时不回退已发布的状态
+  inline void finish_reload(uint64_t requested, int64_t snapshot_timestamp)
+  {
+    if (requested <= reload_done)
+    {
+      return;
+    }
+    if (snapshot_timestamp > reload_snapshot_timestamp)
+    {
+      __atomic_store_n(&reload_snapshot_timestamp, snapshot_timestamp, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&reload_done, requested, __ATOMIC_RELEASE);
+  }
+
   inline char *get_check_type_white_array()
   {
     return check_type_white_array;
@@ -51,12 +202,23 @@ public:
     {
       return false;
     }
-    memset(&check_type_white_array, 0, sizeof(check_type_white_array));
+    //按 white_array_size 读取，无需清零整个数组
     memcpy((void *)&check_type_white_array, source, num);
     white_array_size = num;
     return true;
   }
 
+  inline bool reset_config_image(const void *source, size_t num)
+  {
+    if (num > CONFIG_IMAGE_MAX_SIZE)
+    {
+      return false;
+    }
+    memcpy((void *)&config_image, source, num);
+    config_image_size = num;
+    return true;
+  }
+
   inline char *get_weak_password_array()
   {
     return weak_password_array;
@@ -231,6 +393,17 @@ public:
   }
 
 private:
+  static inline size_t clamp_size(long size, long max_size)
+  {
+    return size < 0 ? 0 : static_cast<size_t>(std::min(size, max_size));
+  }
+
+  uint64_t generation = 0;
+  uint64_t reload_requested = 0;
+  uint64_t reload_building = 0;
+  int64_t reload_build_started = 0;
+  uint64_t reload_done = 0;
+  int64_t reload_snapshot_timestamp = 0;
   long config_update_time = 0;
   long log_max_backup = 0;
   long debug_level = 0;
@@ -248,6 +421,9 @@ private:
   size_t env_key_array_size;
   char env_key_array[ENV_KEY_ARRAY_MAX_SIZE + 1];
 
+  size_t config_image_size;
+  char config_image[CONFIG_IMAGE_MAX_SIZE];
+
   int mysql_error_codes_size = 0;
   long mysql_error_codes[MYSQL_ERROR_CODE_MAX_SIZE] = {0};
 
@@ -255,4 +431,14 @@ private:
   long sqlite_error_codes[SQLITE_ERROR_CODE_MAX_SIZE] = {0};
 };
 
+class SeqlockWriter
+{
+public:
+  SeqlockWriter(SharedConfigBlock *block) : block(block) { block->write_begin(); }
+  ~SeqlockWriter() { block->write_end(); }
+
+private:
+  SharedConfigBlock *block;
+};
+
 } // namespace openrasp
@@ -20,8 +20,11 @@
 #include "utils/digest.h"
 #include "utils/net.h"
 #include "utils/hostname.h"
+#include "utils/url_matcher.h"
 #include "openrasp_v8.h"
+#include "openrasp_log.h"
 #include <algorithm>
+#include <utility>
 
 namespace openrasp
 {
@@ -42,21 +45,41 @@ SharedConfigManager::~SharedConfigManager()
     }
 }
 
-dat_value SharedConfigManager::get_check_type_white_bit_mask(std::string url)
+#ifdef ZTS
+static thread_local SharedConfigSnapshot local_snapshot;
+#else
+static SharedConfigSnapshot local_snapshot;
+#endif
+static const SharedConfigSnapshot empty_snapshot;
+
+const SharedConfigSnapshot &SharedConfigManager::snapshot()
 {
-    DoubleArrayTrie dat;
-    dat_value white_bit_mask = 0;
-    if (rwlock != nullptr && rwlock->read_lock())
+    if (nullptr == shared_config_block)
     {
-        ReadUnLocker auto_unlocker(rwlock);
-        dat.set_array((void *)shared_config_block->get_check_type_white_array(), shared_config_block->get_white_array_size());
-        std::vector<DoubleArrayTrie::result_pair_type> result_pairs = dat.prefix_search(url.c_str());
-        for (DoubleArrayTrie::result_pair_type result_pair : result_pairs)
+        return empty_snapshot;
+    }
+    //generation 未变化时只有一次普通读，不触碰读写锁所在的缓存行
+    if (shared_config_block->get_generation() != local_snapshot.generation)
+    {
+        SharedConfigSnapshot fresh;
+        if (shared_config_block->read_snapshot(fresh))
         {
-            white_bit_mask |= result_pair.value;
+            local_snapshot = std::move(fresh);
         }
     }
-    return white_bit_mask;
+    return local_snapshot;
+}
+
+static void attach_array(DoubleArrayTrie &dat, const std::string &array)
+{
+    dat.set_array(const_cast<char *>(array.data()), array.length());
+}
+
+dat_value SharedConfigManager::get_check_type_white_bit_mask(const char *url, size_t length)
+{
+    const SharedConfigSnapshot &config = snapshot();
+    UrlMatcher matcher(config.check_type_white_array.data(), config.check_type_white_array.size());
+    return matcher.match(url, length);
 }
 
 bool SharedConfigManager::write_check_type_white_array_to_shm(const void *source, size_t num)
@@ -64,28 +87,33 @@ bool SharedConfigManager::write_check_type_white_array_to_shm(const void *source
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
-        shared_config_block->reset_white_array(source, num);
-        return true;
+        SeqlockWriter seqlock_writer(shared_config_block);
+        return shared_config_block->reset_white_array(source, num);
     }
     return false;
 }
 
 bool SharedConfigManager::build_check_type_white_array(std::map<std::string, dat_value> &url_mask_map)
 {
-    std::vector<std::string> urls;
-    std::vector<dat_value> values;
-    for (auto iter = url_mask_map.begin(); iter != url_mask_map.end(); iter++)
+    UrlMatcherBuilder builder;
+    for (auto &item : url_mask_map)
     {
-        urls.push_back(iter->first);
-        values.push_back(iter->second);
+        builder.add(item.first, item.second);
     }
-    DoubleArrayTrie dat;
-    int error = dat.build(urls.size(), &urls, 0, &values);
-    if (error < 0 || dat.total_size() > SharedConfigBlock::WHITE_ARRAY_MAX_SIZE)
+    std::string matcher = builder.build();
+    if (matcher.size() > SharedConfigBlock::WHITE_ARRAY_MAX_SIZE)
+    {
+        openrasp_error(LEVEL_WARNING, CONFIG_ERROR, _("hook.white with %zu rules compiles to %zu bytes, exceeding the shared memory limit of %d bytes; the previous hook.white stays in effect."),
+                       url_mask_map.size(), matcher.size(), SharedConfigBlock::WHITE_ARRAY_MAX_SIZE);
+        return false;
+    }
+    if (!write_check_type_white_array_to_shm(matcher.data(), matcher.size()))
     {
+        openrasp_error(LEVEL_WARNING, CONFIG_ERROR, _("Fail to write hook.white (%zu rules, %zu bytes) to shared memory; the previous hook.white stays in effect."),
+                       url_mask_map.size(), matcher.size());
         return false;
     }
-    return write_check_type_white_array_to_shm(dat.array(), dat.total_size());
+    return true;
 }
 
 bool SharedConfigManager::build_check_type_white_array(std::map<std::string, std::vector<std::string>> &url_type_map)
@@ -131,33 +159,94 @@ bool SharedConfigManager::build_check_type_white_array(BaseReader *br)
 
 long SharedConfigManager::get_config_last_update()
 {
-    if (rwlock != nullptr && rwlock->read_lock())
+    return snapshot().config_update_time;
+}
+
+bool SharedConfigManager::set_config_last_update(long config_update_timestamp)
+{
+    if (rwlock != nullptr && rwlock->write_lock())
     {
-        ReadUnLocker auto_unlocker(rwlock);
-        return shared_config_block->get_config_update_time();
+        WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
+        shared_config_block->set_config_update_time(config_update_timestamp);
+        return true;
     }
-    return 0;
+    return false;
 }
 
-bool SharedConfigManager::set_config_last_update(long config_update_timestamp)
+bool SharedConfigManager::publish_config(long config_update_timestamp, const std::string &config_image)
 {
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
+        //镜像超出上限时置空，工作进程回退到读取配置文件
+        if (!shared_config_block->reset_config_image(config_image.data(), config_image.size()))
+        {
+            shared_config_block->reset_config_image(nullptr, 0);
+        }
         shared_config_block->set_config_update_time(config_update_timestamp);
         return true;
     }
     return false;
 }
 
-long SharedConfigManager::get_log_max_backup()
+std::string SharedConfigManager::get_config_image()
+{
+    return snapshot().config_image;
+}
+
+uint64_t SharedConfigManager::request_reload()
+{
+    return nullptr != shared_config_block ? shared_config_block->request_reload() : 0;
+}
+
+uint64_t SharedConfigManager::get_reload_requested()
+{
+    return nullptr != shared_config_block ? shared_config_block->get_reload_requested() : 0;
+}
+
+uint64_t SharedConfigManager::get_reload_done()
 {
-    if (rwlock != nullptr && rwlock->read_lock())
+    return nullptr != shared_config_block ? shared_config_block->get_reload_done() : 0;
+}
+
+int64_t SharedConfigManager::get_reload_snapshot_timestamp()
+{
+    return nullptr != shared_config_block ? shared_config_block->get_reload_snapshot_timestamp() : 0;
+}
+
+bool SharedConfigManager::try_begin_reload(uint64_t requested)
+{
+    if (rwlock != nullptr && rwlock->write_lock())
     {
-        ReadUnLocker auto_unlocker(rwlock);
-        return shared_config_block->get_log_max_backup();
+        WriteUnLocker auto_unlocker(rwlock);
+        uint64_t stale = 0;
+        if (shared_config_block->try_begin_reload(requested, static_cast<int64_t>(time(nullptr)), stale))
+        {
+            if (stale > 0)
+            {
+                openrasp_error(LEVEL_WARNING, RUNTIME_ERROR, _("Reload request %" PRIu64 " did not finish within %d seconds, take it over with request %" PRIu64 "."),
+                               stale, SharedConfigBlock::RELOAD_BUILD_STALE_SECONDS, requested);
+            }
+            return true;
+        }
     }
-    return 0;
+    return false;
+}
+
+void SharedConfigManager::finish_reload(uint64_t requested, int64_t snapshot_timestamp)
+{
+    if (rwlock != nullptr && rwlock->write_lock())
+    {
+        WriteUnLocker auto_unlocker(rwlock);
+        shared_config_block->finish_reload(requested, snapshot_timestamp);
+    }
+}
+
+long SharedConfigManager::get_log_max_backup()
+{
+    return snapshot().log_max_backup;
 }
 
 bool SharedConfigManager::set_log_max_backup(long log_max_backup)
@@ -165,6 +254,7 @@ bool SharedConfigManager::set_log_max_backup(long log_max_backup)
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         shared_config_block->set_log_max_backup(log_max_backup);
         return true;
     }
@@ -173,12 +263,7 @@ bool SharedConfigManager::set_log_max_backup(long log_max_backup)
 
 long SharedConfigManager::get_debug_level()
 {
-    if (rwlock != nullptr && rwlock->read_lock())
-    {
-        ReadUnLocker auto_unlocker(rwlock);
-        return shared_config_block->get_debug_level();
-    }
-    return 0;
+    return snapshot().debug_level;
 }
 
 bool SharedConfigManager::set_debug_level(long debug_level)
@@ -186,6 +271,7 @@ bool SharedConfigManager::set_debug_level(long debug_level)
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         shared_config_block->set_debug_level(debug_level);
         return true;
     }
@@ -207,6 +293,7 @@ bool SharedConfigManager::set_buildin_check_action(std::map<OpenRASPCheckType, O
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         for (auto &action : buildin_action_map)
         {
             shared_config_block->set_check_type_action(action.first, action.second);
@@ -218,10 +305,9 @@ bool SharedConfigManager::set_buildin_check_action(std::map<OpenRASPCheckType, O
 
 OpenRASPActionType SharedConfigManager::get_buildin_check_action(OpenRASPCheckType check_type)
 {
-    if (rwlock != nullptr && rwlock->read_lock())
+    if (check_type > INVALID_TYPE && check_type < ALL_TYPE && nullptr != shared_config_block)
     {
-        ReadUnLocker auto_unlocker(rwlock);
-        return shared_config_block->get_check_type_action(check_type);
+        return snapshot().actions[check_type];
     }
     return AC_IGNORE;
 }
@@ -236,6 +322,8 @@ bool SharedConfigManager::startup()
         rwlock = new ReadWriteLock((pthread_rwlock_t *)shm_block, LOCK_PROCESS);
         char *shm_config_block = shm_block + meta_size;
         shared_config_block = reinterpret_cast<SharedConfigBlock *>(shm_config_block);
+        //重新创建共享内存后，进程内旧的快照不能与新的 generation 相同
+        shared_config_block->init_generation(static_cast<uint64_t>(time(nullptr)) << 20);
         std::map<std::string, dat_value> all_type_white{{"", ~0}};
         build_check_type_white_array(all_type_white);
         build_rasp_id();
@@ -299,6 +387,7 @@ bool SharedConfigManager::write_weak_password_array_to_shm(const void *source, s
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         return shared_config_block->reset_weak_password_array(source, num);
     }
     return false;
@@ -346,11 +435,11 @@ bool SharedConfigManager::build_weak_password_array(BaseReader *br)
 
 bool SharedConfigManager::is_password_weak(std::string password)
 {
-    DoubleArrayTrie dat;
-    if (rwlock != nullptr && rwlock->read_lock())
+    const SharedConfigSnapshot &config = snapshot();
+    if (!config.weak_password_array.empty())
     {
-        ReadUnLocker auto_unlocker(rwlock);
-        dat.set_array((void *)shared_config_block->get_weak_password_array(), shared_config_block->get_weak_password_array_size());
+        DoubleArrayTrie dat;
+        attach_array(dat, config.weak_password_array);
         DoubleArrayTrie::result_pair_type result_pair = dat.match_search(password.c_str());
         return result_pair.value != -1;
     }
@@ -362,18 +451,15 @@ void SharedConfigManager::set_mysql_error_codes(std::vector<int64_t> error_codes
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         shared_config_block->set_mysql_error_codes(error_codes);
     }
 }
 
 bool SharedConfigManager::mysql_error_code_exist(int64_t err_code)
 {
-    if (rwlock != nullptr && rwlock->read_lock())
-    {
-        ReadUnLocker auto_unlocker(rwlock);
-        return shared_config_block->mysql_error_code_exist(err_code);
-    }
-    return false;
+    const auto &codes = snapshot().mysql_error_codes;
+    return std::find(codes.begin(), codes.end(), err_code) != codes.end();
 }
 
 void SharedConfigManager::set_sqlite_error_codes(std::vector<int64_t> error_codes)
@@ -381,18 +467,15 @@ void SharedConfigManager::set_sqlite_error_codes(std::vector<int64_t> error_code
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         shared_config_block->set_sqlite_error_codes(error_codes);
     }
 }
 
 bool SharedConfigManager::sqlite_error_code_exist(int64_t err_code)
 {
-    if (rwlock != nullptr && rwlock->read_lock())
-    {
-        ReadUnLocker auto_unlocker(rwlock);
-        return shared_config_block->sqlite_error_code_exist(err_code);
-    }
-    return false;
+    const auto &codes = snapshot().sqlite_error_codes;
+    return std::find(codes.begin(), codes.end(), err_code) != codes.end();
 }
 
 bool SharedConfigManager::write_pg_error_array_to_shm(const void *source, size_t num)
@@ -400,6 +483,7 @@ bool SharedConfigManager::write_pg_error_array_to_shm(const void *source, size_t
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         return shared_config_block->reset_pg_error_array(source, num);
     }
     return false;
@@ -429,11 +513,11 @@ bool SharedConfigManager::build_pg_error_array(Isolate *isolate)
 
 bool SharedConfigManager::pg_error_filtered(std::string error)
 {
-    DoubleArrayTrie dat;
-    if (rwlock != nullptr && rwlock->read_lock())
+    const SharedConfigSnapshot &config = snapshot();
+    if (!config.pg_error_array.empty())
     {
-        ReadUnLocker auto_unlocker(rwlock);
-        dat.set_array((void *)shared_config_block->get_pg_error_array(), shared_config_block->get_pg_error_array_size());
+        DoubleArrayTrie dat;
+        attach_array(dat, config.pg_error_array);
         DoubleArrayTrie::result_pair_type result_pair = dat.match_search(error.c_str());
         return result_pair.value != -1;
     }
@@ -445,6 +529,7 @@ bool SharedConfigManager::write_env_key_array_to_shm(const void *source, size_t
     if (rwlock != nullptr && rwlock->write_lock())
     {
         WriteUnLocker auto_unlocker(rwlock);
+        SeqlockWriter seqlock_writer(shared_config_block);
         return shared_config_block->reset_env_key_array(source, num);
     }
     return false;
@@ -474,22 +559,21 @@ bool SharedConfigManager::build_env_key_array(Isolate *isolate)
 
 bool SharedConfigManager::filter_env_key(const std::string &env)
 {
-    DoubleArrayTrie dat;
+    const SharedConfigSnapshot &config = snapshot();
     bool found = false;
-    if (rwlock != nullptr && rwlock->read_lock())
+    if (!config.env_key_array.empty())
     {
-        ReadUnLocker auto_unlocker(rwlock);
-        dat.set_array((void *)shared_config_block->get_env_key_array(), shared_config_block->get_env_key_array_size());
-        std::vector<DoubleArrayTrie::result_pair_type> result_pairs = dat.prefix_search(env.c_str());
-        for (DoubleArrayTrie::result_pair_type result_pair : result_pairs)
-        {
+        DoubleArrayTrie dat;
+        attach_array(dat, config.env_key_array);
+        dat.foreach_prefix(env.c_str(), env.length(), [&](const DoubleArrayTrie::result_pair_type &result_pair) {
             if (result_pair.value != -1 &&
-                result_pair.length <= env.length() - 1 &&
+                result_pair.length < env.length() &&
                 '=' == env[result_pair.length])
             {
                 found = true;
             }
-        }
+            return !found;
+        });
     }
     return found;
 }
@@ -38,6 +38,18 @@ public:
 
   long get_config_last_update();
   bool set_config_last_update(long config_update_timestamp);
+  /**
+   * 同时发布配置时间与 agent 预先解析好的配置镜像（见 utils/config_image.h）
+   */
+  bool publish_config(long config_update_timestamp, const std::string &config_image);
+  std::string get_config_image();
+
+  uint64_t request_reload();
+  uint64_t get_reload_requested();
+  uint64_t get_reload_done();
+  int64_t get_reload_snapshot_timestamp();
+  bool try_begin_reload(uint64_t requested);
+  void finish_reload(uint64_t requested, int64_t snapshot_timestamp);
 
   long get_log_max_backup();
   bool set_log_max_backup(long log_max_backup);
@@ -45,7 +57,7 @@ public:
   long get_debug_level();
   bool set_debug_level(BaseReader *br);
 
-  dat_value get_check_type_white_bit_mask(std::string url);
+  dat_value get_check_type_white_bit_mask(const char *url, size_t length);
   bool build_check_type_white_array(BaseReader *br);
 
   bool build_weak_password_array(BaseReader *br);
@@ -71,6 +83,8 @@ public:
   bool sqlite_error_code_exist(int64_t err_code);
 
 private:
+  const SharedConfigSnapshot &snapshot();
+
   int meta_size;
   ReadWriteLock *rwlock;
   SharedConfigBlock *shared_config_block;
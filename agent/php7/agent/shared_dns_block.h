@@ -0,0 +1,124 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "openrasp.h"
+#include <string>
+#include <vector>
+#include <cstring>
+
+namespace openrasp
+{
+
+class SharedDnsBlock
+{
+public:
+  static const int ENTRY_SIZE = 512;
+  static const int PROBE_SIZE = 8;
+  static const int HOST_MAX_LEN = 255;
+  static const int IP_MAX_SIZE = 8;
+  static const int IP_MAX_LEN = 46;
+
+  inline bool find(ulong hash, const std::string &host, long now, int &status, std::vector<std::string> &ips)
+  {
+    for (int i = 0; i < PROBE_SIZE; ++i)
+    {
+      const DnsEntry &entry = entries[(hash + i) % ENTRY_SIZE];
+      if (entry.hash == hash && entry.expire > now && host == entry.host)
+      {
+        status = entry.status;
+        for (int j = 0; j < entry.ip_size; ++j)
+        {
+          ips.emplace_back(entry.ips[j]);
+        }
+        __sync_fetch_and_add(&hits, 1);
+        return true;
+      }
+    }
+    __sync_fetch_and_add(&misses, 1);
+    return false;
+  }
+
+  inline bool store(ulong hash, const std::string &host, long expire, int status, const std::vector<std::string> &ips)
+  {
+    if (host.length() > HOST_MAX_LEN)
+    {
+      return false;
+    }
+    DnsEntry *target = nullptr;
+    for (int i = 0; i < PROBE_SIZE; ++i)
+    {
+      DnsEntry *entry = &entries[(hash + i) % ENTRY_SIZE];
+      if (entry->hash == hash && host == entry->host)
+      {
+        target = entry;
+        break;
+      }
+      if (nullptr == target || entry->expire < target->expire)
+      {
+        target = entry;
+      }
+    }
+    target->hash = hash;
+    target->expire = expire;
+    target->status = status;
+    strncpy(target->host, host.c_str(), HOST_MAX_LEN);
+    target->host[HOST_MAX_LEN] = '\0';
+    target->ip_size = 0;
+    for (const std::string &ip : ips)
+    {
+      if (target->ip_size >= IP_MAX_SIZE)
+      {
+        break;
+      }
+      if (ip.length() < IP_MAX_LEN)
+      {
+        strncpy(target->ips[target->ip_size], ip.c_str(), IP_MAX_LEN);
+        target->ip_size++;
+      }
+    }
+    return true;
+  }
+
+  inline long get_hits() const
+  {
+    return hits;
+  }
+
+  inline long get_misses() const
+  {
+    return misses;
+  }
+
+private:
+  struct DnsEntry
+  {
+    ulong hash;
+    long expire;
+    int status;
+    int ip_size;
+    char host[HOST_MAX_LEN + 1];
+    char ips[IP_MAX_SIZE][IP_MAX_LEN];
+  };
+
+  long hits = 0;
+  long misses = 0;
+  DnsEntry entries[ENTRY_SIZE];
+};
+
+} // namespace openrasp
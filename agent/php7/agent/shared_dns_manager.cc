@@ -0,0 +1,141 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "shared_dns_manager.h"
+#include <time.h>
+
+namespace openrasp
+{
+std::unique_ptr<SharedDnsManager> sdm = nullptr;
+
+SharedDnsManager::SharedDnsManager()
+    : shared_dns_block(nullptr),
+      rwlock(nullptr),
+      meta_size(ROUNDUP(sizeof(pthread_rwlock_t), 1 << 3))
+{
+}
+
+SharedDnsManager::~SharedDnsManager()
+{
+  if (rwlock != nullptr)
+  {
+    delete rwlock;
+    rwlock = nullptr;
+  }
+}
+
+bool SharedDnsManager::startup()
+{
+  size_t total_size = meta_size + sizeof(SharedDnsBlock);
+  char *shm_block = BaseManager::sm.create(SHMEM_SEC_DNS_BLOCK, total_size);
+  if (shm_block)
+  {
+    memset(shm_block, 0, total_size);
+    rwlock = new ReadWriteLock((pthread_rwlock_t *)shm_block, LOCK_PROCESS);
+    char *shm_dns_block = shm_block + meta_size;
+    shared_dns_block = reinterpret_cast<SharedDnsBlock *>(shm_dns_block);
+    initialized = true;
+    return true;
+  }
+  return false;
+}
+
+bool SharedDnsManager::shutdown()
+{
+  if (initialized)
+  {
+    if (rwlock != nullptr)
+    {
+      delete rwlock;
+      rwlock = nullptr;
+    }
+    BaseManager::sm.destroy(SHMEM_SEC_DNS_BLOCK);
+    shared_dns_block = nullptr;
+    initialized = false;
+  }
+  return true;
+}
+
+bool SharedDnsManager::find(const std::string &host, DnsStatus &status, std::vector<std::string> &ips)
+{
+  if (rwlock != nullptr && rwlock->read_try_lock())
+  {
+    ReadUnLocker auto_unlocker(rwlock);
+    int cached_status = kDnsOk;
+    ulong hash = zend_inline_hash_func(host.c_str(), host.length());
+    if (shared_dns_block->find(hash, host, (long)time(nullptr), cached_status, ips))
+    {
+      status = static_cast<DnsStatus>(cached_status);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SharedDnsManager::store(const std::string &host, long ttl, DnsStatus status, const std::vector<std::string> &ips)
+{
+  if (rwlock != nullptr && rwlock->write_try_lock())
+  {
+    WriteUnLocker auto_unlocker(rwlock);
+    ulong hash = zend_inline_hash_func(host.c_str(), host.length());
+    return shared_dns_block->store(hash, host, (long)time(nullptr) + ttl, status, ips);
+  }
+  return false;
+}
+
+DnsStatus SharedDnsManager::resolve(const std::string &host, std::vector<std::string> &ips, long timeout_ms, long ttl)
+{
+  DnsStatus status = kDnsOk;
+  if (ttl > 0 && find(host, status, ips))
+  {
+    return status;
+  }
+  status = lookup_host(host, ips, timeout_ms);
+  //超时与临时错误不缓存，否则一次慢响应会让该域名在 NEGATIVE_TTL 内都无法解析
+  if (ttl > 0 && (status == kDnsOk || status == kDnsNotFound))
+  {
+    long entry_ttl = ttl;
+    if ((status != kDnsOk || ips.empty()) && ttl > NEGATIVE_TTL)
+    {
+      entry_ttl = NEGATIVE_TTL;
+    }
+    store(host, entry_ttl, status, ips);
+  }
+  return status;
+}
+
+long SharedDnsManager::get_hits()
+{
+  if (rwlock != nullptr && rwlock->read_lock())
+  {
+    ReadUnLocker auto_unlocker(rwlock);
+    return shared_dns_block->get_hits();
+  }
+  return 0;
+}
+
+long SharedDnsManager::get_misses()
+{
+  if (rwlock != nullptr && rwlock->read_lock())
+  {
+    ReadUnLocker auto_unlocker(rwlock);
+    return shared_dns_block->get_misses();
+  }
+  return 0;
+}
+
+} // namespace openrasp
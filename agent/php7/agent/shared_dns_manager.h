@@ -0,0 +1,59 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _OPENRASP_SHARED_DNS_MANAGER_H_
+#define _OPENRASP_SHARED_DNS_MANAGER_H_
+
+#include "openrasp.h"
+#include "base_manager.h"
+#include <memory>
+#include <vector>
+#include "utils/read_write_lock.h"
+#include "utils/net.h"
+#include "shared_dns_block.h"
+
+namespace openrasp
+{
+
+class SharedDnsManager : public BaseManager
+{
+public:
+  static const long NEGATIVE_TTL = 5;
+
+  SharedDnsManager();
+  virtual ~SharedDnsManager();
+  virtual bool startup();
+  virtual bool shutdown();
+
+  bool find(const std::string &host, DnsStatus &status, std::vector<std::string> &ips);
+  bool store(const std::string &host, long ttl, DnsStatus status, const std::vector<std::string> &ips);
+  DnsStatus resolve(const std::string &host, std::vector<std::string> &ips, long timeout_ms, long ttl);
+
+  long get_hits();
+  long get_misses();
+
+private:
+  int meta_size;
+  ReadWriteLock *rwlock;
+  SharedDnsBlock *shared_dns_block;
+};
+
+extern std::unique_ptr<SharedDnsManager> sdm;
+
+} // namespace openrasp
+
+#endif
@@ -183,6 +183,11 @@ if test "$PHP_OPENRASP" != "no"; then
     AC_DEFINE([HAVE_LINE_COVERAGE], [1], [Enable line coverage support])
   fi
 
+  AC_CHECK_LIB(anl, getaddrinfo_a, [
+    AC_DEFINE([HAVE_GETADDRINFO_A], [1], [Have getaddrinfo_a support])
+    OPENRASP_LIBS="-lanl $OPENRASP_LIBS"
+  ])
+
   EXTRA_LIBS="$OPENRASP_LIBS $EXTRA_LIBS"
   OPENRASP_SHARED_LIBADD="$OPENRASP_LIBS $OPENRASP_SHARED_LIBADD"
   PHP_SUBST(OPENRASP_SHARED_LIBADD)
@@ -533,6 +538,8 @@ int main() {
     hook/openrasp_putenv.cc \
     hook/openrasp_mongo.cc \
     openrasp_output_detect.cc \
+    openrasp_taint.cc \
+    openrasp_compile.cc \
     hook/openrasp_echo.cc \
     openrasp_conf_holder.cc \
     openrasp_config_block.cc \
@@ -555,17 +562,28 @@ int main() {
     utils/time.cc \
     utils/net.cc \
     utils/url.cc \
+    utils/url_matcher.cc \
+    utils/lru_key.cc \
+    utils/json_validator.cc \
     utils/json_reader.cc \
+    utils/config_image.cc \
     utils/yaml_reader.cc \
     utils/utf.cc \
+    utils/string_kernel.cc \
     utils/hostname.cc \
+    utils/path_analyzer.cc \
+    utils/content_prescan.cc \
+    utils/host_normalizer.cc \
+    utils/cidr_classifier.cc \
     model/url.cc \
     model/request.cc \
     model/parameter.cc \
-    model/zend_ref_item.cc \
+    model/risk_profile.cc \
+    model/input_index.cc \
     agent/base_manager.cc \
     agent/shared_log_manager.cc \
     agent/shared_config_manager.cc \
+    agent/shared_dns_manager.cc \
     agent/mm/shm_manager.cc \
     $LIBFSWATCH_SOURCE \
     $YAML_CPP_SOURCE \
@@ -45,7 +45,7 @@ CheckResult V8Detector::check()
     return check_result;
 }
 
-V8Detector::V8Detector(const openrasp::data::V8Material &v8_material, openrasp::LRU<std::string, bool> &lru, openrasp::Isolate *isolate, int timeout, bool canBlock)
+V8Detector::V8Detector(const openrasp::data::V8Material &v8_material, openrasp::LRU<openrasp::LruKey, bool> &lru, openrasp::Isolate *isolate, int timeout, bool canBlock)
     : v8_material(v8_material), lru(lru), isolate(isolate), timeout(timeout), canBlock(canBlock)
 {
 }
@@ -56,20 +56,25 @@ void V8Detector::run()
     {
         return;
     }
-    std::string lru_ley = v8_material.build_lru_key();
-    if (!lru_ley.empty() &&
-        lru.contains(lru_ley))
+    LruKey lru_key = v8_material.build_lru_key();
+    if (!lru_key.empty() &&
+        lru.contains(lru_key))
     {
+        lru_hit = true;
         return;
     }
     CheckResult cr = check();
+    alarmed = (kCache != cr);
     if (kNoCache == cr)
     {
         return;
     }
     else if (kCache == cr)
     {
-        lru.set(lru_ley, true);
+        if (!lru_key.empty())
+        {
+            lru.set(lru_key, true);
+        }
     }
     else if (kBlock == cr && canBlock)
     {
@@ -77,6 +82,16 @@ void V8Detector::run()
     }
 }
 
+bool V8Detector::is_lru_hit() const
+{
+    return lru_hit;
+}
+
+bool V8Detector::is_alarmed() const
+{
+    return alarmed;
+}
+
 } // namespace checker
 
 } // namespace openrasp
\ No newline at end of file
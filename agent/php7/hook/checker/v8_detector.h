@@ -29,17 +29,22 @@ class V8Detector : public Detector
 {
 protected:
     const openrasp::data::V8Material &v8_material;
-    openrasp::LRU<std::string, bool> &lru;
+    openrasp::LRU<openrasp::LruKey, bool> &lru;
     openrasp::Isolate *isolate = nullptr;
     int timeout = 100;
     bool canBlock = true;
+    bool lru_hit = false;
+    bool alarmed = false;
 
     virtual bool pretreat() const;
     virtual CheckResult check();
 
 public:
-    V8Detector(const openrasp::data::V8Material &v8_material, openrasp::LRU<std::string, bool> &lru, openrasp::Isolate *isolate, int timeout, bool canblock = true);
+    V8Detector(const openrasp::data::V8Material &v8_material, openrasp::LRU<openrasp::LruKey, bool> &lru, openrasp::Isolate *isolate, int timeout, bool canblock = true);
     virtual void run();
+    bool is_lru_hit() const;
+    //插件返回了结果（报警或拦截）
+    bool is_alarmed() const;
 };
 
 } // namespace checker
@@ -15,6 +15,7 @@
  */
 
 #include "command_object.h"
+#include "openrasp_taint.h"
 
 namespace openrasp
 {
@@ -34,9 +35,9 @@ bool CommandObject::is_valid() const
 }
 
 //v8
-std::string CommandObject::build_lru_key() const
+LruKey CommandObject::build_lru_key() const
 {
-    return "";
+    return LruKey();
 }
 OpenRASPCheckType CommandObject::get_v8_check_type() const
 {
@@ -47,6 +48,7 @@ void CommandObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Objec
     v8::HandleScope handle_scope(isolate);
     auto context = isolate->GetCurrentContext();
     params->Set(context, openrasp::NewV8String(isolate, "command"), openrasp::NewV8String(isolate, Z_STRVAL_P(command), Z_STRLEN_P(command))).IsJust();
+    openrasp_taint_fill_params(isolate, params, command);
 }
 
 //builtin
@@ -40,9 +40,11 @@ bool CopyObject::is_valid() const
 }
 
 //v8
-std::string CopyObject::build_lru_key() const
+LruKey CopyObject::build_lru_key() const
 {
-    return CheckTypeTransfer::instance().type_to_name(get_v8_check_type()) + source_realpath + target_realpath;
+    LruKey key(get_v8_check_type());
+    key.append(source_realpath).append('\n').append(target_realpath);
+    return key;
 }
 OpenRASPCheckType CopyObject::get_v8_check_type() const
 {
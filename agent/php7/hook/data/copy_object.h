@@ -39,7 +39,7 @@ public:
     virtual bool is_valid() const;
 
     //v8
-    virtual std::string build_lru_key() const;
+    virtual LruKey build_lru_key() const;
     virtual OpenRASPCheckType get_v8_check_type() const;
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const;
 };
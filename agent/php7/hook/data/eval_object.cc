@@ -21,9 +21,10 @@ namespace openrasp
 namespace data
 {
 
-EvalObject::EvalObject(zval *code, const std::string &function) : function(function)
+EvalObject::EvalObject(zval *code, const std::string &function, bool constant) : function(function)
 {
     this->code = code;
+    this->constant = constant;
 }
 
 bool EvalObject::is_valid() const
@@ -36,9 +37,15 @@ bool EvalObject::is_valid() const
 }
 
 //v8
-std::string EvalObject::build_lru_key() const
+LruKey EvalObject::build_lru_key() const
 {
-    return "";
+    if (!constant)
+    {
+        return LruKey();
+    }
+    LruKey key(get_v8_check_type());
+    key.append(function).append('\n').append(Z_STRVAL_P(code), Z_STRLEN_P(code));
+    return key;
 }
 OpenRASPCheckType EvalObject::get_v8_check_type() const
 {
@@ -15,6 +15,7 @@
  */
 
 #include "file_op_object.h"
+#include "utils/path_analyzer.h"
 
 namespace openrasp
 {
@@ -32,9 +33,11 @@ FileOpObject::FileOpObject(zval *file, PathOperation w_op, bool use_include_path
     }
 }
 
-std::string FileOpObject::build_lru_key() const
+LruKey FileOpObject::build_lru_key() const
 {
-    return CheckTypeTransfer::instance().type_to_name(get_v8_check_type()) + realpath;
+    LruKey key(get_v8_check_type());
+    key.append(realpath);
+    return key;
 }
 
 OpenRASPCheckType FileOpObject::get_v8_check_type() const
@@ -66,6 +69,12 @@ void FileOpObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object
     auto context = isolate->GetCurrentContext();
     params->Set(context, openrasp::NewV8String(isolate, "path"), openrasp::NewV8String(isolate, Z_STRVAL_P(file), Z_STRLEN_P(file))).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "realpath"), openrasp::NewV8String(isolate, realpath)).IsJust();
+    openrasp::PathAnalyzer analyzer(std::string(Z_STRVAL_P(file), Z_STRLEN_P(file)), realpath,
+                                    OPENRASP_G(request).get_document_root(), OPENRASP_CONFIG(security.sensitive_paths));
+    params->Set(context, openrasp::NewV8String(isolate, "traversal_depth"), v8::Integer::New(isolate, analyzer.get_traversal_depth())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "scheme"), openrasp::NewV8String(isolate, analyzer.get_scheme())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "outside_webroot"), v8::Boolean::New(isolate, analyzer.is_outside_webroot())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "sensitive"), v8::Boolean::New(isolate, analyzer.is_sensitive())).IsJust();
 }
 
 } // namespace data
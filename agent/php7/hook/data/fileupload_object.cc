@@ -36,9 +36,9 @@ FileuploadObject::FileuploadObject(const openrasp::request::Parameter &parameter
     }
 }
 
-std::string FileuploadObject::build_lru_key() const
+LruKey FileuploadObject::build_lru_key() const
 {
-    return "";
+    return LruKey();
 }
 
 OpenRASPCheckType FileuploadObject::get_v8_check_type() const
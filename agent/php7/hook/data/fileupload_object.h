@@ -38,7 +38,7 @@ private:
 
 public:
     FileuploadObject(const openrasp::request::Parameter &parameter, zval *path, zval *dest, const std::string &content);
-    virtual std::string build_lru_key() const;
+    virtual LruKey build_lru_key() const;
     virtual OpenRASPCheckType get_v8_check_type() const;
     virtual bool is_valid() const;
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const;
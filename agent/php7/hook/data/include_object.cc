@@ -15,18 +15,21 @@
  */
 
 #include "include_object.h"
+#include "openrasp_v8.h"
+#include "utils/path_analyzer.h"
 
 namespace openrasp
 {
 namespace data
 {
 
-IncludeObject::IncludeObject(zval *filename, const std::string &document_root, const std::string &function, bool plugin_filter, bool without_protocol)
+IncludeObject::IncludeObject(zval *filename, const std::string &document_root, const std::string &function, bool plugin_filter, bool without_protocol, bool constant)
     : document_root(document_root), function(function)
 {
     this->filename = filename;
     this->plugin_filter = plugin_filter;
     this->without_protocol = without_protocol;
+    this->constant = constant;
     if (nullptr != filename && Z_TYPE_P(filename) == IS_STRING && Z_STRLEN_P(filename) > 0)
     {
         if (plugin_filter)
@@ -41,11 +44,50 @@ IncludeObject::IncludeObject(zval *filename, const std::string &document_root, c
             }
         }
         realpath = openrasp_real_path(Z_STRVAL_P(filename), Z_STRLEN_P(filename), true, READING);
+        if (is_valid())
+        {
+            build_stat_lru_key();
+        }
     }
 }
-std::string IncludeObject::build_lru_key() const
+/**
+ * 检测结果只取决于路径本身、webroot 与插件，本地文件再加上 inode/mtime，文件被替换或修改后重新检测
+ * 带协议的路径只有在操作数为常量时才缓存
+ */
+void IncludeObject::build_stat_lru_key()
 {
-    return "";
+    if (without_protocol)
+    {
+        zend_stat_t sb;
+        if (VCWD_STAT(realpath.c_str(), &sb) != 0 || (sb.st_mode & S_IFREG) == 0)
+        {
+            return;
+        }
+        stat_inode = sb.st_ino;
+        stat_mtime = sb.st_mtime;
+    }
+    else if (!constant)
+    {
+        return;
+    }
+    plugin_version = process_globals.snapshot_blob ? process_globals.snapshot_blob->timestamp : 0;
+    cacheable = true;
+}
+LruKey IncludeObject::build_lru_key() const
+{
+    if (!cacheable)
+    {
+        return LruKey();
+    }
+    LruKey key(get_v8_check_type());
+    key.append(function).append('\n').append_number(plugin_version).append('\n');
+    if (without_protocol)
+    {
+        key.append_number(stat_inode).append(':').append_number(stat_mtime);
+    }
+    key.append('\n').append(document_root).append('\n');
+    key.append(Z_STRVAL_P(filename), Z_STRLEN_P(filename)).append('\n').append(realpath);
+    return key;
 }
 OpenRASPCheckType IncludeObject::get_v8_check_type() const
 {
@@ -74,6 +116,12 @@ void IncludeObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Objec
     params->Set(context, openrasp::NewV8String(isolate, "url"), openrasp::NewV8String(isolate, Z_STRVAL_P(filename), Z_STRLEN_P(filename))).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "realpath"), openrasp::NewV8String(isolate, realpath)).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "function"), openrasp::NewV8String(isolate, function)).IsJust();
+    openrasp::PathAnalyzer analyzer(std::string(Z_STRVAL_P(filename), Z_STRLEN_P(filename)), realpath,
+                                    document_root, OPENRASP_CONFIG(security.sensitive_paths));
+    params->Set(context, openrasp::NewV8String(isolate, "traversal_depth"), v8::Integer::New(isolate, analyzer.get_traversal_depth())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "scheme"), openrasp::NewV8String(isolate, analyzer.get_scheme())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "outside_webroot"), v8::Boolean::New(isolate, analyzer.is_outside_webroot())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "sensitive"), v8::Boolean::New(isolate, analyzer.is_sensitive())).IsJust();
 }
 
 } // namespace data
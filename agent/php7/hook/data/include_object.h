@@ -35,10 +35,17 @@ private:
     std::string param;
     bool plugin_filter = false;
     bool without_protocol = false;
+    bool constant = false;
+    bool cacheable = false;
+    uint64_t plugin_version = 0;
+    int64_t stat_inode = 0;
+    int64_t stat_mtime = 0;
+
+    void build_stat_lru_key();
 
 public:
-    IncludeObject(zval *filename, const std::string &document_root, const std::string &function, bool plugin_filter, bool without_protocol);
-    virtual std::string build_lru_key() const;
+    IncludeObject(zval *filename, const std::string &document_root, const std::string &function, bool plugin_filter, bool without_protocol, bool constant = false);
+    virtual LruKey build_lru_key() const;
     virtual OpenRASPCheckType get_v8_check_type() const;
     virtual bool is_valid() const;
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const;
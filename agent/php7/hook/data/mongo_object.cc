@@ -28,9 +28,11 @@ MongoObject::MongoObject(const std::string &server, const std::string &query, co
     this->classname = classname;
     this->method = method;
 }
-std::string MongoObject::build_lru_key() const
+LruKey MongoObject::build_lru_key() const
 {
-    return CheckTypeTransfer::instance().type_to_name(get_v8_check_type()) + classname + method + query;
+    LruKey key(get_v8_check_type());
+    key.append(classname).append('\n').append(method).append('\n').append(query);
+    return key;
 }
 OpenRASPCheckType MongoObject::get_v8_check_type() const
 {
@@ -35,7 +35,7 @@ private:
 
 public:
     MongoObject(const std::string &server, const std::string &query, const std::string &classname, const std::string &method);
-    virtual std::string build_lru_key() const;
+    virtual LruKey build_lru_key() const;
     virtual OpenRASPCheckType get_v8_check_type() const;
     virtual bool is_valid() const;
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const;
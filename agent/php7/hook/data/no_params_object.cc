@@ -25,9 +25,9 @@ NoParamsObject::NoParamsObject(const OpenRASPCheckType check_type)
 {
     this->check_type = check_type;
 }
-std::string NoParamsObject::build_lru_key() const
+LruKey NoParamsObject::build_lru_key() const
 {
-    return "";
+    return LruKey();
 }
 OpenRASPCheckType NoParamsObject::get_v8_check_type() const
 {
@@ -88,9 +88,11 @@ bool RenameObject::is_valid() const
 }
 
 //v8
-std::string RenameObject::build_lru_key() const
+LruKey RenameObject::build_lru_key() const
 {
-    return CheckTypeTransfer::instance().type_to_name(get_v8_check_type()) + source_realpath + target_realpath;
+    LruKey key(get_v8_check_type());
+    key.append(source_realpath).append('\n').append(target_realpath);
+    return key;
 }
 OpenRASPCheckType RenameObject::get_v8_check_type() const
 {
@@ -19,6 +19,8 @@
 #include "php_openrasp.h"
 #include "openrasp_v8.h"
 #include "v8_material.h"
+#include "utils/content_prescan.h"
+#include <vector>
 
 namespace openrasp
 {
@@ -31,9 +33,12 @@ private:
     const char *content;
     size_t content_length;
     const char *content_type;
+    //预扫描得到的片段，content 为各片段以换行拼接，offset 为片段在响应中的原始偏移
+    const std::vector<ContentWindow> *windows = nullptr;
 
 public:
-    ResponseObject(const char *content, size_t content_length, const char *content_type) : content(content), content_length(content_length), content_type(content_type) {}
+    ResponseObject(const char *content, size_t content_length, const char *content_type, const std::vector<ContentWindow> *windows = nullptr)
+        : content(content), content_length(content_length), content_type(content_type), windows(windows) {}
     virtual bool is_valid() const
     {
         if (strlen(content_type) > 0 &&
@@ -43,7 +48,7 @@ public:
         }
         return true;
     };
-    virtual std::string build_lru_key() const { return ""; };
+    virtual LruKey build_lru_key() const { return LruKey(); };
     virtual OpenRASPCheckType get_v8_check_type() const { return OpenRASPCheckType::RESPONSE; };
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const
     {
@@ -52,6 +57,18 @@ public:
         params->Set(context, openrasp_v8::NewV8String(isolate, "content"), openrasp_v8::NewV8String(isolate, content, content_length)).IsJust();
         params->Set(context, openrasp_v8::NewV8String(isolate, "content_type"), openrasp_v8::NewV8String(isolate, content_type)).IsJust();
         params->Set(context, openrasp_v8::NewV8String(isolate, "stack"), v8::Array::New(isolate)).IsJust();
+        if (nullptr != windows)
+        {
+            auto arr = v8::Array::New(isolate, windows->size());
+            for (size_t i = 0; i < windows->size(); ++i)
+            {
+                auto item = v8::Object::New(isolate);
+                item->Set(context, openrasp_v8::NewV8String(isolate, "offset"), v8::Number::New(isolate, (*windows)[i].offset)).IsJust();
+                item->Set(context, openrasp_v8::NewV8String(isolate, "length"), v8::Number::New(isolate, (*windows)[i].length)).IsJust();
+                arr->Set(context, i, item).IsJust();
+            }
+            params->Set(context, openrasp_v8::NewV8String(isolate, "content_windows"), arr).IsJust();
+        }
     };
 };
 
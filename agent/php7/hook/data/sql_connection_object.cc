@@ -38,29 +38,34 @@ bool SqlConnectionObject::is_valid() const
     return true;
 }
 
-std::string SqlConnectionObject::build_lru_key() const
+void SqlConnectionObject::append_connection_key(LruKey &key) const
 {
-    std::string result;
-    result.append(server).append("-");
+    key.append(server).append('-');
     if (!using_socket)
     {
         for (const std::string &host : hosts)
         {
-            result.append(host).append("-");
+            key.append(host).append('-');
         }
         for (const int port : ports)
         {
-            result.append(std::to_string(port)).append("-");
+            key.append_number(port).append('-');
         }
     }
     else
     {
         for (const std::string &socket : sockets)
         {
-            result.append(socket).append("-");
+            key.append(socket).append('-');
         }
     }
-    return result;
+}
+
+LruKey SqlConnectionObject::build_lru_key() const
+{
+    LruKey key(get_v8_check_type());
+    append_connection_key(key);
+    return key;
 }
 
 OpenRASPCheckType SqlConnectionObject::get_v8_check_type() const
@@ -41,7 +41,7 @@ public:
     virtual bool is_valid() const;
 
     //v8
-    virtual std::string build_lru_key() const;
+    virtual LruKey build_lru_key() const;
     virtual OpenRASPCheckType get_v8_check_type() const;
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const;
 
@@ -51,6 +51,9 @@ public:
     virtual ulong hash() const;
 
     //self
+    //server、host、port 或 socket 依次追加到 key，供缓存键与策略去重的哈希使用
+    void append_connection_key(LruKey &key) const;
+
     virtual void set_host(const std::string &host);
     virtual std::vector<std::string> get_host() const;
 
@@ -57,9 +57,9 @@ bool SqlErrorObject::is_valid() const
 }
 
 //v8
-std::string SqlErrorObject::build_lru_key() const
+LruKey SqlErrorObject::build_lru_key() const
 {
-    return "";
+    return LruKey();
 }
 
 OpenRASPCheckType SqlErrorObject::get_v8_check_type() const
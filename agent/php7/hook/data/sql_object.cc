@@ -15,6 +15,7 @@
  */
 
 #include "sql_object.h"
+#include "openrasp_taint.h"
 
 namespace openrasp
 {
@@ -39,9 +40,11 @@ OpenRASPCheckType SqlObject::get_v8_check_type() const
     return SQL;
 }
 
-std::string SqlObject::build_lru_key() const
+LruKey SqlObject::build_lru_key() const
 {
-    return CheckTypeTransfer::instance().type_to_name(get_v8_check_type()) + std::string(Z_STRVAL_P(query), Z_STRLEN_P(query));
+    LruKey key(get_v8_check_type());
+    key.append(Z_STRVAL_P(query), Z_STRLEN_P(query));
+    return key;
 }
 
 void SqlObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const
@@ -50,6 +53,7 @@ void SqlObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> p
     auto context = isolate->GetCurrentContext();
     params->Set(context, openrasp::NewV8String(isolate, "query"), openrasp::NewV8String(isolate, Z_STRVAL_P(query), Z_STRLEN_P(query))).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "server"), openrasp::NewV8String(isolate, server)).IsJust();
+    openrasp_taint_fill_params(isolate, params, query);
 }
 
 } // namespace data
@@ -65,7 +65,10 @@ bool SqlPasswordObject::policy_check(JsonReader &j) const
 
 ulong SqlPasswordObject::hash() const
 {
-    return std::hash<std::string>{}("password" + sql_connection_object.build_lru_key());
+    LruKey key = LruKey::stable();
+    key.append("password", 8);
+    sql_connection_object.append_connection_key(key);
+    return key.hash();
 }
 
 } // namespace data
@@ -86,7 +86,10 @@ bool SqlUsernameObject::policy_check(JsonReader &j) const
 
 ulong SqlUsernameObject::hash() const
 {
-    return std::hash<std::string>{}("username" + sql_connection_object.build_lru_key());
+    LruKey key = LruKey::stable();
+    key.append("username", 8);
+    sql_connection_object.append_connection_key(key);
+    return key.hash();
 }
 
 } // namespace data
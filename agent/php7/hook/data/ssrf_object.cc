@@ -16,6 +16,7 @@
 
 #include "ssrf_object.h"
 #include "utils/net.h"
+#include "utils/host_normalizer.h"
 
 namespace openrasp
 {
@@ -31,9 +32,11 @@ SsrfObject::SsrfObject(const std::string &function_name, zval *origin_url)
         url.parse(std::string(Z_STRVAL_P(origin_url), Z_STRLEN_P(origin_url)));
     }
 }
-std::string SsrfObject::build_lru_key() const
+LruKey SsrfObject::build_lru_key() const
 {
-    return CheckTypeTransfer::instance().type_to_name(get_v8_check_type()) + function_name + std::string(Z_STRVAL_P(origin_url), Z_STRLEN_P(origin_url));
+    LruKey key(get_v8_check_type());
+    key.append(function_name).append('\n').append(Z_STRVAL_P(origin_url), Z_STRLEN_P(origin_url));
+    return key;
 }
 
 OpenRASPCheckType SsrfObject::get_v8_check_type() const
@@ -58,13 +61,34 @@ void SsrfObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object>
     params->Set(context, openrasp::NewV8String(isolate, "function"), openrasp::NewV8String(isolate, function_name)).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "hostname"), openrasp::NewV8String(isolate, url.get_host())).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "port"), openrasp::NewV8String(isolate, url.get_port())).IsJust();
-    std::vector<std::string> ips = openrasp::lookup_host(url.get_host());
+    std::vector<std::string> ips;
+    openrasp::DnsStatus dns_status = openrasp_lookup_host(url.get_host(), ips);
+    params->Set(context, openrasp::NewV8String(isolate, "dns_timeout"), v8::Boolean::New(isolate, dns_status == openrasp::kDnsTimeout)).IsJust();
+    const openrasp::CidrClassifier &classifier = OPENRASP_CONFIG(ssrf.classifier);
+    bool internal = false;
     auto ip_arr = v8::Array::New(isolate);
+    auto ip_class_arr = v8::Array::New(isolate);
     for (int i = 0; i < ips.size(); ++i)
     {
+        openrasp::CidrClassifier::Category category = classifier.classify(ips[i]);
+        internal = internal || (category != openrasp::CidrClassifier::kNone);
         ip_arr->Set(context, i, openrasp::NewV8String(isolate, ips[i])).IsJust();
+        ip_class_arr->Set(context, i, openrasp::NewV8String(isolate, openrasp::CidrClassifier::category_name(category))).IsJust();
     }
     params->Set(context, openrasp::NewV8String(isolate, "ip"), ip_arr).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "ip_class"), ip_class_arr).IsJust();
+
+    openrasp::HostNormalizer normalizer(url);
+    openrasp::CidrClassifier::Category hostname_category = openrasp::CidrClassifier::kNone;
+    if (normalizer.is_ip())
+    {
+        hostname_category = classifier.classify(normalizer.get_host());
+        internal = internal || (hostname_category != openrasp::CidrClassifier::kNone);
+    }
+    params->Set(context, openrasp::NewV8String(isolate, "normalized_hostname"), openrasp::NewV8String(isolate, normalizer.get_host())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "hostname_obfuscated"), v8::Boolean::New(isolate, normalizer.is_obfuscated())).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "hostname_class"), openrasp::NewV8String(isolate, openrasp::CidrClassifier::category_name(hostname_category))).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "internal"), v8::Boolean::New(isolate, internal)).IsJust();
 }
 
 } // namespace data
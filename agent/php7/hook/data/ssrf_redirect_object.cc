@@ -23,8 +23,9 @@ namespace openrasp
 namespace data
 {
 
-SsrfRedirectObject::SsrfRedirectObject(zval *origin_url, zval *effective_url, const std::string &function, int curl_error, int http_status)
-    : function(function)
+SsrfRedirectObject::SsrfRedirectObject(zval *origin_url, zval *effective_url, const std::string &function, int curl_error, int http_status,
+                                       const std::string &primary_ip)
+    : function(function), primary_ip(primary_ip)
 {
     this->origin_url = origin_url;
     this->effective_url = effective_url;
@@ -39,9 +40,9 @@ SsrfRedirectObject::SsrfRedirectObject(zval *origin_url, zval *effective_url, co
         effective.parse(std::string(Z_STRVAL_P(effective_url), Z_STRLEN_P(effective_url)));
     }
 }
-std::string SsrfRedirectObject::build_lru_key() const
+LruKey SsrfRedirectObject::build_lru_key() const
 {
-    return "";
+    return LruKey();
 }
 OpenRASPCheckType SsrfRedirectObject::get_v8_check_type() const
 {
@@ -64,7 +65,8 @@ void SsrfRedirectObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::
     params->Set(context, openrasp::NewV8String(isolate, "url"), openrasp::NewV8String(isolate, Z_STRVAL_P(origin_url), Z_STRLEN_P(origin_url))).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "hostname"), openrasp::NewV8String(isolate, origin.get_host())).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "port"), openrasp::NewV8String(isolate, origin.get_port())).IsJust();
-    std::vector<std::string> origin_ips = openrasp::lookup_host(origin.get_host());
+    std::vector<std::string> origin_ips;
+    openrasp_lookup_host(origin.get_host(), origin_ips);
     auto ip_arr = v8::Array::New(isolate);
     for (int i = 0; i < origin_ips.size(); ++i)
     {
@@ -75,13 +77,15 @@ void SsrfRedirectObject::fill_object_2b_checked(Isolate *isolate, v8::Local<v8::
     params->Set(context, openrasp::NewV8String(isolate, "url2"), openrasp::NewV8String(isolate, Z_STRVAL_P(effective_url), Z_STRLEN_P(effective_url))).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "hostname2"), openrasp::NewV8String(isolate, effective.get_host())).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "port2"), openrasp::NewV8String(isolate, effective.get_port())).IsJust();
-    std::vector<std::string> effective_ips = openrasp::lookup_host(effective.get_host());
+    std::vector<std::string> effective_ips;
+    openrasp_lookup_host(effective.get_host(), effective_ips);
     auto ip2_arr = v8::Array::New(isolate);
     for (int i = 0; i < effective_ips.size(); ++i)
     {
         ip2_arr->Set(context, i, openrasp::NewV8String(isolate, effective_ips[i])).IsJust();
     }
     params->Set(context, openrasp::NewV8String(isolate, "ip2"), ip2_arr).IsJust();
+    params->Set(context, openrasp::NewV8String(isolate, "primary_ip"), openrasp::NewV8String(isolate, primary_ip)).IsJust();
 
     params->Set(context, openrasp::NewV8String(isolate, "http_status"), v8::Integer::New(isolate, curl_error == 0 ? http_status : 0)).IsJust();
     params->Set(context, openrasp::NewV8String(isolate, "http_message"), openrasp::NewV8String(isolate, curl_error != 0 ? std::string(curl_easy_strerror((CURLcode)curl_error)) : "OK")).IsJust();
@@ -36,10 +36,12 @@ private:
     const std::string function;
     int curl_error;
     int http_status;
+    const std::string primary_ip;
 
 public:
-    SsrfRedirectObject(zval *origin_url, zval *effective_url, const std::string &function, int curl_error, int http_status);
-    virtual std::string build_lru_key() const;
+    SsrfRedirectObject(zval *origin_url, zval *effective_url, const std::string &function, int curl_error, int http_status,
+                       const std::string &primary_ip = "");
+    virtual LruKey build_lru_key() const;
     virtual OpenRASPCheckType get_v8_check_type() const;
     virtual bool is_valid() const;
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const;
@@ -18,6 +18,7 @@
 
 #include "raw_material.h"
 #include "php/header.h"
+#include "utils/lru_key.h"
 
 namespace openrasp
 {
@@ -27,7 +28,8 @@ class V8Material : public RawMaterial
 {
 public:
     virtual bool is_valid() const = 0;
-    virtual std::string build_lru_key() const = 0;
+    //返回空键表示检测结果不缓存
+    virtual LruKey build_lru_key() const = 0;
     virtual OpenRASPCheckType get_v8_check_type() const = 0;
     virtual void fill_object_2b_checked(Isolate *isolate, v8::Local<v8::Object> params) const = 0;
 };
@@ -29,31 +29,24 @@ PRE_HOOK_FUNCTION(array_filter, CALLABLE);
 
 PRE_HOOK_FUNCTION_EX(__construct, reflectionfunction, CALLABLE);
 
-static void check_callable_function(zend_fcall_info fci, OpenRASPCheckType check_type)
+static void check_callable_function(zval *callable, OpenRASPCheckType check_type)
 {
-	if (!ZEND_FCI_INITIALIZED(fci))
+	if (nullptr == callable || !zend_is_callable(callable, 0, nullptr))
 	{
 		return;
 	}
-	zval function_name = fci.function_name;
-	openrasp::data::CallableObject callable_obj(&function_name, OPENRASP_HOOK_G(callable_blacklist));
+	openrasp::data::CallableObject callable_obj(callable, OPENRASP_HOOK_G(callable_blacklist));
 	openrasp::checker::BuiltinDetector builtin_detector(callable_obj);
 	builtin_detector.run();
 }
 
 void pre_global_array_filter_CALLABLE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-	if (ZEND_NUM_ARGS() > 1)
-	{
-		zval *array = nullptr;
-		zend_fcall_info fci = empty_fcall_info;
-		zend_fcall_info_cache fci_cache = empty_fcall_info_cache;
+	zval *array = nullptr;
 
-		if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "af", &array, &fci, &fci_cache) != SUCCESS)
-		{
-			return;
-		}
-		check_callable_function(fci, check_type);
+	if (hook_args.get_array(0, array))
+	{
+		check_callable_function(hook_args.get(1), check_type);
 	}
 }
 
@@ -64,38 +57,24 @@ void pre_global_array_walk_CALLABLE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_array_map_CALLABLE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-	zend_fcall_info fci = empty_fcall_info;
-	zend_fcall_info_cache fci_cache = empty_fcall_info_cache;
-
 	// ZEND_PARSE_PARAMETERS_START(2, -1)
 	// 	Z_PARAM_FUNC_EX(fci, fci_cache, 1, 0)
 	// 	Z_PARAM_VARIADIC('+', arrays, n_arrays)
 	// ZEND_PARSE_PARAMETERS_END();
 
-	if (zend_parse_parameters(MIN(1, ZEND_NUM_ARGS()), "f!", &fci, &fci_cache) != SUCCESS)
-	{
-		return;
-	}
-
-	check_callable_function(fci, check_type);
+	check_callable_function(hook_args.get(0), check_type);
 }
 
 void pre_reflectionfunction___construct_CALLABLE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-	zval *closure = nullptr;
-	zval *name_str = nullptr;
+	zval *name_str = hook_args.get(0);
 
-	if (zend_parse_parameters_ex(ZEND_PARSE_PARAMS_QUIET, ZEND_NUM_ARGS(), "o", &closure) == SUCCESS)
+	//传入 Closure 对象时无需检测，参数个数错误由原始函数抛出异常
+	if (hook_args.size() != 1 || Z_TYPE_P(name_str) == IS_OBJECT)
 	{
 		return;
 	}
-	else
-	{
-		if (zend_parse_parameters_throw(ZEND_NUM_ARGS(), "z", &name_str) == SUCCESS)
-		{
-			openrasp::data::CallableObject callable_obj(name_str, OPENRASP_HOOK_G(callable_blacklist));
-			openrasp::checker::BuiltinDetector builtin_detector(callable_obj);
-			builtin_detector.run();
-		}
-	}
+	openrasp::data::CallableObject callable_obj(name_str, OPENRASP_HOOK_G(callable_blacklist));
+	openrasp::checker::BuiltinDetector builtin_detector(callable_obj);
+	builtin_detector.run();
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "hook/checker/v8_detector.h"
 #include "hook/checker/builtin_detector.h"
 #include "openrasp_hook.h"
+#include "openrasp_compile.h"
 #include "agent/shared_config_manager.h"
 
 /**
@@ -41,10 +42,12 @@ PRE_HOOK_FUNCTION(pcntl_exec, WEBSHELL_COMMAND);
 
 static inline void openrasp_webshell_command_common(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *command = nullptr;
+    openrasp_clear_realpath_memo();
+    zval *command = hook_args.get(0);
 
-    if (zend_parse_parameters(MIN(1, ZEND_NUM_ARGS()), "z", &command) != SUCCESS ||
-        Z_TYPE_P(command) != IS_STRING)
+    if (nullptr == command ||
+        Z_TYPE_P(command) != IS_STRING ||
+        openrasp_constant_call_site(execute_data))
     {
         return;
     }
@@ -62,9 +65,10 @@ static inline void plugin_command_check(zval *command, OpenRASPCheckType check_t
 
 static inline void openrasp_command_common(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *command = nullptr;
+    openrasp_clear_realpath_memo();
+    zval *command = hook_args.get(0);
 
-    if (zend_parse_parameters(MIN(1, ZEND_NUM_ARGS()), "z", &command) != SUCCESS)
+    if (nullptr == command)
     {
         return;
     }
@@ -139,15 +143,16 @@ void pre_global_pcntl_exec_WEBSHELL_COMMAND(OPENRASP_INTERNAL_FUNCTION_PARAMETER
 
 void pre_global_pcntl_exec_COMMAND(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *command = nullptr;
+    zval *command = hook_args.get(0);
     zval *args = nullptr;
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "z|a", &command, &args) != SUCCESS)
+    if (nullptr == command ||
+        (hook_args.size() > 1 && !hook_args.get_array(1, args)))
     {
         return;
     }
 
-    if (ZEND_NUM_ARGS() > 1)
+    if (nullptr != args)
     {
         zend_string *delim = zend_string_init(" ", 1, 0);
         zval rst;
@@ -27,9 +27,9 @@ PRE_HOOK_FUNCTION(scandir, DIRECTORY);
 
 static inline void _hook_php_do_opendir(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-	zval *dirname;
+	zval *dirname = hook_args.get(0);
 
-	if (zend_parse_parameters(MIN(1, ZEND_NUM_ARGS()), "z", &dirname) != SUCCESS)
+	if (nullptr == dirname)
 	{
 		return;
 	}
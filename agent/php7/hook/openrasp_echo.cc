@@ -30,6 +30,10 @@ static zend_free_op should_free;
 
 int echo_print_handler(zend_execute_data *execute_data)
 {
+    if (openrasp_check_type_ignored(XSS_ECHO))
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
     const zend_op *opline = EX(opline);
 #if (PHP_MAJOR_VERSION == 7 && PHP_MINOR_VERSION < 3)
     zval *inc_filename = zend_get_zval_ptr(opline->op1_type, &opline->op1, execute_data, &should_free, BP_VAR_IS);
@@ -37,7 +41,6 @@ int echo_print_handler(zend_execute_data *execute_data)
     zval *inc_filename = zend_get_zval_ptr(opline, opline->op1_type, &opline->op1, execute_data, &should_free, BP_VAR_IS);
 #endif
     if (inc_filename != nullptr &&
-        !openrasp_check_type_ignored(XSS_ECHO) &&
         openrasp_zval_in_request(inc_filename))
     {
         std::string opname = (opline->extended_value == 0) ? "echo" : "print";
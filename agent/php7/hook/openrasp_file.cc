@@ -21,6 +21,7 @@
 #include "hook/checker/v8_detector.h"
 #include "hook/checker/builtin_detector.h"
 #include "openrasp_hook.h"
+#include "openrasp_compile.h"
 #include "openrasp_v8.h"
 #include "utils/string.h"
 #include "agent/shared_config_manager.h"
@@ -89,10 +90,10 @@ void check_file_operation(OpenRASPCheckType type, zval *file, bool use_include_p
 
 void pre_global_file_READ_FILE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *filename = nullptr;
-    zend_long flags;
+    zval *filename = hook_args.get(0);
+    zend_long flags = 0;
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "z|l", &filename, &flags) != SUCCESS)
+    if (nullptr == filename || !hook_args.optional_long(1, flags))
     {
         return;
     }
@@ -104,10 +105,10 @@ void pre_global_file_READ_FILE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_file_SSRF(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *filename = nullptr;
-    zend_long flags;
+    zval *filename = hook_args.get(0);
+    zend_long flags = 0;
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "z|l", &filename, &flags) != SUCCESS)
+    if (nullptr == filename || !hook_args.optional_long(1, flags))
     {
         return;
     }
@@ -119,10 +120,10 @@ void pre_global_file_SSRF(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_readfile_READ_FILE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *filename = nullptr;
-    zend_bool use_include_path;
+    zval *filename = hook_args.get(0);
+    zend_bool use_include_path = 0;
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "z|b", &filename, &use_include_path) != SUCCESS)
+    if (nullptr == filename || !hook_args.optional_bool(1, use_include_path))
     {
         return;
     }
@@ -134,10 +135,10 @@ void pre_global_readfile_READ_FILE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_readfile_SSRF(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *filename = nullptr;
-    zend_bool use_include_path;
+    zval *filename = hook_args.get(0);
+    zend_bool use_include_path = 0;
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "z|b", &filename, &use_include_path) != SUCCESS)
+    if (nullptr == filename || !hook_args.optional_bool(1, use_include_path))
     {
         return;
     }
@@ -159,11 +160,12 @@ void pre_global_file_get_contents_SSRF(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_file_put_contents_WEBSHELL_FILE_PUT_CONTENTS(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *filename = nullptr;
-    zval *data = nullptr;
-    zend_long flags;
+    zval *filename = hook_args.get(0);
+    zval *data = hook_args.get(1);
+    zend_long flags = 0;
 
-    if (zend_parse_parameters(MIN(3, ZEND_NUM_ARGS()), "zz|l", &filename, &data, &flags) != SUCCESS)
+    if (nullptr == data || !hook_args.optional_long(2, flags) ||
+        openrasp_constant_call_site(execute_data))
     {
         return;
     }
@@ -175,11 +177,11 @@ void pre_global_file_put_contents_WEBSHELL_FILE_PUT_CONTENTS(OPENRASP_INTERNAL_F
 
 void pre_global_file_put_contents_WRITE_FILE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *filename = nullptr;
-    zval *data = nullptr;
-    zend_long flags;
+    zval *filename = hook_args.get(0);
+    zval *data = hook_args.get(1);
+    zend_long flags = 0;
 
-    if (zend_parse_parameters(MIN(3, ZEND_NUM_ARGS()), "zz|l", &filename, &data, &flags) != SUCCESS)
+    if (nullptr == data || !hook_args.optional_long(2, flags))
     {
         return;
     }
@@ -241,10 +243,10 @@ void pre_splfileobject___construct_READ_WRITE_FILE_SSRF(INTERNAL_FUNCTION_PARAME
 
 void pre_global_copy_COPY(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *source = nullptr;
-    zval *dest = nullptr;
+    zval *source = hook_args.get(0);
+    zval *dest = hook_args.get(1);
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "zz", &source, &dest) != SUCCESS)
+    if (nullptr == dest)
     {
         return;
     }
@@ -255,10 +257,10 @@ void pre_global_copy_COPY(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_copy_SSRF(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *source = nullptr;
-    zval *dest = nullptr;
+    zval *source = hook_args.get(0);
+    zval *dest = hook_args.get(1);
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "zz", &source, &dest) != SUCCESS)
+    if (nullptr == dest)
     {
         return;
     }
@@ -270,10 +272,10 @@ void pre_global_copy_SSRF(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_rename_RENAME(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *source = nullptr;
-    zval *dest = nullptr;
+    zval *source = hook_args.get(0);
+    zval *dest = hook_args.get(1);
 
-    if (zend_parse_parameters(MIN(2, ZEND_NUM_ARGS()), "zz", &source, &dest) != SUCCESS)
+    if (nullptr == dest)
     {
         return;
     }
@@ -285,10 +287,11 @@ void pre_global_rename_RENAME(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_global_unlink_DELETE_FILE(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *filename = nullptr;
+    zval *filename = hook_args.get(0);
     zval *zcontext = NULL;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|r", &filename, &zcontext) == FAILURE)
+    if (nullptr == filename ||
+        (hook_args.size() > 1 && !hook_args.get_resource(1, zcontext)))
     {
         return;
     }
@@ -25,13 +25,13 @@ PRE_HOOK_FUNCTION(move_uploaded_file, FILE_UPLOAD);
 
 void pre_global_move_uploaded_file_FILE_UPLOAD(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *path = nullptr;
-    zval *new_path = nullptr;
+    zval *path = hook_args.get(0);
+    zval *new_path = hook_args.get(1);
     if (!SG(rfc1867_uploaded_files))
     {
         return;
     }
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "zz", &path, &new_path) == FAILURE)
+    if (nullptr == path || nullptr == new_path)
     {
         return;
     }
@@ -19,6 +19,7 @@
 #include "hook/checker/v8_detector.h"
 #include "hook/checker/builtin_detector.h"
 #include "openrasp_hook.h"
+#include "openrasp_compile.h"
 #include "agent/shared_config_manager.h"
 #include "utils/string.h"
 extern "C"
@@ -35,6 +36,14 @@ int include_or_eval_handler(zend_execute_data *execute_data);
 
 int include_or_eval_handler(zend_execute_data *execute_data)
 {
+    //opcache 持久化的 opline 已绑定用户 handler，不能在运行期注销，忽略时直接返回
+    if (openrasp_check_type_ignored(INCLUDE) &&
+        openrasp_check_type_ignored(SSRF) &&
+        openrasp_check_type_ignored(EVAL) &&
+        openrasp_check_type_ignored(WEBSHELL_EVAL))
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
     const zend_op *opline = EX(opline);
     zval tmp_inc_filename;
     zval *inc_filename = nullptr;
@@ -71,13 +80,14 @@ int include_or_eval_handler(zend_execute_data *execute_data)
 
 void eval_handler(zval *op1, zend_execute_data *execute_data)
 {
-    openrasp::data::EvalObject eval_obj(op1, "eval");
+    bool constant = openrasp_constant_include_site(execute_data);
+    openrasp::data::EvalObject eval_obj(op1, "eval", constant);
     if (!openrasp_check_type_ignored(EVAL))
     {
         openrasp::checker::V8Detector v8_detector(eval_obj, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis));
         v8_detector.run();
     }
-    if (!openrasp_check_type_ignored(WEBSHELL_EVAL))
+    if (!constant && !openrasp_check_type_ignored(WEBSHELL_EVAL))
     {
         openrasp::checker::BuiltinDetector builtin_detector(eval_obj);
         builtin_detector.run();
@@ -118,9 +128,18 @@ void include_handler(zval *op1, zend_execute_data *execute_data)
     {
         if (!openrasp_check_type_ignored(INCLUDE))
         {
-            openrasp::data::IncludeObject include_obj(op1, OPENRASP_G(request).get_document_root(), function, OPENRASP_CONFIG(plugin.filter), protocol.empty());
+            openrasp::data::IncludeObject include_obj(op1, OPENRASP_G(request).get_document_root(), function, OPENRASP_CONFIG(plugin.filter), protocol.empty(),
+                                                      openrasp_constant_include_site(execute_data));
             openrasp::checker::V8Detector v8_detector(include_obj, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis));
             v8_detector.run();
+            if (include_obj.is_valid() && !include_obj.build_lru_key().empty())
+            {
+                OPENRASP_HOOK_G(include_cache_lookups)++;
+                if (v8_detector.is_lru_hit())
+                {
+                    OPENRASP_HOOK_G(include_cache_hits)++;
+                }
+            }
         }
     }
 }
\ No newline at end of file
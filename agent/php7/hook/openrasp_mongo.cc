@@ -23,6 +23,11 @@
 #include "hook/data/mongo_connection_object.h"
 #include "hook/data/sql_password_object.h"
 
+extern "C"
+{
+#include "zend_interfaces.h"
+}
+
 /**
  * mongo相关hook点
  */
@@ -35,7 +40,7 @@ POST_HOOK_FUNCTION_EX(__construct, mongodb_0_driver_0_manager, DB_CONNECTION);
 
 static void handle_mongo_uri_string(char *uri_string, size_t uri_string_len, openrasp::data::SqlConnectionObject &sql_connection_obj,
                                     std::string const &default_uri = "mongodb://127.0.0.1/");
-static void mongo_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, init_sql_connection_t connection_init_func,
+static void mongo_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, init_sql_connection_t connection_init_func,
                                           openrasp::data::SqlConnectionObject &sql_connection_obj);
 
 void handle_mongo_uri_string(char *uri_string, size_t uri_string_len, openrasp::data::SqlConnectionObject &sql_connection_obj,
@@ -63,19 +68,20 @@ static void handle_mongo_options(HashTable *ht, openrasp::data::SqlConnectionObj
     }
 }
 
-static bool init_mongodb_connection_entry(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj)
+static bool init_mongodb_connection_entry(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
-    char *uri_string = NULL;
-    size_t uri_string_len = 0;
+    zend_string *uri_string = NULL;
     zval *options = NULL;
     zval *driverOptions = NULL;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "|s!a/!a/!", &uri_string, &uri_string_len, &options, &driverOptions) == FAILURE)
+    if (!hook_args.optional_string(0, uri_string, true) ||
+        !hook_args.optional_array(1, options) ||
+        !hook_args.optional_array(2, driverOptions))
     {
         return false;
     }
 
-    handle_mongo_uri_string(uri_string, uri_string_len, sql_connection_obj);
+    handle_mongo_uri_string(uri_string ? ZSTR_VAL(uri_string) : NULL, uri_string ? ZSTR_LEN(uri_string) : 0, sql_connection_obj);
     if (options && Z_TYPE_P(options) == IS_ARRAY)
     {
         handle_mongo_options(Z_ARRVAL_P(options), sql_connection_obj);
@@ -91,45 +97,395 @@ static void mongo_plugin_check(const std::string &query_str, const std::string &
     v8_detector.run();
 }
 
-//for mongodb extension
-static void mongodb_plugin_check(zval *query, const std::string &classname, const std::string &method)
+/**
+ * 将 filter/document 直接序列化为紧凑 JSON，避免调用 MongoDB\BSON\fromPHP/toJSON
+ * 超过 mongo.maxbytes 后不再追加普通成员，已打开的数组/对象仍会闭合以保证 JSON 合法
+ * $ 开头的操作符（以及值中含有操作符的成员）不受上限约束，避免通过填充前面的字段隐藏 $where 等操作符
+ */
+class MongoQueryEncoder
 {
-    std::string query_json;
-    if (Z_TYPE_P(query) == IS_ARRAY)
+public:
+    static const int max_depth = 32;
+
+private:
+    std::string buf;
+    size_t limit;
+    bool truncated = false;
+    //大于 0 时正在编码操作符，忽略上限
+    int forced = 0;
+
+public:
+    explicit MongoQueryEncoder(size_t limit) : limit(limit) {}
+
+    const std::string &encode(zval *value)
     {
-        query_json = json_encode_from_zval(query);
+        append_value(value, 0);
+        return buf;
+    }
+
+private:
+    bool is_full()
+    {
+        if (forced > 0)
+        {
+            return false;
+        }
+        if (limit > 0 && buf.size() >= limit)
+        {
+            truncated = true;
+        }
+        return truncated;
+    }
+
+    void append_string(const char *str, size_t len)
+    {
+        if (forced == 0 && limit > 0 && buf.size() + len + 2 > limit)
+        {
+            len = buf.size() + 2 < limit ? limit - buf.size() - 2 : 0;
+            truncated = true;
+        }
+        buf.push_back('"');
+        for (size_t i = 0; i < len; ++i)
+        {
+            unsigned char c = str[i];
+            switch (c)
+            {
+            case '"':
+                buf.append("\\\"");
+                break;
+            case '\\':
+                buf.append("\\\\");
+                break;
+            case '\b':
+                buf.append("\\b");
+                break;
+            case '\f':
+                buf.append("\\f");
+                break;
+            case '\n':
+                buf.append("\\n");
+                break;
+            case '\r':
+                buf.append("\\r");
+                break;
+            case '\t':
+                buf.append("\\t");
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    char hex[8];
+                    snprintf(hex, sizeof(hex), "\\u%04x", c);
+                    buf.append(hex);
+                }
+                else
+                {
+                    buf.push_back(c);
+                }
+            }
+        }
+        buf.push_back('"');
+    }
+
+    void append_key(zend_string *key, zend_ulong idx)
+    {
+        if (key)
+        {
+            append_string(ZSTR_VAL(key), ZSTR_LEN(key));
+        }
+        else
+        {
+            buf.push_back('"');
+            buf.append(std::to_string(idx));
+            buf.push_back('"');
+        }
+        buf.push_back(':');
     }
-    else if (Z_TYPE_P(query) == IS_OBJECT)
+
+    void append_hash(HashTable *ht, bool as_list, int depth)
     {
-        zval fromphp, serialized_bson;
-        ZVAL_STRING(&fromphp, "mongodb\\bson\\fromphp");
-        if (call_user_function(EG(function_table), nullptr, &fromphp, &serialized_bson, 1, query) == SUCCESS)
+        buf.push_back(as_list ? '[' : '{');
+        bool first = true;
+        zend_string *key;
+        zend_ulong idx;
+        zval *value;
+        ZEND_HASH_FOREACH_KEY_VAL_IND(ht, idx, key, value)
         {
-            if (Z_TYPE(serialized_bson) == IS_STRING)
+            if (!as_list && key && ZSTR_LEN(key) > 0 && ZSTR_VAL(key)[0] == '\0')
+            {
+                //non-public property
+                continue;
+            }
+            bool force = false;
+            if (is_full())
             {
-                zval tojson, serialized_json;
-                ZVAL_STRING(&tojson, "mongodb\\bson\\tojson");
-                if (call_user_function(EG(function_table), nullptr, &tojson, &serialized_json, 1, &serialized_bson) == SUCCESS)
+                if (!(!as_list && is_operator(key)) && !has_operator(value, depth + 1))
                 {
-                    if (Z_TYPE(serialized_json) == IS_STRING)
-                    {
-                        query_json = std::string(Z_STRVAL(serialized_json));
-                    }
-                    zval_ptr_dtor(&serialized_json);
+                    continue;
                 }
-                zval_ptr_dtor(&tojson);
+                force = true;
+            }
+            if (!first)
+            {
+                buf.push_back(',');
+            }
+            first = false;
+            forced += force ? 1 : 0;
+            if (!as_list)
+            {
+                append_key(key, idx);
+            }
+            append_value(value, depth + 1);
+            forced -= force ? 1 : 0;
+        }
+        ZEND_HASH_FOREACH_END();
+        buf.push_back(as_list ? ']' : '}');
+    }
+
+    void append_prop(HashTable *props, const char *name, const char *json_key)
+    {
+        zval *value = zend_hash_str_find(props, name, strlen(name));
+        buf.push_back('"');
+        buf.append(json_key);
+        buf.append("\":");
+        if (value)
+        {
+            append_value(value, max_depth - 1);
+        }
+        else
+        {
+            buf.append("null");
+        }
+    }
+
+    bool append_bson_type(zval *value, const char *classname)
+    {
+        static const char prefix[] = "mongodb\\bson\\";
+        if (strncasecmp(classname, prefix, sizeof(prefix) - 1) != 0)
+        {
+            return false;
+        }
+        const char *type = classname + sizeof(prefix) - 1;
+        HashTable *props = Z_OBJPROP_P(value);
+        if (!props)
+        {
+            return false;
+        }
+        buf.push_back('{');
+        if (strcasecmp(type, "objectid") == 0)
+        {
+            append_prop(props, "oid", "$oid");
+        }
+        else if (strcasecmp(type, "regex") == 0)
+        {
+            append_prop(props, "pattern", "$regex");
+            buf.push_back(',');
+            append_prop(props, "flags", "$options");
+        }
+        else if (strcasecmp(type, "javascript") == 0)
+        {
+            append_prop(props, "code", "$code");
+            if (zend_hash_str_exists(props, ZEND_STRL("scope")))
+            {
+                buf.push_back(',');
+                append_prop(props, "scope", "$scope");
+            }
+        }
+        else if (strcasecmp(type, "utcdatetime") == 0)
+        {
+            append_prop(props, "milliseconds", "$date");
+        }
+        else if (strcasecmp(type, "decimal128") == 0)
+        {
+            append_prop(props, "dec", "$numberDecimal");
+        }
+        else if (strcasecmp(type, "binary") == 0)
+        {
+            append_prop(props, "type", "$type");
+        }
+        else if (strcasecmp(type, "timestamp") == 0)
+        {
+            append_prop(props, "timestamp", "$timestamp");
+            buf.push_back(',');
+            append_prop(props, "increment", "$increment");
+        }
+        else if (strcasecmp(type, "minkey") == 0)
+        {
+            buf.append("\"$minKey\":1");
+        }
+        else if (strcasecmp(type, "maxkey") == 0)
+        {
+            buf.append("\"$maxKey\":1");
+        }
+        else
+        {
+            buf.pop_back();
+            return false;
+        }
+        buf.push_back('}');
+        return true;
+    }
+
+    void append_object(zval *value, int depth)
+    {
+        zend_class_entry *ce = Z_OBJCE_P(value);
+        if (append_bson_type(value, ZSTR_VAL(ce->name)))
+        {
+            return;
+        }
+        zend_class_entry *serializable_ce = static_cast<zend_class_entry *>(
+            zend_hash_str_find_ptr(CG(class_table), ZEND_STRL("mongodb\\bson\\serializable")));
+        if (serializable_ce && instanceof_function(ce, serializable_ce))
+        {
+            zval retval;
+            ZVAL_UNDEF(&retval);
+            zend_call_method_with_0_params(value, ce, nullptr, "bsonserialize", &retval);
+            if (Z_TYPE(retval) == IS_ARRAY)
+            {
+                append_hash(Z_ARRVAL(retval), false, depth);
+            }
+            else if (Z_TYPE(retval) == IS_OBJECT)
+            {
+                HashTable *props = Z_OBJPROP(retval);
+                append_hash(props, false, depth);
+            }
+            else
+            {
+                buf.append("{}");
+            }
+            zval_ptr_dtor(&retval);
+            return;
+        }
+        HashTable *props = Z_OBJPROP_P(value);
+        if (props)
+        {
+            append_hash(props, false, depth);
+        }
+        else
+        {
+            buf.append("{}");
+        }
+    }
+
+    void append_value(zval *value, int depth)
+    {
+        ZVAL_DEREF(value);
+        if (depth >= max_depth)
+        {
+            truncated = true;
+            buf.append("null");
+            return;
+        }
+        switch (Z_TYPE_P(value))
+        {
+        case IS_TRUE:
+            buf.append("true");
+            break;
+        case IS_FALSE:
+            buf.append("false");
+            break;
+        case IS_LONG:
+            buf.append(std::to_string(Z_LVAL_P(value)));
+            break;
+        case IS_DOUBLE:
+            if (zend_finite(Z_DVAL_P(value)))
+            {
+                char num[64];
+                snprintf(num, sizeof(num), "%.17g", Z_DVAL_P(value));
+                buf.append(num);
+            }
+            else
+            {
+                buf.append("null");
             }
-            zval_ptr_dtor(&serialized_bson);
+            break;
+        case IS_STRING:
+            append_string(Z_STRVAL_P(value), Z_STRLEN_P(value));
+            break;
+        case IS_ARRAY:
+            append_hash(Z_ARRVAL_P(value), is_list(Z_ARRVAL_P(value)), depth);
+            break;
+        case IS_OBJECT:
+            append_object(value, depth);
+            break;
+        default:
+            buf.append("null");
+            break;
         }
-        zval_ptr_dtor(&fromphp);
     }
-    mongo_plugin_check(query_json, classname, method);
+
+    static bool is_operator(zend_string *key)
+    {
+        return key && ZSTR_LEN(key) > 0 && ZSTR_VAL(key)[0] == '$';
+    }
+
+    //BSON 类型会输出为 $oid/$regex 等扩展 JSON，同样视为操作符
+    static bool has_operator(zval *value, int depth)
+    {
+        ZVAL_DEREF(value);
+        if (depth >= max_depth)
+        {
+            return false;
+        }
+        HashTable *ht = nullptr;
+        if (Z_TYPE_P(value) == IS_ARRAY)
+        {
+            ht = Z_ARRVAL_P(value);
+        }
+        else if (Z_TYPE_P(value) == IS_OBJECT)
+        {
+            static const char prefix[] = "mongodb\\bson\\";
+            if (strncasecmp(ZSTR_VAL(Z_OBJCE_P(value)->name), prefix, sizeof(prefix) - 1) == 0)
+            {
+                return true;
+            }
+            ht = Z_OBJPROP_P(value);
+        }
+        if (nullptr == ht)
+        {
+            return false;
+        }
+        zend_string *key;
+        zval *item;
+        ZEND_HASH_FOREACH_STR_KEY_VAL_IND(ht, key, item)
+        {
+            if (is_operator(key) || has_operator(item, depth + 1))
+            {
+                return true;
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+        return false;
+    }
+
+    static bool is_list(HashTable *ht)
+    {
+        zend_ulong expected = 0;
+        zend_string *key;
+        zend_ulong idx;
+        ZEND_HASH_FOREACH_KEY(ht, idx, key)
+        {
+            if (key || idx != expected++)
+            {
+                return false;
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+        return true;
+    }
+};
+
+//for mongodb extension
+static void mongodb_plugin_check(zval *query, const std::string &classname, const std::string &method)
+{
+    MongoQueryEncoder encoder(OPENRASP_CONFIG(mongo.maxbytes));
+    mongo_plugin_check(encoder.encode(query), classname, method);
 }
 
 void pre_mongodb_0_driver_0_bulkwrite_delete_MONGO(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     zval *zquery, *zoptions = NULL;
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "A|a!", &zquery, &zoptions) == FAILURE)
+    if (!hook_args.get_array(0, zquery, true) || !hook_args.optional_array(1, zoptions))
     {
         return;
     }
@@ -140,7 +496,7 @@ void pre_mongodb_0_driver_0_bulkwrite_update_MONGO(OPENRASP_INTERNAL_FUNCTION_PA
 {
     zval *zquery, *zupdate, *zoptions = NULL;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "AA|a!", &zquery, &zupdate, &zoptions) == FAILURE)
+    if (!hook_args.get_array(0, zquery, true) || !hook_args.get_array(1, zupdate, true) || !hook_args.optional_array(2, zoptions))
     {
         return;
     }
@@ -153,7 +509,7 @@ void pre_mongodb_0_driver_0_query___construct_MONGO(OPENRASP_INTERNAL_FUNCTION_P
     zval *filter;
     zval *options = NULL;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "A|a!", &filter, &options) == FAILURE)
+    if (!hook_args.get_array(0, filter, true) || !hook_args.optional_array(1, options))
     {
         return;
     }
@@ -165,7 +521,7 @@ void pre_mongodb_0_driver_0_command___construct_MONGO(OPENRASP_INTERNAL_FUNCTION
     zval *document;
     zval *options = NULL;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "A|a!", &document, &options) == FAILURE)
+    if (!hook_args.get_array(0, document, true) || !hook_args.optional_array(1, options))
     {
         return;
     }
@@ -178,15 +534,15 @@ void post_mongodb_0_driver_0_manager___construct_DB_CONNECTION(OPENRASP_INTERNAL
     if (Z_TYPE_P(getThis()) == IS_OBJECT && !EG(exception))
     {
         openrasp::data::MongoConnectionObject mongo_connection_obj;
-        mongo_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, init_mongodb_connection_entry, mongo_connection_obj);
+        mongo_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, init_mongodb_connection_entry, mongo_connection_obj);
     }
 }
 
-void mongo_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, init_sql_connection_t connection_init_func, openrasp::data::SqlConnectionObject &sql_connection_obj)
+void mongo_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, init_sql_connection_t connection_init_func, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
     if (connection_init_func)
     {
-        if (connection_init_func(INTERNAL_FUNCTION_PARAM_PASSTHRU, sql_connection_obj))
+        if (connection_init_func(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sql_connection_obj))
         {
             openrasp::data::SqlPasswordObject spo(sql_connection_obj);
             openrasp::checker::PolicyDetector weak_passwd_detector(spo);
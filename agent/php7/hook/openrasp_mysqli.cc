@@ -50,13 +50,22 @@ POST_HOOK_FUNCTION_EX(prepare, mysqli, SQL_ERROR);
 static long fetch_mysqli_errno(const char *function_name, uint32_t param_count, zval params[]);
 static std::string fetch_mysqli_error(const char *function_name, uint32_t param_count, zval params[]);
 
-static bool mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj,
+//mysqli_query 等过程式函数的第一个参数为 mysqli 对象
+static bool fetch_link_and_query(const HookArgs &hook_args, zval *&mysql_link, zval *&query)
+{
+    mysql_link = hook_args.get(0);
+    query = hook_args.get(1);
+    return nullptr != query && Z_TYPE_P(mysql_link) == IS_OBJECT;
+}
+
+static bool mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj,
                                           zend_bool is_real_connect, zend_bool in_ctor)
 {
-    char *hostname = nullptr, *username = nullptr, *passwd = nullptr, *dbname = nullptr, *socket = nullptr;
-    size_t hostname_len = 0, username_len = 0, passwd_len = 0, dbname_len = 0, socket_len = 0;
+    char *hostname = nullptr, *username = nullptr, *passwd = nullptr, *socket = nullptr;
+    size_t hostname_len = 0, socket_len = 0;
+    zend_string *hostname_str = nullptr, *username_str = nullptr, *passwd_str = nullptr, *dbname_str = nullptr, *socket_str = nullptr;
     zend_long port = 0, flags = 0;
-    zval *object = getThis();
+    uint32_t offset = 0;
     static char *default_host = INI_STR("mysqli.default_host");
     static char *default_user = INI_STR("mysqli.default_user");
     static char *default_password = INI_STR("mysqli.default_pw");
@@ -68,37 +77,43 @@ static bool mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAMETERS, openrasp
         default_port = MYSQL_PORT;
     }
 
-    if (!is_real_connect)
+    //mysqli_real_connect 的第一个参数为 mysqli 对象
+    if (is_real_connect && !in_ctor)
     {
-        if (zend_parse_parameters(ZEND_NUM_ARGS(), "|ssssls", &hostname, &hostname_len, &username,
-                                  &username_len, &passwd, &passwd_len, &dbname, &dbname_len, &port,
-                                  &socket, &socket_len) == FAILURE)
+        zval *object = hook_args.get(0);
+        if (nullptr == object || Z_TYPE_P(object) != IS_OBJECT)
         {
             return false;
         }
+        offset = 1;
     }
-    else
+    if (!hook_args.optional_string(offset, hostname_str) ||
+        !hook_args.optional_string(offset + 1, username_str) ||
+        !hook_args.optional_string(offset + 2, passwd_str) ||
+        !hook_args.optional_string(offset + 3, dbname_str) ||
+        !hook_args.optional_long(offset + 4, port) ||
+        !hook_args.optional_string(offset + 5, socket_str) ||
+        (is_real_connect && !hook_args.optional_long(offset + 6, flags)))
     {
-        if (in_ctor)
-        {
-            if (zend_parse_parameters(ZEND_NUM_ARGS(), "|sssslsl", &hostname,
-                                      &hostname_len, &username, &username_len, &passwd, &passwd_len,
-                                      &dbname, &dbname_len, &port, &socket,
-                                      &socket_len, &flags) == FAILURE)
-            {
-                return false;
-            }
-        }
-        else
-        {
-            if (zend_parse_method_parameters(ZEND_NUM_ARGS(), getThis(), "o|sssslsl", &object, &hostname,
-                                             &hostname_len, &username, &username_len, &passwd, &passwd_len,
-                                             &dbname, &dbname_len, &port, &socket,
-                                             &socket_len, &flags) == FAILURE)
-            {
-                return false;
-            }
-        }
+        return false;
+    }
+    if (hostname_str)
+    {
+        hostname = ZSTR_VAL(hostname_str);
+        hostname_len = ZSTR_LEN(hostname_str);
+    }
+    if (username_str)
+    {
+        username = ZSTR_VAL(username_str);
+    }
+    if (passwd_str)
+    {
+        passwd = ZSTR_VAL(passwd_str);
+    }
+    if (socket_str)
+    {
+        socket = ZSTR_VAL(socket_str);
+        socket_len = ZSTR_LEN(socket_str);
     }
     if (!username)
     {
@@ -130,32 +145,32 @@ static bool mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAMETERS, openrasp
     return true;
 }
 
-static bool global_mysqli_connect_conn_init(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj)
+static bool global_mysqli_connect_conn_init(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
-    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, sql_connection_obj, 0, 0);
+    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sql_connection_obj, 0, 0);
 }
 
-static bool global_mysqli_real_connect_conn_init(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj)
+static bool global_mysqli_real_connect_conn_init(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
-    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, sql_connection_obj, 1, 0);
+    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sql_connection_obj, 1, 0);
 }
 
-static bool mysqli__construct_conn_init(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj)
+static bool mysqli__construct_conn_init(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
-    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, sql_connection_obj, 0, 1);
+    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sql_connection_obj, 0, 1);
 }
 
-static bool mysqli_real_connect_conn_init(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj)
+static bool mysqli_real_connect_conn_init(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
-    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, sql_connection_obj, 1, 1);
+    return mysqli_init_sql_username_data(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sql_connection_obj, 1, 1);
 }
 
-static void mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAMETERS, init_sql_connection_t connection_init_func)
+static void mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, init_sql_connection_t connection_init_func)
 {
     long error_code = fetch_mysqli_errno("mysqli_connect_errno", 0, nullptr);
     std::string error_msg = fetch_mysqli_error("mysqli_connect_error", 0, nullptr);
     openrasp::data::SqlConnectionObject sco;
-    connection_init_func(INTERNAL_FUNCTION_PARAM_PASSTHRU, sco);
+    connection_init_func(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sco);
     openrasp::data::SqlErrorObject seo(sco, "mysql", error_code, error_msg);
     openrasp::checker::V8Detector error_checker(seo, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis));
     error_checker.run();
@@ -167,7 +182,7 @@ void post_mysqli___construct_DB_CONNECTION(OPENRASP_INTERNAL_FUNCTION_PARAMETERS
     if (Z_TYPE_P(getThis()) == IS_OBJECT && 0 == fetch_mysqli_errno("mysqli_connect_errno", 0, nullptr))
     {
         openrasp::data::SqlConnectionObject sco;
-        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, mysqli__construct_conn_init, sco);
+        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, mysqli__construct_conn_init, sco);
     }
 }
 
@@ -176,7 +191,7 @@ void post_mysqli___construct_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     if (Z_TYPE_P(getThis()) == IS_OBJECT)
     {
-        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, mysqli__construct_conn_init);
+        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, mysqli__construct_conn_init);
     }
 }
 
@@ -187,7 +202,7 @@ void post_mysqli_real_connect_DB_CONNECTION(OPENRASP_INTERNAL_FUNCTION_PARAMETER
     if (Z_TYPE_P(return_value) == IS_TRUE)
     {
         openrasp::data::SqlConnectionObject sco;
-        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, mysqli_real_connect_conn_init, sco);
+        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, mysqli_real_connect_conn_init, sco);
     }
 }
 
@@ -196,16 +211,16 @@ void post_mysqli_real_connect_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     if (Z_TYPE_P(return_value) == IS_FALSE)
     {
-        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, mysqli_real_connect_conn_init);
+        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, mysqli_real_connect_conn_init);
     }
 }
 
 //mysqli::query
 void pre_mysqli_query_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *query = nullptr;
-    long resultmode = MYSQLI_STORE_RESULT;
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|l", &query, &resultmode) == FAILURE)
+    zval *query = hook_args.get(0);
+    zend_long resultmode = MYSQLI_STORE_RESULT;
+    if (nullptr == query || !hook_args.optional_long(1, resultmode))
     {
         return;
     }
@@ -216,9 +231,9 @@ void post_mysqli_query_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     if (Z_TYPE_P(return_value) == IS_FALSE)
     {
-        zval *query = nullptr;
-        long resultmode = MYSQLI_STORE_RESULT;
-        if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|l", &query, &resultmode) == FAILURE)
+        zval *query = hook_args.get(0);
+        zend_long resultmode = MYSQLI_STORE_RESULT;
+        if (nullptr == query || !hook_args.optional_long(1, resultmode))
         {
             return;
         }
@@ -237,7 +252,7 @@ void post_global_mysqli_connect_DB_CONNECTION(OPENRASP_INTERNAL_FUNCTION_PARAMET
     if (Z_TYPE_P(return_value) == IS_OBJECT)
     {
         openrasp::data::SqlConnectionObject sco;
-        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, global_mysqli_connect_conn_init, sco);
+        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, global_mysqli_connect_conn_init, sco);
     }
 }
 
@@ -246,7 +261,7 @@ void post_global_mysqli_connect_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     if (Z_TYPE_P(return_value) == IS_FALSE)
     {
-        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, global_mysqli_connect_conn_init);
+        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, global_mysqli_connect_conn_init);
     }
 }
 
@@ -256,7 +271,7 @@ void post_global_mysqli_real_connect_DB_CONNECTION(OPENRASP_INTERNAL_FUNCTION_PA
     if (Z_TYPE_P(return_value) == IS_TRUE)
     {
         openrasp::data::SqlConnectionObject sco;
-        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, global_mysqli_real_connect_conn_init, sco);
+        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, global_mysqli_real_connect_conn_init, sco);
     }
 }
 
@@ -265,7 +280,7 @@ void post_global_mysqli_real_connect_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAME
 {
     if (Z_TYPE_P(return_value) == IS_FALSE)
     {
-        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, global_mysqli_real_connect_conn_init);
+        mysqli_connect_error_intercept(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, global_mysqli_real_connect_conn_init);
     }
 }
 
@@ -274,9 +289,9 @@ void pre_global_mysqli_query_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     zval *mysql_link = nullptr;
     zval *query = nullptr;
-    long resultmode = MYSQLI_STORE_RESULT;
+    zend_long resultmode = MYSQLI_STORE_RESULT;
 
-    if (zend_parse_method_parameters(ZEND_NUM_ARGS(), getThis(), "oz|l", &mysql_link, &query, &resultmode) == FAILURE)
+    if (!fetch_link_and_query(hook_args, mysql_link, query) || !hook_args.optional_long(2, resultmode))
     {
         return;
     }
@@ -289,9 +304,9 @@ void post_global_mysqli_query_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     {
         zval *mysql_link = nullptr;
         zval *query = nullptr;
-        long resultmode = MYSQLI_STORE_RESULT;
+        zend_long resultmode = MYSQLI_STORE_RESULT;
 
-        if (zend_parse_method_parameters(ZEND_NUM_ARGS(), getThis(), "oz|l", &mysql_link, &query, &resultmode) == FAILURE)
+        if (!fetch_link_and_query(hook_args, mysql_link, query) || !hook_args.optional_long(2, resultmode))
         {
             return;
         }
@@ -309,7 +324,7 @@ void pre_global_mysqli_real_query_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     zval *mysql_link = nullptr;
     zval *query = nullptr;
 
-    if (zend_parse_method_parameters(ZEND_NUM_ARGS(), getThis(), "oz", &mysql_link, &query) == FAILURE)
+    if (!fetch_link_and_query(hook_args, mysql_link, query))
     {
         return;
     }
@@ -326,7 +341,7 @@ void pre_global_mysqli_prepare_SQL_PREPARED(OPENRASP_INTERNAL_FUNCTION_PARAMETER
     zval *query = nullptr;
     zval *mysql_link = nullptr;
 
-    if (zend_parse_method_parameters(ZEND_NUM_ARGS(), getThis(), "oz", &mysql_link, &query) == FAILURE)
+    if (!fetch_link_and_query(hook_args, mysql_link, query))
     {
         return;
     }
@@ -341,9 +356,9 @@ void post_global_mysqli_prepare_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 
 void pre_mysqli_prepare_SQL_PREPARED(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *query = nullptr;
+    zval *query = hook_args.get(0);
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z", &query) == FAILURE)
+    if (nullptr == query)
     {
         return;
     }
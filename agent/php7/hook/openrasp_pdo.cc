@@ -65,22 +65,24 @@ static char *dsn_from_uri(char *uri, char *buf, size_t buflen)
     return dsn;
 }
 
-static bool init_pdo_connection_entry(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj)
+static bool init_pdo_connection_entry(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
-    char *data_source = nullptr;
-    size_t data_source_len = 0;
+    zend_string *data_source_str = nullptr;
+    zend_string *username_str = nullptr, *password_str = nullptr;
     char *colon = nullptr;
-    char *username = nullptr, *password = nullptr;
-    size_t usernamelen = 0;
-    size_t passwordlen = 0;
     zval *options = nullptr;
     char alt_dsn[512];
 
-    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS(), "s|s!s!a!", &data_source, &data_source_len,
-                                         &username, &usernamelen, &password, &passwordlen, &options))
+    if (!hook_args.get_string(0, data_source_str) ||
+        !hook_args.optional_string(1, username_str, true) ||
+        !hook_args.optional_string(2, password_str, true) ||
+        !hook_args.optional_array(3, options))
     {
         return false;
     }
+    char *data_source = ZSTR_VAL(data_source_str);
+    char *username = username_str ? ZSTR_VAL(username_str) : nullptr;
+    char *password = password_str ? ZSTR_VAL(password_str) : nullptr;
 
     sql_connection_obj.set_connection_string(data_source);
     /* parse the data source name */
@@ -201,10 +203,9 @@ static bool init_pdo_connection_entry(INTERNAL_FUNCTION_PARAMETERS, openrasp::da
 void pre_pdo_query_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     pdo_dbh_t *dbh = Z_PDO_DBH_P(getThis());
-    zval *statement = nullptr;
+    zval *statement = hook_args.get(0);
 
-    if (!ZEND_NUM_ARGS() ||
-        FAILURE == zend_parse_parameters(1, "z", &statement))
+    if (nullptr == statement)
     {
         return;
     }
@@ -220,9 +221,8 @@ void post_pdo_query_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     {
         return;
     }
-    zval *statement = nullptr;
-    if (!ZEND_NUM_ARGS() ||
-        FAILURE == zend_parse_parameters(1, "z", &statement))
+    zval *statement = hook_args.get(0);
+    if (nullptr == statement)
     {
         return;
     }
@@ -260,7 +260,7 @@ void post_pdo___construct_DB_CONNECTION(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     if (Z_TYPE_P(getThis()) == IS_OBJECT && !EG(exception))
     {
         openrasp::data::SqlConnectionObject sco;
-        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, init_pdo_connection_entry, sco);
+        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, init_pdo_connection_entry, sco);
     }
 }
 
@@ -269,7 +269,7 @@ void post_pdo___construct_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     if (EG(exception) && EG(exception)->ce == php_pdo_get_exception())
     {
         openrasp::data::SqlConnectionObject sco;
-        init_pdo_connection_entry(INTERNAL_FUNCTION_PARAM_PASSTHRU, sco);
+        init_pdo_connection_entry(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sco);
         if (is_server_supported(sco.get_server()))
         {
             zval object;
@@ -282,10 +282,11 @@ void post_pdo___construct_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 void pre_pdo_prepare_SQL_PREPARED(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     pdo_dbh_t *dbh = Z_PDO_DBH_P(getThis());
-    zval *statement = nullptr;
+    zval *statement = hook_args.get(0);
     zval *options = nullptr;
 
-    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS(), "z|a", &statement, &options))
+    if (nullptr == statement ||
+        (hook_args.size() > 1 && !hook_args.get_array(1, options)))
     {
         return;
     }
@@ -379,8 +380,9 @@ static void pdo_exception_intercept(const openrasp::data::V8Material &v8_materia
             zval *message = zend_read_property(php_pdo_get_exception(), object, "message", sizeof("message") - 1, 1, &rv);
             if (nullptr != message && Z_TYPE_P(message) == IS_STRING)
             {
+                static const openrasp::RegexHandle sqlstate_regex = openrasp::regex_compile("^SQLSTATE\\[[0-9A-Z]{5}\\] .*");
                 std::string error_msg = std::string(Z_STRVAL_P(message), Z_STRLEN_P(message));
-                if (openrasp::regex_search(error_msg.c_str(), "^SQLSTATE\\[[0-9A-Z]{5}\\] .*"))
+                if (openrasp::regex_run(sqlstate_regex, error_msg.c_str(), error_msg.length()))
                 {
                     std::string error_code = error_msg.substr(9, 5);
                     openrasp::data::SqlErrorObject seo(v8_material, driver_name, error_code, error_msg);
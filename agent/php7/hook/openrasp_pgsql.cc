@@ -35,6 +35,33 @@ static bool openrasp_pg_set_error_verbosity(zval *pgsql_link, const long &restor
 static bool openrasp_pg_set_error_verbosity(zval *pgsql_link, zval *error_verbose, long &old_verbose);
 static void openrasp_detect_pg_last_error(zval *pgsql_link, zval *query);
 
+/**
+ * pg_query([link,] query)、pg_prepare([link,] stmtname, query)，连接资源可省略
+ * extra 为连接资源与 query 之间的字符串参数个数
+ */
+static bool fetch_link_and_query(const HookArgs &hook_args, uint32_t extra, zval *&pgsql_link, zval *&query)
+{
+    zend_string *str = nullptr;
+    uint32_t first = 0;
+    if (hook_args.size() > extra + 1)
+    {
+        if (!hook_args.get_resource(0, pgsql_link))
+        {
+            return false;
+        }
+        first = 1;
+    }
+    for (uint32_t i = 0; i < extra; ++i)
+    {
+        if (!hook_args.get_string(first + i, str))
+        {
+            return false;
+        }
+    }
+    query = hook_args.get(first + extra);
+    return nullptr != query && hook_args.size() == first + extra + 1;
+}
+
 void parse_connection_string(char *connstring, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
     pg_conninfo_parse(connstring,
@@ -43,36 +70,26 @@ void parse_connection_string(char *connstring, openrasp::data::SqlConnectionObje
                       });
 }
 
-static bool init_pg_connection_entry(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj)
+static bool init_pg_connection_entry(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
-    char *host = nullptr, *port = nullptr, *options = nullptr, *tty = nullptr, *dbname = nullptr, *connstring = nullptr;
-    zval *args = nullptr;
-    int connect_type = 0;
-    args = (zval *)safe_emalloc(ZEND_NUM_ARGS(), sizeof(zval), 0);
-    if (ZEND_NUM_ARGS() < 1 || ZEND_NUM_ARGS() > 5 ||
-        zend_get_parameters_array_ex(ZEND_NUM_ARGS(), args) == FAILURE)
+    char *connstring = nullptr;
+    if (hook_args.size() < 1 || hook_args.size() > 5)
     {
-        efree(args);
         return false;
     }
 
     sql_connection_obj.set_server("pgsql");
-    if (ZEND_NUM_ARGS() == 1)
-    { /* new style, using connection string */
-        connstring = Z_STRVAL(args[0]);
-    }
-    else if (ZEND_NUM_ARGS() == 2)
-    { /* Safe to add conntype_option, since 2 args was illegal */
-        connstring = Z_STRVAL(args[0]);
-        convert_to_long_ex(&args[1]);
-        connect_type = (int)Z_LVAL(args[1]);
+    /* new style, using connection string; the second argument is connect_type */
+    zval *conn = hook_args.get(0);
+    if (hook_args.size() <= 2 && Z_TYPE_P(conn) == IS_STRING)
+    {
+        connstring = Z_STRVAL_P(conn);
     }
     if (connstring)
     {
         sql_connection_obj.set_connection_string(connstring);
         parse_connection_string(connstring, sql_connection_obj);
     }
-    efree(args);
     return true;
 }
 
@@ -84,7 +101,7 @@ void post_global_pg_connect_DB_CONNECTION(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     if (Z_TYPE_P(return_value) == IS_RESOURCE)
     {
         openrasp::data::SqlConnectionObject sco;
-        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, init_pg_connection_entry, sco);
+        sql_connection_policy_check(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, init_pg_connection_entry, sco);
     }
 }
 
@@ -103,28 +120,18 @@ void pre_global_pg_query_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     zval *pgsql_link = nullptr;
     zval *query = nullptr;
-    size_t argc = ZEND_NUM_ARGS();
 
-    if (argc == 1)
-    {
-        if (zend_parse_parameters(ZEND_NUM_ARGS(), "z", &query) == FAILURE)
-        {
-            return;
-        }
-    }
-    else
+    if (!fetch_link_and_query(hook_args, 0, pgsql_link, query))
     {
-        if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz", &pgsql_link, &query) == FAILURE)
-        {
-            return;
-        }
+        return;
     }
 
     plugin_sql_check(query, "pgsql");
 
-    //pg_set_error_verbosity to PGSQL_ERRORS_VERBOSE
+    //pg_set_error_verbosity to PGSQL_ERRORS_VERBOSE，只供 SQL_ERROR 的 post 使用并由其恢复
     long old_verbose;
-    if (openrasp_pg_set_error_verbosity(pgsql_link, "PGSQL_ERRORS_VERBOSE", old_verbose))
+    if (!openrasp_check_type_ignored(SQL_ERROR) &&
+        openrasp_pg_set_error_verbosity(pgsql_link, "PGSQL_ERRORS_VERBOSE", old_verbose))
     {
         OPENRASP_HOOK_G(origin_pg_error_verbos) = old_verbose;
     }
@@ -136,21 +143,10 @@ void post_global_pg_query_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     if (Z_TYPE_P(return_value) == IS_FALSE)
     {
         zval *query = nullptr;
-        size_t argc = ZEND_NUM_ARGS();
 
-        if (argc == 1)
+        if (!fetch_link_and_query(hook_args, 0, pgsql_link, query))
         {
-            if (zend_parse_parameters(ZEND_NUM_ARGS(), "z", &query) == FAILURE)
-            {
-                return;
-            }
-        }
-        else
-        {
-            if (zend_parse_parameters(ZEND_NUM_ARGS(), "rz", &pgsql_link, &query) == FAILURE)
-            {
-                return;
-            }
+            return;
         }
         openrasp_detect_pg_last_error(pgsql_link, query);
     }
@@ -175,28 +171,16 @@ void pre_global_pg_prepare_SQL_PREPARED(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
     zval *pgsql_link = nullptr;
     zval *query = nullptr;
-    char *stmtname = nullptr;
-    size_t stmtname_len = 0;
-    size_t argc = ZEND_NUM_ARGS();
 
-    if (argc == 2)
-    {
-        if (zend_parse_parameters(argc, "sz", &stmtname, &stmtname_len, &query) == FAILURE)
-        {
-            return;
-        }
-    }
-    else
+    if (!fetch_link_and_query(hook_args, 1, pgsql_link, query))
     {
-        if (zend_parse_parameters(argc, "rsz", &pgsql_link, &stmtname, &stmtname_len, &query) == FAILURE)
-        {
-            return;
-        }
+        return;
     }
     plugin_sql_check(query, "pgsql");
-    //pg_set_error_verbosity to PGSQL_ERRORS_VERBOSE
+    //pg_set_error_verbosity to PGSQL_ERRORS_VERBOSE，只供 SQL_ERROR 的 post 使用并由其恢复
     long old_verbose;
-    if (openrasp_pg_set_error_verbosity(pgsql_link, "PGSQL_ERRORS_VERBOSE", old_verbose))
+    if (!openrasp_check_type_ignored(SQL_ERROR) &&
+        openrasp_pg_set_error_verbosity(pgsql_link, "PGSQL_ERRORS_VERBOSE", old_verbose))
     {
         OPENRASP_HOOK_G(origin_pg_error_verbos) = old_verbose;
     }
@@ -208,23 +192,10 @@ void post_global_pg_prepare_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
     if (Z_TYPE_P(return_value) == IS_FALSE)
     {
         zval *query = nullptr;
-        char *stmtname = nullptr;
-        size_t stmtname_len = 0;
-        size_t argc = ZEND_NUM_ARGS();
 
-        if (argc == 2)
+        if (!fetch_link_and_query(hook_args, 1, pgsql_link, query))
         {
-            if (zend_parse_parameters(argc, "sz", &stmtname, &stmtname_len, &query) == FAILURE)
-            {
-                return;
-            }
-        }
-        else
-        {
-            if (zend_parse_parameters(argc, "rsz", &pgsql_link, &stmtname, &stmtname_len, &query) == FAILURE)
-            {
-                return;
-            }
+            return;
         }
         openrasp_detect_pg_last_error(pgsql_link, query);
     }
@@ -241,10 +212,8 @@ void pre_global_pg_send_prepare_SQL_PREPARED(OPENRASP_INTERNAL_FUNCTION_PARAMETE
 {
     zval *pgsql_link = nullptr;
     zval *query = nullptr;
-    char *stmtname = nullptr;
-    size_t stmtname_len;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "rsz", &pgsql_link, &stmtname, &stmtname_len, &query) == FAILURE)
+    if (hook_args.size() != 3 || !fetch_link_and_query(hook_args, 1, pgsql_link, query))
     {
         return;
     }
@@ -307,8 +276,9 @@ void openrasp_detect_pg_last_error(zval *pgsql_link, zval *query)
             size_t error_found = error_msg.find("ERROR:");
             if (error_found != std::string::npos && error_msg.length() >= error_found + 12)
             {
+                static const openrasp::RegexHandle error_code_regex = openrasp::regex_compile("^[0-9A-Z]{5}$", true);
                 std::string error_code = error_msg.substr(error_found + 8, 5);
-                if (openrasp::regex_match(error_code.c_str(), "^[0-9A-Z]{5}$"))
+                if (openrasp::regex_run(error_code_regex, error_code.c_str(), error_code.length()))
                 {
                     openrasp::data::SqlErrorObject seo(openrasp::data::SqlObject("pgsql", query), "pgsql", error_code, error_msg);
                     openrasp::checker::V8Detector v8_detector(seo, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis));
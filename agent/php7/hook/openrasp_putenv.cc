@@ -23,8 +23,8 @@ PRE_HOOK_FUNCTION(putenv, WEBSHELL_ENV);
 
 void pre_global_putenv_WEBSHELL_ENV(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-    zval *env = nullptr;
-    if (zend_parse_parameters(MIN(1, ZEND_NUM_ARGS()), "z", &env) == FAILURE)
+    zval *env = hook_args.get(0);
+    if (nullptr == env)
     {
         return;
     }
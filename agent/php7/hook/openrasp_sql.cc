@@ -38,11 +38,11 @@ extern "C"
 #endif
 }
 
-void sql_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, init_sql_connection_t connection_init_func, openrasp::data::SqlConnectionObject &sql_connection_obj)
+void sql_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, init_sql_connection_t connection_init_func, openrasp::data::SqlConnectionObject &sql_connection_obj)
 {
     if (connection_init_func)
     {
-        if (connection_init_func(INTERNAL_FUNCTION_PARAM_PASSTHRU, sql_connection_obj))
+        if (connection_init_func(INTERNAL_FUNCTION_PARAM_PASSTHRU, hook_args, sql_connection_obj))
         {
             openrasp::data::SqlUsernameObject suo(sql_connection_obj);
             openrasp::checker::PolicyDetector username_detector(suo);
@@ -20,11 +20,12 @@
 #include "hook/data/sql_connection_object.h"
 #include "openrasp_v8.h"
 #include "openrasp_utils.h"
+#include "openrasp_hook.h"
 
-typedef bool (*init_sql_connection_t)(INTERNAL_FUNCTION_PARAMETERS, openrasp::data::SqlConnectionObject &sql_connection_obj);
+typedef bool (*init_sql_connection_t)(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, openrasp::data::SqlConnectionObject &sql_connection_obj);
 
 void plugin_sql_check(zval *query, const std::string &server);
-void sql_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, init_sql_connection_t connection_init_func, openrasp::data::SqlConnectionObject &sql_connection_obj);
+void sql_connection_policy_check(INTERNAL_FUNCTION_PARAMETERS, const HookArgs &hook_args, init_sql_connection_t connection_init_func, openrasp::data::SqlConnectionObject &sql_connection_obj);
 void pg_conninfo_parse(char *connstring, std::function<void(const char *pname, const char *pval)> info_store_func);
 
 #endif
\ No newline at end of file
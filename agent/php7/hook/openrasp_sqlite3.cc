@@ -34,9 +34,9 @@ static void sqlite_query_error_intercept(zval *query, zval *object_p);
 //sqlite3::exec
 void pre_sqlite3_exec_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-	zval *sql = nullptr;
+	zval *sql = hook_args.get(0);
 
-	if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS(), "z", &sql))
+	if (nullptr == sql)
 	{
 		return;
 	}
@@ -57,10 +57,10 @@ void pre_sqlite3_prepare_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 //sqlite3::querySingle
 void pre_sqlite3_querysingle_SQL(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
-	zval *sql = nullptr;
+	zval *sql = hook_args.get(0);
 	zend_bool entire_row = 0;
 
-	if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS(), "z|b", &sql, &entire_row))
+	if (nullptr == sql || !hook_args.optional_bool(1, entire_row))
 	{
 		return;
 	}
@@ -71,9 +71,9 @@ void post_sqlite3_exec_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
 	if (Z_TYPE_P(return_value) == IS_FALSE)
 	{
-		zval *sql = nullptr;
+		zval *sql = hook_args.get(0);
 
-		if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS(), "z", &sql))
+		if (nullptr == sql)
 		{
 			return;
 		}
@@ -93,10 +93,10 @@ void post_sqlite3_querysingle_SQL_ERROR(OPENRASP_INTERNAL_FUNCTION_PARAMETERS)
 {
 	if (Z_TYPE_P(return_value) == IS_FALSE)
 	{
-		zval *sql = nullptr;
+		zval *sql = hook_args.get(0);
 		zend_bool entire_row = 0;
 
-		if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS(), "z|b", &sql, &entire_row))
+		if (nullptr == sql || !hook_args.optional_bool(1, entire_row))
 		{
 			return;
 		}
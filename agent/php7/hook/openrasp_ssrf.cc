@@ -21,6 +21,7 @@
 #include "openrasp_v8.h"
 #include "utils/net.h"
 #include "utils/url.h"
+#include <curl/curl.h>
 
 extern "C"
 {
@@ -44,85 +45,104 @@ extern "C"
 /**
  * ssrf相关hook点
  */
-void pre_global_curl_exec_ssrf(OPENRASP_INTERNAL_FUNCTION_PARAMETERS, zval *opt, zval *origin_url, zval args[]);
-void post_global_curl_exec_ssrf(OPENRASP_INTERNAL_FUNCTION_PARAMETERS, zval *origin_url, zval args[]);
+static CURL *fetch_curl_handle(zval *zid);
+static bool fetch_curl_string_info(CURL *cp, CURLINFO info, zval *value);
+void pre_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAMETERS, OpenRASPCheckType check_type, CURL *cp, zval *origin_url);
+void post_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAMETERS, OpenRASPCheckType check_type, CURL *cp, zval *zid, zval *origin_url);
 
 OPENRASP_HOOK_FUNCTION(curl_exec, SSRF)
 {
     zval origin_url;
-    zval *opt = nullptr;
-    bool skip_hook = false;
-    zval args[2];
+    zval *zid = nullptr;
+    CURL *cp = nullptr;
     ZVAL_NULL(&origin_url);
-    if ((opt = zend_get_constant_str(ZEND_STRL("CURLINFO_EFFECTIVE_URL"))) != nullptr)
+    if (zend_parse_parameters_ex(ZEND_PARSE_PARAMS_QUIET, ZEND_NUM_ARGS(), "r", &zid) == SUCCESS)
     {
-        if (!openrasp_check_type_ignored(SSRF))
-        {
-            pre_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAM_PASSTHRU, SSRF, opt, &origin_url, args);
-        }
-        origin_function(INTERNAL_FUNCTION_PARAM_PASSTHRU);
-        if (!openrasp_check_type_ignored(SSRF_REDIRECT))
-        {
-            post_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAM_PASSTHRU, SSRF, &origin_url, args);
-        }
-        zval_ptr_dtor(opt);
+        cp = fetch_curl_handle(zid);
+    }
+    if (nullptr != cp)
+    {
+        pre_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAM_PASSTHRU, SSRF, cp, &origin_url);
+    }
+    origin_function(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+    if (nullptr != cp && !openrasp_check_type_ignored(SSRF_REDIRECT))
+    {
+        post_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAM_PASSTHRU, SSRF, cp, zid, &origin_url);
     }
     zval_ptr_dtor(&origin_url);
 }
 
-void pre_global_curl_exec_ssrf(OPENRASP_INTERNAL_FUNCTION_PARAMETERS, zval *opt, zval *origin_url, zval args[])
+/**
+ * 直接从 curl 资源中取出 CURL 句柄，避免通过 curl_getinfo 等用户函数中转
+ * PHP 7 中 php_curl (ext/curl/php_curl.h) 的第一个成员即为 CURL *cp
+ */
+CURL *fetch_curl_handle(zval *zid)
 {
-    zval *zid = nullptr;
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "r", &zid) == FAILURE)
+    static int le_curl = 0;
+    if (le_curl <= 0)
     {
-        return;
+        le_curl = zend_fetch_list_dtor_id("curl");
     }
-    args[0] = *zid;
-    args[1] = *opt;
-    if (openrasp_call_user_function(EG(function_table), nullptr, "curl_getinfo", origin_url, 2, args))
+    if (le_curl <= 0 ||
+        nullptr == zid ||
+        Z_TYPE_P(zid) != IS_RESOURCE ||
+        Z_RES_TYPE_P(zid) != le_curl ||
+        nullptr == Z_RES_VAL_P(zid))
+    {
+        return nullptr;
+    }
+    return *reinterpret_cast<CURL **>(Z_RES_VAL_P(zid));
+}
+
+bool fetch_curl_string_info(CURL *cp, CURLINFO info, zval *value)
+{
+    char *str = nullptr;
+    if (nullptr != cp && curl_easy_getinfo(cp, info, &str) == CURLE_OK && nullptr != str)
+    {
+        ZVAL_STRING(value, str);
+        return true;
+    }
+    return false;
+}
+
+void pre_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAMETERS, OpenRASPCheckType check_type, CURL *cp, zval *origin_url)
+{
+    if (fetch_curl_string_info(cp, CURLINFO_EFFECTIVE_URL, origin_url) &&
+        !openrasp_check_type_ignored(SSRF))
     {
         plugin_ssrf_check(origin_url, "curl_exec");
     }
 }
-void post_global_curl_exec_ssrf(OPENRASP_INTERNAL_FUNCTION_PARAMETERS, zval *origin_url, zval args[])
+
+void post_global_curl_exec_ssrf(INTERNAL_FUNCTION_PARAMETERS, OpenRASPCheckType check_type, CURL *cp, zval *zid, zval *origin_url)
 {
     if (nullptr != origin_url &&
         Z_TYPE_P(origin_url) == IS_STRING &&
         Z_STRLEN_P(origin_url) > 0)
     {
-        int curl_error;
-        zval z_curl_error;
-        ZVAL_NULL(&z_curl_error);
-        if (openrasp_call_user_function(EG(function_table), nullptr, "curl_errno", &z_curl_error, 1, args))
-        {
-            curl_error = Z_LVAL(z_curl_error);
-            zval_ptr_dtor(&z_curl_error);
-        }
-        else
+        int curl_error = 0;
+        if (Z_TYPE_P(return_value) == IS_FALSE)
         {
-            return;
+            // the error number lives in php_curl itself and is not exposed by libcurl
+            zval z_curl_error;
+            ZVAL_NULL(&z_curl_error);
+            if (openrasp_call_user_function(EG(function_table), nullptr, "curl_errno", &z_curl_error, 1, zid))
+            {
+                curl_error = Z_TYPE(z_curl_error) == IS_LONG ? Z_LVAL(z_curl_error) : 0;
+                zval_ptr_dtor(&z_curl_error);
+            }
         }
         zval effective_url;
         ZVAL_NULL(&effective_url);
-        if (openrasp_call_user_function(EG(function_table), nullptr, "curl_getinfo", &effective_url, 2, args))
+        if (fetch_curl_string_info(cp, CURLINFO_EFFECTIVE_URL, &effective_url))
         {
-            zval *opt_http_code = nullptr;
-            if ((opt_http_code = zend_get_constant_str(ZEND_STRL("CURLINFO_HTTP_CODE"))) != nullptr)
-            {
-                zval http_status;
-                ZVAL_NULL(&http_status);
-                args[1] = *opt_http_code;
-                if (openrasp_call_user_function(EG(function_table), nullptr, "curl_getinfo", &http_status, 2, args))
-                {
-                    if (Z_TYPE(http_status) == IS_LONG)
-                    {
-                        openrasp::data::SsrfRedirectObject ssrf_redirect_obj(origin_url, &effective_url, "curl_exec", curl_error, Z_LVAL(http_status));
-                        openrasp::checker::V8Detector v8_detector(ssrf_redirect_obj, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis));
-                        v8_detector.run();
-                    }
-                    zval_ptr_dtor(&http_status);
-                }
-            }
+            long http_status = 0;
+            curl_easy_getinfo(cp, CURLINFO_RESPONSE_CODE, &http_status);
+            char *primary_ip = nullptr;
+            curl_easy_getinfo(cp, CURLINFO_PRIMARY_IP, &primary_ip);
+            openrasp::data::SsrfRedirectObject ssrf_redirect_obj(origin_url, &effective_url, "curl_exec", curl_error, http_status, SAFE_STRING(primary_ip));
+            openrasp::checker::V8Detector v8_detector(ssrf_redirect_obj, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis));
+            v8_detector.run();
             zval_ptr_dtor(&effective_url);
         }
     }
@@ -0,0 +1,301 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "input_index.h"
+#include <algorithm>
+#include <cstring>
+
+namespace openrasp
+{
+namespace request
+{
+
+const size_t InputIndex::default_max_depth = 8;
+const size_t InputIndex::default_max_entries = 4096;
+
+static const size_t min_slots = 64;
+//名称池中每个 key 最多保存的字节数
+static const size_t max_name_length = 256;
+
+static const struct
+{
+    int id;
+    const char *name;
+} input_globals[] = {{TRACK_VARS_POST, "_POST"},
+                     {TRACK_VARS_GET, "_GET"},
+                     {TRACK_VARS_COOKIE, "_COOKIE"}};
+
+static inline size_t slot_of(uintptr_t ptr, size_t mask)
+{
+    uint64_t h = static_cast<uint64_t>(ptr >> 3) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<size_t>(h >> 32) & mask;
+}
+
+InputIndex::InputIndex()
+{
+    for (zval &input : inputs)
+    {
+        ZVAL_UNDEF(&input);
+    }
+}
+
+void InputIndex::reset(size_t max_depth, size_t max_entries)
+{
+    clear();
+    this->max_depth = max_depth;
+    this->max_entries = max_entries;
+    if (0 == max_depth)
+    {
+        return;
+    }
+    for (size_t i = 0; i < sizeof(input_globals) / sizeof(input_globals[0]); ++i)
+    {
+        zval *value = &PG(http_globals)[input_globals[i].id];
+        if (Z_TYPE_P(value) != IS_ARRAY)
+        {
+            zend_is_auto_global_str(const_cast<char *>(input_globals[i].name), strlen(input_globals[i].name));
+        }
+        if (Z_TYPE_P(value) == IS_ARRAY)
+        {
+            ZVAL_COPY(&inputs[i], value);
+        }
+    }
+}
+
+void InputIndex::clear()
+{
+    for (zval &input : inputs)
+    {
+        zval_ptr_dtor(&input);
+        ZVAL_UNDEF(&input);
+    }
+    //保留容量，下个请求直接复用
+    if (!entries.empty())
+    {
+        std::fill(slots.begin(), slots.end(), 0);
+    }
+    entries.clear();
+    names.clear();
+    nested_entries = 0;
+    built = false;
+    truncated = false;
+}
+
+void InputIndex::grow()
+{
+    size_t capacity = slots.empty() ? min_slots : slots.size() * 2;
+    slots.assign(capacity, 0);
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        size_t slot = slot_of(entries[i].ptr, mask);
+        while (slots[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+int32_t InputIndex::add(uintptr_t ptr, int track_id, int32_t parent, const char *name, size_t name_length)
+{
+    //顶层参数不计入上限
+    if (parent >= 0 && nested_entries >= max_entries)
+    {
+        truncated = true;
+        return -1;
+    }
+    //负载不超过 1/2
+    if ((entries.size() + 1) * 2 > slots.size())
+    {
+        grow();
+    }
+    size_t mask = slots.size() - 1;
+    size_t slot = slot_of(ptr, mask);
+    while (slots[slot] != 0)
+    {
+        if (entries[slots[slot] - 1].ptr == ptr)
+        {
+            return -1;
+        }
+        slot = (slot + 1) & mask;
+    }
+    name_length = std::min(name_length, max_name_length);
+    Entry entry;
+    entry.ptr = ptr;
+    entry.parent = parent;
+    entry.name_offset = static_cast<uint32_t>(names.length());
+    entry.name_length = static_cast<uint32_t>(name_length);
+    entry.track_id = track_id;
+    names.append(name, name_length);
+    entries.push_back(entry);
+    slots[slot] = static_cast<uint32_t>(entries.size());
+    if (parent >= 0)
+    {
+        ++nested_entries;
+    }
+    return static_cast<int32_t>(entries.size() - 1);
+}
+
+void InputIndex::add_array(const PendingArray &array, std::vector<PendingArray> &next)
+{
+    zend_string *key = nullptr;
+    zend_ulong idx;
+    zval *val = nullptr;
+    ZEND_HASH_FOREACH_KEY_VAL(array.ht, idx, key, val)
+    {
+        if (truncated)
+        {
+            return;
+        }
+        ZVAL_DEREF(val);
+        //只有引用计数的值才有独立的地址，驻留字符串与不可变空数组会被其他代码共享
+        if ((Z_TYPE_P(val) != IS_STRING && Z_TYPE_P(val) != IS_ARRAY) || !Z_REFCOUNTED_P(val))
+        {
+            continue;
+        }
+        int32_t index = -1;
+        if (key != nullptr)
+        {
+            index = add(reinterpret_cast<uintptr_t>(Z_COUNTED_P(val)), array.track_id, array.parent, ZSTR_VAL(key), ZSTR_LEN(key));
+        }
+        else
+        {
+            char buf[MAX_LENGTH_OF_LONG + 1];
+            char *end = buf + sizeof(buf) - 1;
+            *end = '\0';
+            char *name = zend_print_long_to_buf(end, static_cast<zend_long>(idx));
+            index = add(reinterpret_cast<uintptr_t>(Z_COUNTED_P(val)), array.track_id, array.parent, name, end - name);
+        }
+        if (index >= 0 && Z_TYPE_P(val) == IS_ARRAY && array.depth < max_depth)
+        {
+            next.push_back({Z_ARRVAL_P(val), array.track_id, index, array.depth + 1});
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+void InputIndex::build()
+{
+    built = true;
+    //遍历 RINIT 时持有的数组，不受脚本对超全局变量重新赋值的影响
+    //先记录三个数组的全部顶层参数，再逐层展开嵌套数组，某个数组嵌套过多不会挤掉其他数组的参数
+    std::vector<PendingArray> current;
+    std::vector<PendingArray> next;
+    for (size_t i = 0; i < sizeof(input_globals) / sizeof(input_globals[0]); ++i)
+    {
+        if (Z_TYPE(inputs[i]) == IS_ARRAY)
+        {
+            add_array({Z_ARRVAL(inputs[i]), input_globals[i].id, -1, 1}, current);
+        }
+    }
+    while (!current.empty() && !truncated)
+    {
+        for (const PendingArray &array : current)
+        {
+            add_array(array, next);
+            if (truncated)
+            {
+                break;
+            }
+        }
+        current.swap(next);
+        next.clear();
+    }
+}
+
+const InputIndex::Entry *InputIndex::find(zval *value)
+{
+    if (nullptr == value)
+    {
+        return nullptr;
+    }
+    ZVAL_DEREF(value);
+    if ((Z_TYPE_P(value) != IS_STRING && Z_TYPE_P(value) != IS_ARRAY) || !Z_REFCOUNTED_P(value))
+    {
+        return nullptr;
+    }
+    if (!built)
+    {
+        build();
+    }
+    if (entries.empty())
+    {
+        return nullptr;
+    }
+    uintptr_t ptr = reinterpret_cast<uintptr_t>(Z_COUNTED_P(value));
+    size_t mask = slots.size() - 1;
+    size_t slot = slot_of(ptr, mask);
+    while (slots[slot] != 0)
+    {
+        const Entry &entry = entries[slots[slot] - 1];
+        if (entry.ptr == ptr)
+        {
+            return &entry;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
+}
+
+bool InputIndex::contains(zval *value)
+{
+    return nullptr != find(value);
+}
+
+bool InputIndex::fetch_name(zval *value, std::string &name, int &track_id)
+{
+    const Entry *entry = find(value);
+    if (nullptr == entry)
+    {
+        return false;
+    }
+    track_id = entry->track_id;
+    std::vector<const Entry *> path;
+    for (const Entry *it = entry; it != nullptr; it = it->parent >= 0 ? &entries[it->parent] : nullptr)
+    {
+        path.push_back(it);
+    }
+    name.clear();
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        bool top = (it == path.rbegin());
+        if (!top)
+        {
+            name.push_back('[');
+        }
+        name.append(names, (*it)->name_offset, (*it)->name_length);
+        if (!top)
+        {
+            name.push_back(']');
+        }
+    }
+    return true;
+}
+
+size_t InputIndex::size() const
+{
+    return entries.size();
+}
+
+bool InputIndex::is_truncated() const
+{
+    return truncated;
+}
+
+} // namespace request
+
+} // namespace openrasp
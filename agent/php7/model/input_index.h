@@ -0,0 +1,92 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "php_openrasp.h"
+
+namespace openrasp
+{
+namespace request
+{
+/**
+ * GET/POST/COOKIE 中字符串与数组值的指针索引，用于判断某个 zval 是否直接来自请求
+ * RINIT 时持有 GET/POST/COOKIE 数组的引用，第一次查询时才遍历：顶层参数全部记录，
+ * 嵌套数组按层展开到 max_depth，嵌套条目数不超过 max_entries
+ * 持有引用使脚本重新赋值超全局变量后，已取出的值仍能被识别
+ * 开放寻址表只保存条目下标；条目只记录自身的 key（在名称池中的偏移）与父条目，完整名称在报警时再拼接
+ */
+class InputIndex
+{
+private:
+    struct Entry
+    {
+        uintptr_t ptr;
+        int32_t parent;
+        uint32_t name_offset;
+        uint32_t name_length;
+        int track_id;
+    };
+
+    //按 TRACK_VARS_POST、TRACK_VARS_GET、TRACK_VARS_COOKIE 顺序保存的数组副本，RSHUTDOWN 时释放
+    zval inputs[3];
+    //待展开的嵌套数组
+    struct PendingArray
+    {
+        HashTable *ht;
+        int track_id;
+        int32_t parent;
+        size_t depth;
+    };
+
+    std::vector<Entry> entries;
+    //0 表示空槽，其余为 entries 下标 + 1
+    std::vector<uint32_t> slots;
+    std::string names;
+    size_t max_depth = 0;
+    size_t max_entries = 0;
+    size_t nested_entries = 0;
+    bool built = false;
+    bool truncated = false;
+
+    void build();
+    void add_array(const PendingArray &array, std::vector<PendingArray> &next);
+    int32_t add(uintptr_t ptr, int track_id, int32_t parent, const char *name, size_t name_length);
+    void grow();
+    const Entry *find(zval *value);
+
+public:
+    static const size_t default_max_depth;
+    static const size_t default_max_entries;
+
+    InputIndex();
+    //RINIT 时调用，记录限制并持有请求数组，不做遍历
+    void reset(size_t max_depth, size_t max_entries);
+    bool contains(zval *value);
+    /**
+     * 命中时返回 true，name 为 a[b][c] 形式的完整名称，track_id 为 TRACK_VARS_*
+     */
+    bool fetch_name(zval *value, std::string &name, int &track_id);
+    size_t size() const;
+    bool is_truncated() const;
+    void clear();
+};
+} // namespace request
+
+} // namespace openrasp
@@ -22,6 +22,7 @@
 #endif
 
 #include "utils/json_reader.h"
+#include "utils/json_validator.h"
 
 namespace openrasp
 {
@@ -52,6 +53,290 @@ std::string Parameter::MultipartFile::get_tmpname() const
     return tmpname;
 }
 
+/**
+ * 将 $_POST 编码为与 json_encode 相同的 JSON（非 ASCII 字符转义为 \uXXXX，/ 转义为 \/）
+ * 超过上限后不再追加新成员，已打开的数组/对象仍会闭合以保证 JSON 合法；非法 UTF-8 替换为 \ufffd
+ */
+class FormEncoder
+{
+public:
+    static const int max_depth = 64;
+
+private:
+    std::string &buf;
+    size_t limit;
+    bool truncated = false;
+
+public:
+    FormEncoder(std::string &buf, size_t limit) : buf(buf), limit(limit) {}
+
+    void encode(zval *value)
+    {
+        append_value(value, 0);
+    }
+
+private:
+    //depth 为已打开的容器数，为它们的闭合括号与字符串的结束引号预留空间
+    bool has_room(size_t length, int depth)
+    {
+        if (!truncated && buf.size() + length + depth + 1 > limit)
+        {
+            truncated = true;
+        }
+        return !truncated;
+    }
+
+    void append_escaped(const char *piece, size_t length, int depth)
+    {
+        if (has_room(length, depth))
+        {
+            buf.append(piece, length);
+        }
+    }
+
+    void append_unicode(uint32_t code, int depth)
+    {
+        static const char digits[] = "0123456789abcdef";
+        char piece[12];
+        size_t length = 0;
+        if (code >= 0x10000)
+        {
+            code -= 0x10000;
+            uint32_t high = 0xD800 | (code >> 10);
+            uint32_t low = 0xDC00 | (code & 0x3FF);
+            for (uint32_t unit : {high, low})
+            {
+                piece[length++] = '\\';
+                piece[length++] = 'u';
+                for (int shift = 12; shift >= 0; shift -= 4)
+                {
+                    piece[length++] = digits[(unit >> shift) & 0xF];
+                }
+            }
+        }
+        else
+        {
+            piece[length++] = '\\';
+            piece[length++] = 'u';
+            for (int shift = 12; shift >= 0; shift -= 4)
+            {
+                piece[length++] = digits[(code >> shift) & 0xF];
+            }
+        }
+        append_escaped(piece, length, depth);
+    }
+
+    //返回 str 开头的 UTF-8 字符长度，非法时返回 0
+    static size_t decode_utf8(const unsigned char *str, size_t remain, uint32_t &code)
+    {
+        unsigned char c = str[0];
+        size_t length = 0;
+        unsigned char lower = 0x80, upper = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF)
+        {
+            length = 2;
+            code = c & 0x1F;
+        }
+        else if (c >= 0xE0 && c <= 0xEF)
+        {
+            length = 3;
+            code = c & 0x0F;
+            lower = c == 0xE0 ? 0xA0 : 0x80;
+            upper = c == 0xED ? 0x9F : 0xBF;
+        }
+        else if (c >= 0xF0 && c <= 0xF4)
+        {
+            length = 4;
+            code = c & 0x07;
+            lower = c == 0xF0 ? 0x90 : 0x80;
+            upper = c == 0xF4 ? 0x8F : 0xBF;
+        }
+        if (0 == length || length > remain)
+        {
+            return 0;
+        }
+        for (size_t i = 1; i < length; ++i)
+        {
+            if (str[i] < lower || str[i] > upper)
+            {
+                return 0;
+            }
+            lower = 0x80;
+            upper = 0xBF;
+            code = (code << 6) | (str[i] & 0x3F);
+        }
+        return length;
+    }
+
+    void append_string(const char *data, size_t length, int depth)
+    {
+        if (!has_room(1, depth))
+        {
+            return;
+        }
+        buf.push_back('"');
+        const unsigned char *str = reinterpret_cast<const unsigned char *>(data);
+        size_t i = 0;
+        while (i < length && !truncated)
+        {
+            unsigned char c = str[i];
+            if (c >= 0x80)
+            {
+                uint32_t code = 0xFFFD;
+                size_t consumed = decode_utf8(str + i, length - i, code);
+                append_unicode(0 == consumed ? 0xFFFD : code, depth);
+                i += 0 == consumed ? 1 : consumed;
+                continue;
+            }
+            switch (c)
+            {
+            case '"':
+                append_escaped("\\\"", 2, depth);
+                break;
+            case '\\':
+                append_escaped("\\\\", 2, depth);
+                break;
+            case '/':
+                append_escaped("\\/", 2, depth);
+                break;
+            case '\b':
+                append_escaped("\\b", 2, depth);
+                break;
+            case '\f':
+                append_escaped("\\f", 2, depth);
+                break;
+            case '\n':
+                append_escaped("\\n", 2, depth);
+                break;
+            case '\r':
+                append_escaped("\\r", 2, depth);
+                break;
+            case '\t':
+                append_escaped("\\t", 2, depth);
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    append_unicode(c, depth);
+                }
+                else if (has_room(1, depth))
+                {
+                    buf.push_back(c);
+                }
+            }
+            ++i;
+        }
+        buf.push_back('"');
+    }
+
+    //与 json_encode 一致：键为 0..n-1 的连续整数时输出数组
+    static bool is_list(HashTable *ht)
+    {
+        zend_string *key;
+        zend_ulong idx;
+        zend_ulong expected = 0;
+        ZEND_HASH_FOREACH_KEY(ht, idx, key)
+        {
+            if (key || idx != expected++)
+            {
+                return false;
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+        return true;
+    }
+
+    void append_hash(HashTable *ht, int depth)
+    {
+        bool as_list = is_list(ht);
+        buf.push_back(as_list ? '[' : '{');
+        bool first = true;
+        zend_string *key;
+        zend_ulong idx;
+        zval *value;
+        ZEND_HASH_FOREACH_KEY_VAL_IND(ht, idx, key, value)
+        {
+            //放不下完整的成员时回退到逗号之前
+            size_t mark = buf.size();
+            if (!first)
+            {
+                buf.push_back(',');
+            }
+            if (!as_list)
+            {
+                if (key)
+                {
+                    append_string(ZSTR_VAL(key), ZSTR_LEN(key), depth + 1);
+                }
+                else
+                {
+                    std::string index = std::to_string(idx);
+                    append_string(index.c_str(), index.length(), depth + 1);
+                }
+                if (truncated)
+                {
+                    buf.resize(mark);
+                    break;
+                }
+                buf.push_back(':');
+            }
+            size_t value_mark = buf.size();
+            append_value(value, depth + 1);
+            if (buf.size() == value_mark)
+            {
+                buf.resize(mark);
+                break;
+            }
+            first = false;
+        }
+        ZEND_HASH_FOREACH_END();
+        buf.push_back(as_list ? ']' : '}');
+    }
+
+    void append_value(zval *value, int depth)
+    {
+        ZVAL_DEREF(value);
+        switch (Z_TYPE_P(value))
+        {
+        case IS_STRING:
+            append_string(Z_STRVAL_P(value), Z_STRLEN_P(value), depth);
+            break;
+        case IS_ARRAY:
+            if (depth >= max_depth)
+            {
+                append_escaped("null", 4, depth);
+            }
+            else if (has_room(2, depth))
+            {
+                append_hash(Z_ARRVAL_P(value), depth);
+            }
+            break;
+        case IS_LONG:
+        {
+            std::string number = std::to_string(Z_LVAL_P(value));
+            append_escaped(number.c_str(), number.length(), depth);
+            break;
+        }
+        case IS_DOUBLE:
+        {
+            char number[32];
+            int length = zend_finite(Z_DVAL_P(value)) ? snprintf(number, sizeof(number), "%.17g", Z_DVAL_P(value)) : snprintf(number, sizeof(number), "0");
+            append_escaped(number, length, depth);
+            break;
+        }
+        case IS_TRUE:
+            append_escaped("true", 4, depth);
+            break;
+        case IS_FALSE:
+            append_escaped("false", 5, depth);
+            break;
+        default:
+            append_escaped("null", 4, depth);
+            break;
+        }
+    }
+};
+
 Parameter::Parameter(/* args */)
 {
 }
@@ -60,20 +345,71 @@ Parameter::~Parameter()
 {
 }
 
-std::string Parameter::get_form_str() const
+bool Parameter::begin_resolve(View view) const
 {
-    return form_str.empty() ? "{}" : form_str;
+    uint32_t bit = 1u << view;
+    if (resolved & bit)
+    {
+        return false;
+    }
+    resolved |= bit;
+    return true;
 }
 
-std::string Parameter::get_json_str() const
+const std::string &Parameter::get_raw_body(bool *complete) const
 {
-    return json_str.empty() ? "{}" : json_str;
+    if (begin_resolve(kRawBody))
+    {
+        update_raw_body();
+    }
+    if (nullptr != complete)
+    {
+        *complete = raw_body_complete;
+    }
+    return raw_body;
 }
 
-std::string Parameter::get_multipart_str()
+const std::string &Parameter::get_form_str() const
 {
-    if (multipart_str.empty())
+    if (begin_resolve(kForm))
     {
+        if (OpenRASPContentType::ContentType::cApplicationForm == content_type ||
+            OpenRASPContentType::ContentType::cMultipartForm == content_type)
+        {
+            update_form_str();
+        }
+        if (form_str.empty())
+        {
+            form_str = "{}";
+        }
+    }
+    return form_str;
+}
+
+const std::string &Parameter::get_json_str() const
+{
+    if (begin_resolve(kJson))
+    {
+        if (OpenRASPContentType::ContentType::cApplicationJson == content_type)
+        {
+            update_json_str();
+        }
+        if (json_str.empty())
+        {
+            json_str = "{}";
+        }
+    }
+    return json_str;
+}
+
+const std::string &Parameter::get_multipart_str() const
+{
+    if (begin_resolve(kMultipart))
+    {
+        if (begin_resolve(kFiles))
+        {
+            update_multipart_files();
+        }
         JsonReader j;
         std::map<std::string, std::string> name_filename;
         for (auto iter = files.begin(); iter != files.end(); iter++)
@@ -93,6 +429,10 @@ std::string Parameter::get_multipart_str()
 
 bool Parameter::fetch_fileinfo_by_tmpname(const std::string &tmpname, std::string &name, std::string &filename) const
 {
+    if (begin_resolve(kFiles))
+    {
+        update_multipart_files();
+    }
     for (auto iter = files.begin(); iter != files.end(); iter++)
     {
         if (tmpname == iter->second.get_tmpname())
@@ -109,9 +449,19 @@ bool Parameter::fetch_fileinfo_by_tmpname(const std::string &tmpname, std::strin
     return false;
 }
 
-std::string Parameter::get_body() const
+const std::string &Parameter::get_body() const
 {
-    return body_str;
+    static const std::string empty;
+    //json/form/multipart 的请求体已体现在对应的视图中
+    switch (content_type)
+    {
+    case OpenRASPContentType::ContentType::cApplicationJson:
+    case OpenRASPContentType::ContentType::cApplicationForm:
+    case OpenRASPContentType::ContentType::cMultipartForm:
+        return empty;
+    default:
+        return get_raw_body();
+    }
 }
 
 bool Parameter::get_initialized() const
@@ -119,67 +469,84 @@ bool Parameter::get_initialized() const
     return initialized;
 }
 
-void Parameter::set_initialized(bool initialized)
+void Parameter::init(OpenRASPContentType::ContentType content_type, size_t max_bytes)
 {
-    this->initialized = initialized;
+    this->content_type = content_type;
+    this->max_bytes = max_bytes;
+    this->initialized = true;
 }
 
 void Parameter::clear()
 {
+    content_type = OpenRASPContentType::ContentType::cNull;
+    max_bytes = 0;
+    resolved = 0;
+    raw_body.clear();
+    raw_body_complete = false;
     form_str.clear();
     json_str.clear();
-    body_str.clear();
     files.clear();
     multipart_str.clear();
     initialized = false;
 }
 
 //the functions below is different in PHP5 and PHP7
-void Parameter::update_body_str(size_t body_len)
+void Parameter::update_raw_body() const
 {
+    raw_body.clear();
+    //上限为 0 时不读取，不能视为完整，需要完整请求体的地方（context.json）自行读取
+    if (0 == max_bytes)
+    {
+        raw_body_complete = false;
+        return;
+    }
+    raw_body_complete = true;
+    //多读一个字节用于判断是否被截断
     zend_string *body = nullptr;
-    if ((body = fetch_request_body(body_len)) != nullptr)
+    if ((body = fetch_request_body(max_bytes + 1)) != nullptr)
     {
-        if (ZSTR_LEN(body) > 0)
+        size_t length = ZSTR_LEN(body);
+        if (length > max_bytes)
         {
-            body_str = std::string(ZSTR_VAL(body), ZSTR_LEN(body));
+            length = max_bytes;
+            raw_body_complete = false;
         }
+        raw_body.assign(ZSTR_VAL(body), length);
         zend_string_release(body);
     }
 }
 
-void Parameter::update_json_str()
+void Parameter::update_json_str() const
 {
-    json_str = "{}";
-    zend_string *body = nullptr;
-    if ((body = fetch_request_body(PHP_STREAM_COPY_ALL)) != nullptr)
+    bool complete = false;
+    const std::string &body = get_raw_body(&complete);
+    JsonValidator validator;
+    //截断的请求体只要求已读部分是合法前缀
+    if (validator.feed(body.data(), body.length()) && (!complete || validator.finish()))
     {
-        if (ZSTR_LEN(body) > 0)
-        {
-            std::string body_str = std::string(ZSTR_VAL(body), ZSTR_LEN(body));
-            JsonReader json_body(body_str);
-            if (!json_body.has_error())
-            {
-                json_str = body_str;
-            }
-        }
-        zend_string_release(body);
+        json_str = body;
     }
 }
 
-void Parameter::update_form_str()
+void Parameter::update_form_str() const
 {
     zval *http_post = fetch_http_globals(TRACK_VARS_POST);
     if (http_post &&
         IS_ARRAY == Z_TYPE_P(http_post) &&
-        zend_hash_num_elements(Z_ARRVAL_P(http_post)) > 0)
+        zend_hash_num_elements(Z_ARRVAL_P(http_post)) > 0 &&
+        max_bytes > 0)
     {
-        form_str = json_encode_from_zval(http_post);
+        FormEncoder encoder(form_str, max_bytes);
+        encoder.encode(http_post);
     }
 }
 
-void Parameter::update_multipart_files()
+void Parameter::update_multipart_files() const
 {
+    if (OpenRASPContentType::ContentType::cMultipartForm != content_type)
+    {
+        return;
+    }
     zval *http_files = fetch_http_globals(TRACK_VARS_FILES);
     if (http_files &&
         IS_ARRAY == Z_TYPE_P(http_files) &&
@@ -220,7 +587,7 @@ void Parameter::update_multipart_files()
     }
 }
 
-void Parameter::recursive_restore_files(std::vector<std::string> &keys, zval *name, zval *tmp_name)
+void Parameter::recursive_restore_files(std::vector<std::string> &keys, zval *name, zval *tmp_name) const
 {
     if (nullptr == name || nullptr == tmp_name || Z_TYPE_P(name) != Z_TYPE_P(tmp_name))
     {
@@ -18,8 +18,11 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <cstdint>
 #include "url.h"
 #include "php_openrasp.h"
+#include "openrasp_content_type.h"
 
 namespace openrasp
 {
@@ -45,30 +48,50 @@ public:
     };
 
 private:
+    enum View
+    {
+        kRawBody = 0,
+        kForm,
+        kJson,
+        kFiles,
+        kMultipart
+    };
+
     /* data */
-    std::string form_str;
-    std::string json_str;
-    std::string body_str;
-    std::string multipart_str;
-    std::map<std::vector<std::string>, MultipartFile> files;
+    OpenRASPContentType::ContentType content_type = OpenRASPContentType::ContentType::cNull;
+    size_t max_bytes = 0;
+    mutable uint32_t resolved = 0;
+    mutable std::string raw_body;
+    mutable bool raw_body_complete = false;
+    mutable std::string form_str;
+    mutable std::string json_str;
+    mutable std::string multipart_str;
+    mutable std::map<std::vector<std::string>, MultipartFile> files;
     bool initialized = false;
 
+    bool begin_resolve(View view) const;
+    void update_raw_body() const;
+    void update_json_str() const;
+    void update_form_str() const;
+    void update_multipart_files() const;
+    void recursive_restore_files(std::vector<std::string> &keys, zval *name, zval *tmp_name) const;
+
 public:
     Parameter(/* args */);
     virtual ~Parameter();
     bool get_initialized() const;
-    void set_initialized(bool initialized);
-    void update_body_str(size_t body_len);
-    void update_json_str();
-    void update_form_str();
-    void update_multipart_files();
-    std::string get_form_str() const;
-    std::string get_json_str() const;
-    std::string get_multipart_str();
-    std::string get_body() const;
+    /**
+     * 只记录 content-type 与 body.maxbytes，body/form/json/multipart 在第一次读取时才生成并缓存到请求结束
+     */
+    void init(OpenRASPContentType::ContentType content_type, size_t max_bytes);
+    //php://input 的前 max_bytes 字节，与 content-type 无关；complete 表示没有被截断，max_bytes 为 0 时总是 false
+    const std::string &get_raw_body(bool *complete = nullptr) const;
+    const std::string &get_form_str() const;
+    const std::string &get_json_str() const;
+    const std::string &get_multipart_str() const;
+    const std::string &get_body() const;
     bool fetch_fileinfo_by_tmpname(const std::string &tmpname, std::string &name, std::string &filename) const;
     void clear();
-    void recursive_restore_files(std::vector<std::string> &keys, zval *name, zval *tmp_name);
 };
 } // namespace request
 
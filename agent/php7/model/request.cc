@@ -16,9 +16,11 @@
 
 #include "request.h"
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstdio>
+#include <cctype>
+#include <algorithm>
 #include "openrasp_content_type.h"
+#include "openrasp_utils.h"
 
 namespace openrasp
 {
@@ -26,77 +28,164 @@ namespace request
 {
 Request::Request(/* args */)
 {
+    ZVAL_UNDEF(&server);
 }
 
 Request::~Request()
 {
 }
 
-void Request::update_id()
+void Request::set_server(zval *server)
 {
-    auto time_point = std::chrono::steady_clock::now();
-    long long nano = time_point.time_since_epoch().count();
-    std::size_t hash = std::hash<std::string>{}(std::to_string(nano));
-    std::ostringstream oss;
-    oss << std::hex;
-    oss << std::setfill('0') << std::setw(16) << hash;
-    oss << std::setfill('0') << std::setw(16) << nano;
-    this->id = oss.str();
-}
-
-std::string Request::get_id() const
-{
-    return id;
+    clear();
+    if (nullptr != server && Z_TYPE_P(server) == IS_ARRAY)
+    {
+        ZVAL_COPY(&this->server, server);
+        url.set_server(&this->server);
+    }
 }
 
-void Request::set_method(const std::string &method)
+bool Request::begin_resolve(Field field) const
 {
-    std::string lower_method = method;
-    std::transform(lower_method.begin(), lower_method.end(), lower_method.begin(), ::tolower);
-    this->method = lower_method;
+    uint32_t bit = 1u << field;
+    if (resolved & bit)
+    {
+        return false;
+    }
+    resolved |= bit;
+    return true;
 }
 
-std::string Request::get_method() const
+zval *Request::find_server(const char *key, size_t len) const
 {
-    return method;
+    if (Z_TYPE(server) != IS_ARRAY)
+    {
+        return nullptr;
+    }
+    zval *origin_zv = zend_hash_str_find(Z_ARRVAL(server), key, len);
+    if (nullptr != origin_zv && Z_TYPE_P(origin_zv) == IS_STRING)
+    {
+        return origin_zv;
+    }
+    return nullptr;
 }
 
-void Request::set_remote_addr(const std::string &remote_addr)
+const std::string &Request::resolve_string(Field field, const char *key, std::string &value) const
 {
-    this->remote_addr = remote_addr;
+    if (begin_resolve(field))
+    {
+        zval *origin_zv = find_server(key, strlen(key));
+        if (nullptr != origin_zv)
+        {
+            value.assign(Z_STRVAL_P(origin_zv), Z_STRLEN_P(origin_zv));
+        }
+    }
+    return value;
 }
 
-std::string Request::get_remote_addr() const
+const std::string &Request::get_id() const
 {
-    return remote_addr;
+    if (begin_resolve(kId))
+    {
+        auto time_point = std::chrono::steady_clock::now();
+        long long nano = time_point.time_since_epoch().count();
+        std::size_t hash = std::hash<std::string>{}(std::to_string(nano));
+        char buf[33];
+        snprintf(buf, sizeof(buf), "%016llx%016llx", static_cast<unsigned long long>(hash), static_cast<unsigned long long>(nano));
+        id.assign(buf);
+    }
+    return id;
 }
 
-void Request::set_document_root(const std::string &document_root)
+const std::string &Request::get_method() const
 {
-    this->document_root = document_root;
+    if (begin_resolve(kMethod))
+    {
+        zval *origin_zv = find_server(ZEND_STRL("REQUEST_METHOD"));
+        if (nullptr != origin_zv)
+        {
+            method.assign(Z_STRVAL_P(origin_zv), Z_STRLEN_P(origin_zv));
+            std::transform(method.begin(), method.end(), method.begin(), ::tolower);
+        }
+    }
+    return method;
 }
 
-std::string Request::get_document_root() const
+const std::string &Request::get_remote_addr() const
 {
-    return document_root;
+    return resolve_string(kRemoteAddr, "REMOTE_ADDR", remote_addr);
 }
 
-void Request::set_header(const std::map<std::string, std::string> &header)
+const std::string &Request::get_document_root() const
 {
-    this->header = header;
+    return resolve_string(kDocumentRoot, "DOCUMENT_ROOT", document_root);
 }
 
-std::map<std::string, std::string> Request::get_header() const
+const std::map<std::string, std::string> &Request::get_header() const
 {
+    if (begin_resolve(kHeader) && Z_TYPE(server) == IS_ARRAY)
+    {
+        zval *value = nullptr;
+        zend_string *key = nullptr;
+        ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL(server), key, value)
+        {
+            if (nullptr == key || Z_TYPE_P(value) != IS_STRING)
+            {
+                continue;
+            }
+            std::string header_key = convert_to_header_key(ZSTR_VAL(key), ZSTR_LEN(key));
+            if (!header_key.empty())
+            {
+                header[header_key] = std::string(Z_STRVAL_P(value), Z_STRLEN_P(value));
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
     return header;
 }
 
 std::string Request::get_header(const std::string &key) const
 {
-    auto found = header.find(key);
-    if (found != header.end())
+    if (resolved & (1u << kHeader))
+    {
+        auto found = header.find(key);
+        if (found != header.end())
+        {
+            return found->second;
+        }
+        return "";
+    }
+    zval *origin_zv = nullptr;
+    if ("content-type" == key)
+    {
+        origin_zv = find_server(ZEND_STRL("CONTENT_TYPE"));
+        if (nullptr == origin_zv)
+        {
+            origin_zv = find_server(ZEND_STRL("HTTP_CONTENT_TYPE"));
+        }
+    }
+    else if ("content-length" == key)
+    {
+        origin_zv = find_server(ZEND_STRL("CONTENT_LENGTH"));
+        if (nullptr == origin_zv)
+        {
+            origin_zv = find_server(ZEND_STRL("HTTP_CONTENT_LENGTH"));
+        }
+    }
+    else
     {
-        return found->second;
+        //与 convert_to_header_key 相反：content-md5 -> HTTP_CONTENT_MD5
+        std::string server_key("HTTP_");
+        server_key.reserve(5 + key.length());
+        for (char ch : key)
+        {
+            server_key.push_back(ch == '-' ? '_' : static_cast<char>(std::toupper(ch)));
+        }
+        origin_zv = find_server(server_key.c_str(), server_key.length());
+    }
+    if (nullptr != origin_zv)
+    {
+        return std::string(Z_STRVAL_P(origin_zv), Z_STRLEN_P(origin_zv));
     }
     return "";
 }
@@ -111,31 +200,25 @@ Parameter &Request::get_parameter()
     if (!parameter.get_initialized())
     {
         std::string content_type = get_header("content-type");
-        OpenRASPContentType::ContentType k_type = OpenRASPContentType::classify_content_type(content_type);
-        switch (k_type)
-        {
-        case OpenRASPContentType::ContentType::cApplicationJson:
-            parameter.update_json_str();
-            break;
-        case OpenRASPContentType::ContentType::cApplicationForm:
-            parameter.update_form_str();
-            break;
-        case OpenRASPContentType::ContentType::cMultipartForm:
-            parameter.update_form_str();
-            parameter.update_multipart_files();
-            break;
-        default:
-            parameter.update_body_str(body_len);
-            break;
-        }
-        parameter.set_initialized(true);
+        parameter.init(OpenRASPContentType::classify_content_type(content_type), body_len);
     }
     return parameter;
 }
 
+RiskProfile &Request::get_risk_profile()
+{
+    return risk_profile;
+}
+
 void Request::clear()
 {
     body_len = 0;
+    if (Z_TYPE(server) != IS_UNDEF)
+    {
+        zval_ptr_dtor(&server);
+        ZVAL_UNDEF(&server);
+    }
+    resolved = 0;
     id.clear();
     method.clear();
     remote_addr.clear();
@@ -143,6 +226,7 @@ void Request::clear()
     header.clear();
     url.clear();
     parameter.clear();
+    risk_profile.clear();
 }
 } // namespace request
 
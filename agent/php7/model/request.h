@@ -18,45 +18,65 @@
 
 #include <string>
 #include <map>
+#include <cstdint>
 #include "url.h"
 #include "parameter.h"
+#include "risk_profile.h"
 
 namespace openrasp
 {
 namespace request
 {
+/**
+ * RINIT 只持有 $_SERVER 数组的引用（脚本修改 $_SERVER 时会先分离，不影响这里看到的值）
+ * 各字段与 header 表在第一次访问时才读取并缓存，访问器返回引用，请求结束时释放
+ */
 class Request
 {
 private:
+    enum Field
+    {
+        kId = 0,
+        kMethod,
+        kRemoteAddr,
+        kDocumentRoot,
+        kHeader
+    };
+
     /* data */
-    std::string id;
-    std::string method;
-    std::string remote_addr;
-    std::string document_root;
-    std::map<std::string, std::string> header;
-    size_t body_len;
+    zval server;
+    mutable uint32_t resolved = 0;
+    mutable std::string id;
+    mutable std::string method;
+    mutable std::string remote_addr;
+    mutable std::string document_root;
+    mutable std::map<std::string, std::string> header;
+    size_t body_len = 0;
 
     Parameter parameter;
+    RiskProfile risk_profile;
+
+    bool begin_resolve(Field field) const;
+    const std::string &resolve_string(Field field, const char *key, std::string &value) const;
+    zval *find_server(const char *key, size_t len) const;
 
 public:
     Url url;
 
     Request(/* args */);
     virtual ~Request();
-    void update_id();
-    std::string get_id() const;
-    void set_method(const std::string &method);
-    std::string get_method() const;
-    void set_remote_addr(const std::string &remote_addr);
-    std::string get_remote_addr() const;
-    void set_document_root(const std::string &document_root);
-    std::string get_document_root() const;
-    void set_header(const std::map<std::string, std::string> &header);
-    std::map<std::string, std::string> get_header() const;
+    void set_server(zval *server);
+    const std::string &get_id() const;
+    const std::string &get_method() const;
+    const std::string &get_remote_addr() const;
+    const std::string &get_document_root() const;
+    const std::map<std::string, std::string> &get_header() const;
+    //key 为小写、以 - 分隔的 header 名，直接在 $_SERVER 中查找，不构建 header 表
     std::string get_header(const std::string &key) const;
     void set_body_length(size_t body_len);
 
     Parameter &get_parameter();
+    RiskProfile &get_risk_profile();
 
     void clear();
 };
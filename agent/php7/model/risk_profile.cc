@@ -0,0 +1,189 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "risk_profile.h"
+#include <algorithm>
+
+namespace openrasp
+{
+namespace request
+{
+const int RiskProfile::max_depth = 8;
+
+namespace
+{
+class MetaTable
+{
+private:
+    uint8_t classes[256] = {0};
+
+    void add(const std::string &chars, uint8_t meta)
+    {
+        for (unsigned char c : chars)
+        {
+            classes[c] |= meta;
+        }
+    }
+
+public:
+    MetaTable()
+    {
+        add("'\"`;#-/*\\", RiskProfile::kSqlMeta);
+        add(";|&`$()<>\n\r", RiskProfile::kShellMeta);
+        add(std::string("./\\:%\0", 6), RiskProfile::kPathMeta);
+        add("<>\"'", RiskProfile::kHtmlMeta);
+    }
+
+    uint8_t get(unsigned char c) const
+    {
+        return classes[c];
+    }
+};
+} // namespace
+
+void RiskProfile::update_string(const char *str, size_t len)
+{
+    static const MetaTable meta_table;
+    ++input_count;
+    input_bytes += len;
+    max_input_length = std::max(max_input_length, len);
+    if (meta_classes == kAllMeta)
+    {
+        return;
+    }
+    uint8_t found = 0;
+    for (size_t i = 0; i < len; ++i)
+    {
+        found |= meta_table.get(str[i]);
+    }
+    meta_classes |= found;
+}
+
+void RiskProfile::update(zval *value, int depth)
+{
+    if (nullptr == value)
+    {
+        return;
+    }
+    ZVAL_DEREF(value);
+    if (Z_TYPE_P(value) == IS_STRING)
+    {
+        update_string(Z_STRVAL_P(value), Z_STRLEN_P(value));
+    }
+    else if (Z_TYPE_P(value) == IS_ARRAY)
+    {
+        if (depth >= max_depth)
+        {
+            ++input_count;
+            meta_classes = kAllMeta;
+            return;
+        }
+        zend_string *key = nullptr;
+        zval *item = nullptr;
+        ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(value), key, item)
+        {
+            if (depth > 0 && key)
+            {
+                update_string(ZSTR_VAL(key), ZSTR_LEN(key));
+            }
+            update(item, depth + 1);
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+}
+
+void RiskProfile::update_body(size_t body_len)
+{
+    if (body_len > 0)
+    {
+        ++input_count;
+        input_bytes += body_len;
+        max_input_length = std::max(max_input_length, body_len);
+        meta_classes = kAllMeta;
+    }
+}
+
+void RiskProfile::set_bypass(bool bypass)
+{
+    this->bypass = bypass;
+}
+
+bool RiskProfile::is_bypass() const
+{
+    return bypass;
+}
+
+bool RiskProfile::has_input() const
+{
+    return input_count > 0;
+}
+
+size_t RiskProfile::get_input_count() const
+{
+    return input_count;
+}
+
+size_t RiskProfile::get_input_bytes() const
+{
+    return input_bytes;
+}
+
+size_t RiskProfile::get_max_input_length() const
+{
+    return max_input_length;
+}
+
+bool RiskProfile::may_contain(MetaClass meta) const
+{
+    return (meta_classes & meta) != 0;
+}
+
+std::string RiskProfile::to_string() const
+{
+    static const std::pair<MetaClass, const char *> names[] = {{kSqlMeta, "sql"},
+                                                               {kShellMeta, "shell"},
+                                                               {kPathMeta, "path"},
+                                                               {kHtmlMeta, "html"}};
+    std::string meta;
+    for (const auto &name : names)
+    {
+        if (may_contain(name.first))
+        {
+            if (!meta.empty())
+            {
+                meta.push_back('|');
+            }
+            meta.append(name.second);
+        }
+    }
+    return "input_count=" + std::to_string(input_count) +
+           " input_bytes=" + std::to_string(input_bytes) +
+           " max_input_length=" + std::to_string(max_input_length) +
+           " meta=" + (meta.empty() ? "none" : meta) +
+           " bypass=" + (bypass ? "true" : "false");
+}
+
+void RiskProfile::clear()
+{
+    input_count = 0;
+    input_bytes = 0;
+    max_input_length = 0;
+    meta_classes = 0;
+    bypass = false;
+}
+} // namespace request
+
+} // namespace openrasp
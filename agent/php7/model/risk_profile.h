@@ -0,0 +1,69 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include "php_openrasp.h"
+
+namespace openrasp
+{
+namespace request
+{
+/**
+ * RINIT 时对请求输入做的一次廉价统计，用于跳过不可能命中的输入关联检测
+ */
+class RiskProfile
+{
+public:
+    enum MetaClass
+    {
+        kSqlMeta = 1 << 0,
+        kShellMeta = 1 << 1,
+        kPathMeta = 1 << 2,
+        kHtmlMeta = 1 << 3,
+        kAllMeta = kSqlMeta | kShellMeta | kPathMeta | kHtmlMeta
+    };
+
+private:
+    /* data */
+    size_t input_count = 0;
+    size_t input_bytes = 0;
+    size_t max_input_length = 0;
+    uint32_t meta_classes = 0;
+    bool bypass = false;
+
+    void update_string(const char *str, size_t len);
+
+public:
+    static const int max_depth;
+
+    void update(zval *value, int depth = 0);
+    void update_body(size_t body_len);
+    void set_bypass(bool bypass);
+    bool is_bypass() const;
+    bool has_input() const;
+    size_t get_input_count() const;
+    size_t get_input_bytes() const;
+    size_t get_max_input_length() const;
+    bool may_contain(MetaClass meta) const;
+    std::string to_string() const;
+    void clear();
+};
+} // namespace request
+
+} // namespace openrasp
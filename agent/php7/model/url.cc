@@ -28,143 +28,144 @@ Url::~Url()
 {
 }
 
-void Url::set_request_scheme(const std::string &request_scheme)
+void Url::set_server(const zval *server)
 {
-    this->request_scheme = !request_scheme.empty() ? request_scheme : "http";
-}
-
-void Url::set_http_host(const std::string &http_host)
-{
-    this->http_host = http_host;
-}
-
-void Url::set_server_name(const std::string &server_name)
-{
-    this->server_name = server_name;
-}
-
-void Url::set_server_addr(const std::string &server_addr)
-{
-    this->server_addr = server_addr;
-}
-
-void Url::set_request_uri(const std::string &request_uri)
-{
-    this->request_uri = request_uri;
-}
-
-void Url::set_query_string(const std::string &query_string)
-{
-    this->query_string = query_string;
-}
-
-void Url::set_port(const std::string &server_port)
-{
-    if (!server_port.empty())
-    {
-        this->port = std::stoi(server_port);
-    }
-    else
-    {
-        this->port = 80;
-    }
+    clear();
+    this->server = server;
 }
 
 void Url::clear()
 {
+    server = nullptr;
+    resolved = 0;
     request_scheme.clear();
     http_host.clear();
     server_name.clear();
     server_addr.clear();
     request_uri.clear();
     query_string.clear();
+    complete_url.clear();
+    path.clear();
+    real_host.clear();
     port = 0;
 }
 
-std::string Url::get_request_scheme() const
+bool Url::begin_resolve(Field field) const
+{
+    uint32_t bit = 1u << field;
+    if (resolved & bit)
+    {
+        return false;
+    }
+    resolved |= bit;
+    return true;
+}
+
+const std::string &Url::resolve_string(Field field, const char *key, std::string &value) const
 {
-    return request_scheme;
+    if (begin_resolve(field) && nullptr != server && Z_TYPE_P(server) == IS_ARRAY)
+    {
+        zval *origin_zv = zend_hash_str_find(Z_ARRVAL_P(server), key, strlen(key));
+        if (nullptr != origin_zv && Z_TYPE_P(origin_zv) == IS_STRING)
+        {
+            value.assign(Z_STRVAL_P(origin_zv), Z_STRLEN_P(origin_zv));
+        }
+        if (kRequestScheme == field && value.empty())
+        {
+            value = "http";
+        }
+    }
+    return value;
 }
 
-std::string Url::get_http_host() const
+const std::string &Url::get_request_scheme() const
 {
-    return http_host;
+    return resolve_string(kRequestScheme, "REQUEST_SCHEME", request_scheme);
 }
 
-std::string Url::get_server_name() const
+const std::string &Url::get_http_host() const
 {
-    return server_name;
+    return resolve_string(kHttpHost, "HTTP_HOST", http_host);
 }
 
-std::string Url::get_server_addr() const
+const std::string &Url::get_server_name() const
 {
-    return server_addr;
+    return resolve_string(kServerName, "SERVER_NAME", server_name);
 }
 
-std::string Url::get_request_uri() const
+const std::string &Url::get_server_addr() const
 {
-    return request_uri;
+    return resolve_string(kServerAddr, "SERVER_ADDR", server_addr);
 }
 
-std::string Url::get_query_string() const
+const std::string &Url::get_request_uri() const
 {
-    return query_string;
+    return resolve_string(kRequestUri, "REQUEST_URI", request_uri);
 }
 
-int Url::get_port() const
+const std::string &Url::get_query_string() const
 {
-    return port;
+    return resolve_string(kQueryString, "QUERY_STRING", query_string);
 }
 
-std::string Url::get_complete_url() const
+int Url::get_port() const
 {
-    std::string complete_url;
-    complete_url.append(request_scheme).append("://");
-    if (!http_host.empty())
-    {
-        complete_url.append(http_host);
-    }
-    else
+    if (begin_resolve(kPort) && nullptr != server && Z_TYPE_P(server) == IS_ARRAY)
     {
-        complete_url.append((!server_name.empty() ? server_name : server_addr));
-        if (80 != port)
+        zval *origin_zv = zend_hash_str_find(Z_ARRVAL_P(server), ZEND_STRL("SERVER_PORT"));
+        if (nullptr != origin_zv && Z_TYPE_P(origin_zv) == IS_STRING && Z_STRLEN_P(origin_zv) > 0)
         {
-            complete_url.append(":").append(std::to_string(port));
+            port = static_cast<int>(strtol(Z_STRVAL_P(origin_zv), nullptr, 10));
+        }
+        else
+        {
+            port = 80;
         }
     }
-    complete_url.append(request_uri);
-    return complete_url;
+    return port;
 }
 
-std::string Url::get_real_host() const
+const std::string &Url::get_complete_url() const
 {
-    std::string real_host;
-    if (!http_host.empty())
+    if (begin_resolve(kCompleteUrl))
     {
-        real_host.append(http_host);
+        complete_url.append(get_request_scheme()).append("://");
+        complete_url.append(get_real_host());
+        complete_url.append(get_request_uri());
     }
-    else
+    return complete_url;
+}
+
+const std::string &Url::get_real_host() const
+{
+    if (begin_resolve(kRealHost))
     {
-        real_host.append((!server_name.empty() ? server_name : server_addr));
-        if (80 != port)
+        const std::string &http_host = get_http_host();
+        if (!http_host.empty())
+        {
+            real_host.append(http_host);
+        }
+        else
         {
-            real_host.append(":").append(std::to_string(port));
+            const std::string &server_name = get_server_name();
+            real_host.append((!server_name.empty() ? server_name : get_server_addr()));
+            if (80 != get_port())
+            {
+                real_host.append(":").append(std::to_string(get_port()));
+            }
         }
     }
     return real_host;
 }
 
-std::string Url::get_path() const
+const std::string &Url::get_path() const
 {
-    auto found = request_uri.find("?");
-    if (found != std::string::npos)
-    {
-        return request_uri.substr(0, found);
-    }
-    else
+    if (begin_resolve(kPath))
     {
-        return request_uri;
+        const std::string &uri = get_request_uri();
+        path.assign(uri, 0, uri.find('?'));
     }
+    return path;
 }
 } // namespace request
 
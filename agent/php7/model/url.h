@@ -17,45 +17,66 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
+#include "php_openrasp.h"
 
 namespace openrasp
 {
 namespace request
 {
+/**
+ * 请求 URL 的各字段在第一次访问时才从 $_SERVER 中读取并缓存，$_SERVER 数组由 Request 持有引用
+ */
 class Url
 {
 private:
+    enum Field
+    {
+        kRequestScheme = 0,
+        kHttpHost,
+        kServerName,
+        kServerAddr,
+        kRequestUri,
+        kQueryString,
+        kPort,
+        kCompleteUrl,
+        kPath,
+        kRealHost
+    };
+
     /* data */
-    std::string request_scheme;
-    std::string http_host;
-    std::string server_name;
-    std::string server_addr;
-    std::string request_uri;
-    std::string query_string;
-    int port;
+    const zval *server = nullptr;
+    mutable uint32_t resolved = 0;
+    mutable std::string request_scheme;
+    mutable std::string http_host;
+    mutable std::string server_name;
+    mutable std::string server_addr;
+    mutable std::string request_uri;
+    mutable std::string query_string;
+    mutable std::string complete_url;
+    mutable std::string path;
+    mutable std::string real_host;
+    mutable int port = 0;
+
+    bool begin_resolve(Field field) const;
+    const std::string &resolve_string(Field field, const char *key, std::string &value) const;
 
 public:
     Url(/* args */);
     virtual ~Url();
 
-    void set_request_scheme(const std::string &request_scheme);
-    void set_http_host(const std::string &http_host);
-    void set_server_name(const std::string &server_name);
-    void set_server_addr(const std::string &server_addr);
-    void set_request_uri(const std::string &request_uri);
-    void set_query_string(const std::string &query_string);
-    void set_port(const std::string &server_port);
+    void set_server(const zval *server);
     void clear();
 
-    std::string get_request_scheme() const;
-    std::string get_http_host() const;
-    std::string get_server_name() const;
-    std::string get_server_addr() const;
-    std::string get_request_uri() const;
-    std::string get_query_string() const;
-    std::string get_complete_url() const;
-    std::string get_path() const;
-    std::string get_real_host() const;
+    const std::string &get_request_scheme() const;
+    const std::string &get_http_host() const;
+    const std::string &get_server_name() const;
+    const std::string &get_server_addr() const;
+    const std::string &get_request_uri() const;
+    const std::string &get_query_string() const;
+    const std::string &get_complete_url() const;
+    const std::string &get_path() const;
+    const std::string &get_real_host() const;
     int get_port() const;
 };
 } // namespace request
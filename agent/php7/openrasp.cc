@@ -16,8 +16,11 @@
 
 #include "utils/json_reader.h"
 #include "utils/yaml_reader.h"
+#include "utils/config_image.h"
 #include "utils/file.h"
 #include "utils/string.h"
+#include "utils/regex.h"
+#include "utils/string_kernel.h"
 #include "openrasp.h"
 #include "openrasp_ini.h"
 #include "hook/checker/v8_detector.h"
@@ -39,12 +42,23 @@ extern "C"
 #include "openrasp_inject.h"
 #include "openrasp_security_policy.h"
 #include "openrasp_output_detect.h"
+#include "openrasp_taint.h"
+#include "openrasp_compile.h"
 #include "openrasp_check_type.h"
 #ifdef HAVE_FSWATCH
 #include "openrasp_fswatch.h"
 #endif
 #include <new>
+#include <atomic>
+#include <chrono>
+#ifndef PHP_WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#endif
 #include "agent/shared_config_manager.h"
+#include "agent/shared_dns_manager.h"
 #ifdef HAVE_OPENRASP_REMOTE_MANAGER
 #include "agent/openrasp_agent_manager.h"
 #endif
@@ -59,6 +73,7 @@ bool remote_active = false;
 std::string openrasp_status = "Protected";
 static std::string get_complete_config_content(ConfigHolder::FromType type);
 static void hook_without_params(OpenRASPCheckType check_type);
+static void adopt_local_reload();
 
 PHP_INI_BEGIN()
 PHP_INI_ENTRY1("openrasp.root_dir", "", PHP_INI_SYSTEM, OnUpdateOpenraspCString, &openrasp_ini.root_dir)
@@ -73,6 +88,7 @@ PHP_INI_ENTRY1("openrasp.remote_management_enable", "off", PHP_INI_SYSTEM, OnUpd
 PHP_INI_ENTRY1("openrasp.heartbeat_interval", "180", PHP_INI_SYSTEM, OnUpdateOpenraspHeartbeatInterval, &openrasp_ini.heartbeat_interval)
 PHP_INI_ENTRY1("openrasp.ssl_verifypeer", "off", PHP_INI_SYSTEM, OnUpdateOpenraspBool, &openrasp_ini.ssl_verifypeer)
 PHP_INI_ENTRY1("openrasp.iast_enable", "off", PHP_INI_SYSTEM, OnUpdateOpenraspBool, &openrasp_ini.iast_enable)
+PHP_INI_ENTRY1("openrasp.taint_enable", "off", PHP_INI_SYSTEM, OnUpdateOpenraspBool, &openrasp_ini.taint_enable)
 PHP_INI_END()
 
 PHP_GINIT_FUNCTION(openrasp)
@@ -130,6 +146,15 @@ PHP_MINIT_FUNCTION(openrasp)
         openrasp_status = "Unprotected (shared memory application failed)";
         return SUCCESS;
     }
+    if (need_alloc_shm_current_sapi())
+    {
+        openrasp::sdm.reset(new openrasp::SharedDnsManager());
+        if (!openrasp::sdm->startup())
+        {
+            openrasp_error(LEVEL_WARNING, RUNTIME_ERROR, _("Fail to startup SharedDnsManager, dns cache is disabled."));
+            openrasp::sdm.reset();
+        }
+    }
 
 #ifdef HAVE_OPENRASP_REMOTE_MANAGER
     if (need_alloc_shm_current_sapi() && openrasp_ini.remote_management_enable)
@@ -183,6 +208,8 @@ PHP_MINIT_FUNCTION(openrasp)
     }
     int result;
     result = PHP_MINIT(openrasp_hook)(INIT_FUNC_ARGS_PASSTHRU);
+    result = PHP_MINIT(openrasp_taint)(INIT_FUNC_ARGS_PASSTHRU);
+    result = PHP_MINIT(openrasp_compile)(INIT_FUNC_ARGS_PASSTHRU);
     result = PHP_MINIT(openrasp_inject)(INIT_FUNC_ARGS_PASSTHRU);
 
 #ifdef HAVE_OPENRASP_REMOTE_MANAGER
@@ -224,6 +251,8 @@ PHP_MSHUTDOWN_FUNCTION(openrasp)
 #endif
         }
         result = PHP_MSHUTDOWN(openrasp_inject)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
+        result = PHP_MSHUTDOWN(openrasp_compile)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
+        result = PHP_MSHUTDOWN(openrasp_taint)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
         result = PHP_MSHUTDOWN(openrasp_hook)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
         result = PHP_MSHUTDOWN(openrasp_v8)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
         result = PHP_MSHUTDOWN(openrasp_log)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
@@ -235,6 +264,11 @@ PHP_MSHUTDOWN_FUNCTION(openrasp)
         }
         openrasp::oam.reset();
 #endif
+        if (openrasp::sdm != nullptr)
+        {
+            openrasp::sdm->shutdown();
+            openrasp::sdm.reset();
+        }
         openrasp::scm->shutdown();
         openrasp::scm.reset();
         remote_active = false;
@@ -250,52 +284,48 @@ PHP_RINIT_FUNCTION(openrasp)
 {
     if (is_initialized)
     {
-        zval *http_server = fetch_http_globals(TRACK_VARS_SERVER);
-        OPENRASP_G(request).update_id();
-        if (nullptr != http_server && Z_TYPE_P(http_server) == IS_ARRAY)
+        //只持有 $_SERVER 的引用，请求字段在第一次访问时才读取
+        OPENRASP_G(request).set_server(fetch_http_globals(TRACK_VARS_SERVER));
+        int result;
+        if (!remote_active)
         {
-            OPENRASP_G(request).url.set_request_scheme(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "REQUEST_SCHEME"));
-            OPENRASP_G(request).url.set_http_host(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "HTTP_HOST"));
-            OPENRASP_G(request).url.set_server_name(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "SERVER_NAME"));
-            OPENRASP_G(request).url.set_server_addr(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "SERVER_ADDR"));
-            OPENRASP_G(request).url.set_request_uri(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "REQUEST_URI"));
-            OPENRASP_G(request).url.set_query_string(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "QUERY_STRING"));
-            OPENRASP_G(request).url.set_port(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "SERVER_PORT"));
-
-            OPENRASP_G(request).set_method(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "REQUEST_METHOD"));
-            OPENRASP_G(request).set_remote_addr(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "REMOTE_ADDR"));
-            OPENRASP_G(request).set_document_root(fetch_outmost_string_from_ht(Z_ARRVAL_P(http_server), "DOCUMENT_ROOT"));
-
-            std::map<std::string, std::string> header;
-            zval *value = nullptr;
-            zend_string *key = nullptr;
-            ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(http_server), key, value)
-            {
-                std::string header_key = convert_to_header_key(ZSTR_VAL(key), ZSTR_LEN(key));
-                if (!header_key.empty() && Z_TYPE_P(value) == IS_STRING)
-                {
-                    header[header_key] = std::string(Z_STRVAL_P(value), Z_STRLEN_P(value));
-                }
-            }
-            ZEND_HASH_FOREACH_END();
-            OPENRASP_G(request).set_header(header);
+            adopt_local_reload();
         }
-        int result;
         long config_last_update = openrasp::scm->get_config_last_update();
         if (config_last_update && config_last_update > OPENRASP_G(config).GetLatestUpdateTime())
         {
-            openrasp::JsonReader json_reader(get_complete_config_content(ConfigHolder::FromType::kJson));
-            if (OPENRASP_G(config).update(&json_reader))
+            std::string config_image = openrasp::scm->get_config_image();
+            openrasp::ConfigImageReader image_reader(config_image.data(), config_image.size());
+            if (!image_reader.has_error() && image_reader.version() == config_last_update)
             {
+                OPENRASP_G(config).update(&image_reader);
                 OPENRASP_G(config).SetLatestUpdateTime(config_last_update);
             }
+            else if (remote_active)
+            {
+                openrasp::JsonReader json_reader(get_complete_config_content(ConfigHolder::FromType::kJson));
+                if (OPENRASP_G(config).update(&json_reader))
+                {
+                    OPENRASP_G(config).SetLatestUpdateTime(config_last_update);
+                }
+            }
+            else
+            {
+                openrasp::YamlReader yaml_reader(get_complete_config_content(ConfigHolder::FromType::kYaml));
+                if (OPENRASP_G(config).update(&yaml_reader))
+                {
+                    OPENRASP_G(config).SetLatestUpdateTime(config_last_update);
+                }
+            }
         }
         OPENRASP_G(request).set_body_length(OPENRASP_CONFIG(body.maxbytes));
+        openrasp::regex_set_timing(openrasp::scm->get_debug_level() != 0);
         // openrasp_inject must be called before openrasp_log cuz of request_id
         result = PHP_RINIT(openrasp_inject)(INIT_FUNC_ARGS_PASSTHRU);
         result = PHP_RINIT(openrasp_log)(INIT_FUNC_ARGS_PASSTHRU);
         openrasp::general_signal_hook();
         result = PHP_RINIT(openrasp_hook)(INIT_FUNC_ARGS_PASSTHRU);
+        result = PHP_RINIT(openrasp_taint)(INIT_FUNC_ARGS_PASSTHRU);
         result = PHP_RINIT(openrasp_v8)(INIT_FUNC_ARGS_PASSTHRU);
         result = PHP_RINIT(openrasp_output_detect)(INIT_FUNC_ARGS_PASSTHRU);
 #ifdef HAVE_OPENRASP_REMOTE_MANAGER
@@ -326,6 +356,8 @@ PHP_RSHUTDOWN_FUNCTION(openrasp)
         int result;
         hook_without_params(REQUEST_END);
         result = PHP_RSHUTDOWN(openrasp_hook)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
+        result = PHP_RSHUTDOWN(openrasp_taint)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
+        result = PHP_RSHUTDOWN(openrasp_compile)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
         result = PHP_RSHUTDOWN(openrasp_log)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
         result = PHP_RSHUTDOWN(openrasp_inject)(SHUTDOWN_FUNC_ARGS_PASSTHRU);
         OPENRASP_G(request).clear();
@@ -347,6 +379,8 @@ PHP_MINFO_FUNCTION(openrasp)
     php_info_print_table_row(2, "Commit Id", "");
 #endif
     php_info_print_table_row(2, "V8 Version", ZEND_TOSTR(V8_MAJOR_VERSION) "." ZEND_TOSTR(V8_MINOR_VERSION));
+    php_info_print_table_row(2, "Regex Registry", openrasp::regex_stats_to_string().c_str());
+    php_info_print_table_row(2, "String Kernels", openrasp::kernel::implementation());
 #ifdef HAVE_OPENRASP_REMOTE_MANAGER
     if (remote_active && openrasp::oam)
     {
@@ -405,6 +439,126 @@ static std::string get_complete_config_content(ConfigHolder::FromType type)
     return conf_content;
 }
 
+/**
+ * 本地模式下重新读取 openrasp.yml，与云控一样发布配置镜像，解析失败时保留当前配置
+ */
+static bool reload_local_config(int64_t timestamp)
+{
+    openrasp::YamlReader yaml_reader(get_complete_config_content(ConfigHolder::FromType::kYaml));
+    yaml_reader.set_exception_report(true);
+    if (yaml_reader.has_error())
+    {
+        openrasp_error(LEVEL_WARNING, CONFIG_ERROR, _("Fail to reload config, cuz of %s, keep the previous one."),
+                       yaml_reader.get_error_msg().c_str());
+        return false;
+    }
+    openrasp::scm->set_debug_level(&yaml_reader);
+    openrasp::scm->build_check_type_white_array(&yaml_reader);
+    openrasp::scm->build_weak_password_array(&yaml_reader);
+    openrasp::ConfigImageWriter image_writer(&yaml_reader);
+    ConfigHolder validated;
+    validated.update(&image_writer);
+    return openrasp::scm->publish_config(timestamp, image_writer.build(timestamp));
+}
+
+/**
+ * 构建已领取的请求，构建期间又有新请求时继续领取，直到没有待处理的请求
+ */
+static void build_local_reload(uint64_t requested)
+{
+    do
+    {
+        auto duration = std::chrono::system_clock::now().time_since_epoch();
+        int64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+        bool plugins_reloaded = false;
+        try
+        {
+            reload_local_config(timestamp);
+            plugins_reloaded = openrasp::rebuild_snapshot(timestamp);
+        }
+        catch (std::exception &e)
+        {
+            openrasp_error(LEVEL_WARNING, RUNTIME_ERROR, _("Fail to reload plugins and config: %s"), e.what());
+        }
+        catch (...)
+        {
+            openrasp_error(LEVEL_WARNING, RUNTIME_ERROR, _("Fail to reload plugins and config: unknown error"));
+        }
+        //失败时同样释放领取，下一次文件变化可以重新构建
+        openrasp::scm->finish_reload(requested, plugins_reloaded ? timestamp : 0);
+        openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Reloaded plugins and config in process %d, request %" PRIu64 "."),
+                       getpid(), requested);
+        requested = openrasp::scm->get_reload_requested();
+    } while (requested > openrasp::scm->get_reload_done() &&
+             openrasp::scm->try_begin_reload(requested));
+}
+
+/**
+ * 由主进程的 fswatch 线程调用，只负责领取请求；主进程随时会 fork 工作进程，它的线程上不能运行 V8，
+ * 因此与云控的 agent 进程一样在单独的进程中构建。构建进程经两次 fork 脱离主进程，
+ * SAPI 主进程回收子进程时不会遇到它；构建进程异常退出时，领取在超时后由下一次文件变化接替
+ */
+void openrasp_reload_local()
+{
+    uint64_t requested = openrasp::scm->get_reload_requested();
+    if (requested <= openrasp::scm->get_reload_done() ||
+        !openrasp::scm->try_begin_reload(requested))
+    {
+        return;
+    }
+#ifdef PHP_WIN32
+    //Windows 下工作进程不由主进程 fork 产生
+    build_local_reload(requested);
+#else
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        pid_t builder = fork();
+        if (builder == 0)
+        {
+            int fd = 0;
+            if (-1 != (fd = open("/dev/null", O_RDWR)))
+            {
+                dup2(fd, STDIN_FILENO);
+                dup2(fd, STDOUT_FILENO);
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+            }
+            setsid();
+            build_local_reload(requested);
+        }
+        else if (builder < 0)
+        {
+            openrasp_error(LEVEL_WARNING, RUNTIME_ERROR, _("Fail to fork reload process, cuz of %s."), strerror(errno));
+            openrasp::scm->finish_reload(requested, 0);
+        }
+        _exit(0);
+    }
+    else if (pid < 0)
+    {
+        openrasp_error(LEVEL_WARNING, RUNTIME_ERROR, _("Fail to fork reload process, cuz of %s."), strerror(errno));
+        openrasp::scm->finish_reload(requested, 0);
+        return;
+    }
+    //中间进程在 fork 构建进程后立即退出
+    waitpid(pid, nullptr, 0);
+#endif
+}
+
+/**
+ * 重建完成后每个进程重新读取一次 assets/inject.html，快照与配置镜像由各自的 RINIT 按时间戳切换
+ */
+static void adopt_local_reload()
+{
+    static std::atomic<uint64_t> reload_seen(0);
+    uint64_t done = openrasp::scm->get_reload_done();
+    uint64_t seen = reload_seen.load();
+    if (done > seen && reload_seen.compare_exchange_strong(seen, done))
+    {
+        openrasp_load_inject_html();
+    }
+}
+
 static void hook_without_params(OpenRASPCheckType check_type)
 {
     bool type_ignored = openrasp_check_type_ignored(check_type);
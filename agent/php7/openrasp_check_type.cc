@@ -17,10 +17,9 @@
 #include "openrasp_check_type.h"
 #include <algorithm>
 
-void CheckTypeTransfer::insert(OpenRASPCheckType type, const std::string &name, bool is_buildin)
+void CheckTypeTransfer::insert(OpenRASPCheckType type, bool is_buildin)
 {
-  check_type_to_name.insert({type, name});
-  name_to_check_type.insert({name, type});
+  name_to_check_type.insert({check_type_name(type), type});
   if (is_buildin)
   {
     buildin_check_type.push_back(type);
@@ -29,50 +28,42 @@ void CheckTypeTransfer::insert(OpenRASPCheckType type, const std::string &name,
 
 CheckTypeTransfer::CheckTypeTransfer()
 {
-  insert(CALLABLE, "webshell_callable", true);
-  insert(COMMAND, "command");
-  insert(DIRECTORY, "directory");
-  insert(READ_FILE, "readFile");
-  insert(WRITE_FILE, "writeFile");
-  insert(COPY, "copy");
-  insert(RENAME, "rename");
-  insert(FILE_UPLOAD, "fileUpload");
-  insert(INCLUDE, "include");
-  insert(DB_CONNECTION, "dbConnection");
-  insert(SQL, "sql");
-  insert(SQL_PREPARED, "sqlPrepared");
-  insert(SSRF, "ssrf");
-  insert(WEBSHELL_EVAL, "webshell_eval", true);
-  insert(WEBSHELL_COMMAND, "webshell_command", true);
-  insert(WEBSHELL_FILE_PUT_CONTENTS, "webshell_file_put_contents", true);
-  insert(XSS_ECHO, "xss_echo", true);
-  insert(XSS_USER_INPUT, "xss_userinput", true);
-  insert(SQL_ERROR, "sql_exception");
-  insert(WEBSHELL_ENV, "webshell_ld_preload", true);
-  insert(REQUEST, "request");
-  insert(REQUEST_END, "requestEnd");
-  insert(EVAL, "eval");
-  insert(DELETE_FILE, "deleteFile");
-  insert(MONGO, "mongodb");
-  insert(SSRF_REDIRECT, "ssrfRedirect");
-  insert(RESPONSE, "response");
+  insert(CALLABLE, true);
+  insert(COMMAND);
+  insert(DIRECTORY);
+  insert(READ_FILE);
+  insert(WRITE_FILE);
+  insert(COPY);
+  insert(RENAME);
+  insert(FILE_UPLOAD);
+  insert(INCLUDE);
+  insert(DB_CONNECTION);
+  insert(SQL);
+  insert(SQL_PREPARED);
+  insert(SSRF);
+  insert(WEBSHELL_EVAL, true);
+  insert(WEBSHELL_COMMAND, true);
+  insert(WEBSHELL_FILE_PUT_CONTENTS, true);
+  insert(XSS_ECHO, true);
+  insert(XSS_USER_INPUT, true);
+  insert(SQL_ERROR);
+  insert(WEBSHELL_ENV, true);
+  insert(REQUEST);
+  insert(REQUEST_END);
+  insert(EVAL);
+  insert(DELETE_FILE);
+  insert(MONGO);
+  insert(SSRF_REDIRECT);
+  insert(RESPONSE);
 }
 
 CheckTypeTransfer::~CheckTypeTransfer()
 {
 }
 
-std::string CheckTypeTransfer::type_to_name(OpenRASPCheckType type) const
+const char *CheckTypeTransfer::type_to_name(OpenRASPCheckType type) const
 {
-  auto it = check_type_to_name.find(type);
-  if (it != check_type_to_name.end())
-  {
-    return it->second;
-  }
-  else
-  {
-    return "unknown";
-  }
+  return check_type_name(type);
 }
 
 OpenRASPCheckType CheckTypeTransfer::name_to_type(const std::string &name) const
@@ -55,13 +55,51 @@ enum OpenRASPCheckType
   ALL_TYPE
 };
 
+//按枚举值索引的检测类型名称
+constexpr const char *CHECK_TYPE_NAMES[] = {
+    "unknown",
+    "webshell_callable",
+    "command",
+    "directory",
+    "readFile",
+    "writeFile",
+    "deleteFile",
+    "copy",
+    "rename",
+    "fileUpload",
+    "include",
+    "eval",
+    "dbConnection",
+    "sql",
+    "sqlPrepared",
+    "sql_exception",
+    "ssrf",
+    "webshell_eval",
+    "webshell_command",
+    "webshell_file_put_contents",
+    "webshell_ld_preload",
+    "xss_echo",
+    "xss_userinput",
+    "request",
+    "requestEnd",
+    "mongodb",
+    "ssrfRedirect",
+    "response",
+    "unknown"};
+
+static_assert(sizeof(CHECK_TYPE_NAMES) / sizeof(CHECK_TYPE_NAMES[0]) == ALL_TYPE + 1, "CHECK_TYPE_NAMES must follow OpenRASPCheckType");
+
+constexpr const char *check_type_name(OpenRASPCheckType type)
+{
+  return (type > INVALID_TYPE && type < ALL_TYPE) ? CHECK_TYPE_NAMES[type] : "unknown";
+}
+
 class CheckTypeTransfer
 {
 private:
-  std::map<OpenRASPCheckType, const std::string> check_type_to_name;
   std::map<const std::string, OpenRASPCheckType> name_to_check_type;
   std::vector<OpenRASPCheckType> buildin_check_type;
-  void insert(OpenRASPCheckType type, const std::string &name, bool is_buildin = false);
+  void insert(OpenRASPCheckType type, bool is_buildin = false);
 
   CheckTypeTransfer();
   virtual ~CheckTypeTransfer();
@@ -71,7 +109,7 @@ private:
 public:
   static CheckTypeTransfer &instance();
   //only read op
-  std::string type_to_name(OpenRASPCheckType type) const;
+  const char *type_to_name(OpenRASPCheckType type) const;
   OpenRASPCheckType name_to_type(const std::string &name) const;
   std::map<std::string, std::string> get_buildin_action_map() const;
   std::vector<OpenRASPCheckType> get_buildin_check_types() const;
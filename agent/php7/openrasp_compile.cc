@@ -0,0 +1,350 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "openrasp_compile.h"
+#include "openrasp_log.h"
+#include "agent/shared_config_manager.h"
+#include <new>
+#include <strings.h>
+
+extern "C"
+{
+#include "Zend/zend_compile.h"
+#include "Zend/zend_vm_opcodes.h"
+}
+
+/**
+ * 编译期识别 sink 参数为常量的调用点
+ * zend_compile_file 在 MINIT 中被包装，opcache 启动更晚，会再包装一层，只有缓存未命中时才会进入这里；
+ * 因此编译阶段只负责统计，运行期的判断直接读取（可能已被 opcache 持久化和优化过的）op_array，
+ * 与编译阶段使用同一套分析逻辑，不依赖进程内的任何标记
+ */
+
+ZEND_DECLARE_MODULE_GLOBALS(openrasp_compile)
+
+static const int max_call_walk = 256;
+
+static const char *sink_functions[] = {
+    "file_get_contents", "readfile", "file", "fopen", "file_put_contents",
+    "exec", "system", "passthru", "shell_exec", "popen", "proc_open", "pcntl_exec",
+    "mysql_query", "mysqli_query", "mysqli_real_query", "pg_query", "pg_send_query"};
+
+static const char *sink_methods[] = {"query", "exec", "prepare", "real_query"};
+
+struct SiteStats
+{
+    long sink_sites = 0;
+    long constant_sites = 0;
+};
+
+static zend_op_array *(*origin_compile_file)(zend_file_handle *file_handle, int type) = nullptr;
+
+#if (PHP_MAJOR_VERSION == 7 && PHP_MINOR_VERSION < 3)
+#define OPENRASP_OP_CONSTANT(op_array, opline, node) RT_CONSTANT(op_array, node)
+#else
+#define OPENRASP_OP_CONSTANT(op_array, opline, node) RT_CONSTANT(opline, node)
+#endif
+
+static bool is_do_call(zend_uchar opcode)
+{
+    return opcode == ZEND_DO_FCALL ||
+           opcode == ZEND_DO_ICALL ||
+           opcode == ZEND_DO_UCALL ||
+           opcode == ZEND_DO_FCALL_BY_NAME;
+}
+
+static bool is_init_call(zend_uchar opcode)
+{
+    return opcode == ZEND_INIT_FCALL ||
+           opcode == ZEND_INIT_FCALL_BY_NAME ||
+           opcode == ZEND_INIT_NS_FCALL_BY_NAME ||
+           opcode == ZEND_INIT_METHOD_CALL ||
+           opcode == ZEND_INIT_STATIC_METHOD_CALL ||
+           opcode == ZEND_INIT_DYNAMIC_CALL ||
+           opcode == ZEND_INIT_USER_CALL ||
+           opcode == ZEND_NEW;
+}
+
+/**
+ * 只有字面量视为常量；全局常量与类常量（其值可以引用运行时 define() 的全局常量）都可能来自用户输入
+ */
+static bool is_constant_operand(const zend_op *opline)
+{
+    return opline->op1_type == IS_CONST;
+}
+
+/**
+ * 从 DO_*CALL 向前找到对应的 INIT_* 以及第一个参数的 SEND_VAL，嵌套调用按深度跳过
+ */
+static const zend_op *find_call_init(const zend_op_array *op_array, const zend_op *call, const zend_op **first_send)
+{
+    int depth = 0;
+    int steps = 0;
+    *first_send = nullptr;
+    for (const zend_op *it = call - 1; it >= op_array->opcodes && steps < max_call_walk; --it, ++steps)
+    {
+        if (is_do_call(it->opcode))
+        {
+            ++depth;
+        }
+        else if (is_init_call(it->opcode))
+        {
+            if (depth == 0)
+            {
+                return it;
+            }
+            --depth;
+        }
+        else if (depth == 0 &&
+                 (it->opcode == ZEND_SEND_VAL || it->opcode == ZEND_SEND_VAL_EX) &&
+                 it->op2.num == 1)
+        {
+            *first_send = it;
+        }
+    }
+    return nullptr;
+}
+
+static bool is_sink_call(const zend_op_array *op_array, const zend_op *init)
+{
+    if (init->op2_type != IS_CONST)
+    {
+        return false;
+    }
+    zval *name = OPENRASP_OP_CONSTANT(op_array, init, init->op2);
+    if (Z_TYPE_P(name) != IS_STRING)
+    {
+        return false;
+    }
+    const char *short_name = Z_STRVAL_P(name);
+    const char *ns = strrchr(short_name, '\\');
+    if (ns != nullptr)
+    {
+        short_name = ns + 1;
+    }
+    switch (init->opcode)
+    {
+    case ZEND_INIT_FCALL:
+    case ZEND_INIT_FCALL_BY_NAME:
+    case ZEND_INIT_NS_FCALL_BY_NAME:
+        for (const char *sink : sink_functions)
+        {
+            if (strcasecmp(short_name, sink) == 0)
+            {
+                return true;
+            }
+        }
+        break;
+    case ZEND_INIT_METHOD_CALL:
+        for (const char *sink : sink_methods)
+        {
+            if (strcasecmp(short_name, sink) == 0)
+            {
+                return true;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+    return false;
+}
+
+static void scan_op_array(const zend_op_array *op_array, SiteStats &stats)
+{
+    if (nullptr == op_array->opcodes)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < op_array->last; ++i)
+    {
+        const zend_op *opline = op_array->opcodes + i;
+        if (opline->opcode == ZEND_INCLUDE_OR_EVAL)
+        {
+            stats.sink_sites++;
+            if (is_constant_operand(opline))
+            {
+                stats.constant_sites++;
+            }
+        }
+        else if (is_do_call(opline->opcode))
+        {
+            const zend_op *first_send = nullptr;
+            const zend_op *init = find_call_init(op_array, opline, &first_send);
+            if (nullptr != init && is_sink_call(op_array, init))
+            {
+                stats.sink_sites++;
+                if (nullptr != first_send && is_constant_operand(first_send))
+                {
+                    stats.constant_sites++;
+                }
+            }
+        }
+    }
+}
+
+static void scan_function_table(HashTable *function_table, uint32_t since, zend_class_entry *scope, SiteStats &stats)
+{
+    for (uint32_t idx = since; idx < function_table->nNumUsed; ++idx)
+    {
+        Bucket *p = function_table->arData + idx;
+        if (Z_TYPE(p->val) == IS_UNDEF)
+        {
+            continue;
+        }
+        zend_function *func = static_cast<zend_function *>(Z_PTR(p->val));
+        if (ZEND_USER_CODE(func->type) && func->common.scope == scope)
+        {
+            scan_op_array(&func->op_array, stats);
+        }
+    }
+}
+
+static zend_op_array *openrasp_compile_file(zend_file_handle *file_handle, int type)
+{
+    uint32_t function_since = CG(function_table)->nNumUsed;
+    uint32_t class_since = CG(class_table)->nNumUsed;
+    zend_op_array *op_array = origin_compile_file(file_handle, type);
+    if (nullptr == op_array ||
+        nullptr == op_array->filename ||
+        openrasp::scm == nullptr ||
+        openrasp::scm->get_debug_level() == 0)
+    {
+        return op_array;
+    }
+    SiteStats stats;
+    scan_op_array(op_array, stats);
+    scan_function_table(CG(function_table), function_since, nullptr, stats);
+    for (uint32_t idx = class_since; idx < CG(class_table)->nNumUsed; ++idx)
+    {
+        Bucket *p = CG(class_table)->arData + idx;
+        if (Z_TYPE(p->val) == IS_UNDEF)
+        {
+            continue;
+        }
+        zend_class_entry *ce = static_cast<zend_class_entry *>(Z_PTR(p->val));
+        if (ce->type == ZEND_USER_CLASS)
+        {
+            scan_function_table(&ce->function_table, 0, ce, stats);
+        }
+    }
+    if (stats.sink_sites > 0)
+    {
+        openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Compiled %s with %ld sink call sites, %ld of them with constant arguments."),
+                       ZSTR_VAL(op_array->filename), stats.sink_sites, stats.constant_sites);
+    }
+    return op_array;
+}
+
+static void count_elided_check(const zend_op_array *op_array)
+{
+    if (nullptr != op_array->filename)
+    {
+        OPENRASP_COMPILE_G(elided_checks)
+        [std::string(ZSTR_VAL(op_array->filename), ZSTR_LEN(op_array->filename))]++;
+    }
+}
+
+bool openrasp_constant_call_site(zend_execute_data *execute_data)
+{
+    zend_execute_data *caller = EX(prev_execute_data);
+    if (nullptr == caller ||
+        nullptr == caller->func ||
+        !ZEND_USER_CODE(caller->func->type) ||
+        nullptr == caller->opline ||
+        !is_do_call(caller->opline->opcode))
+    {
+        return false;
+    }
+    const zend_op_array *op_array = &caller->func->op_array;
+    const zend_op *first_send = nullptr;
+    const zend_op *init = find_call_init(op_array, caller->opline, &first_send);
+    if (nullptr == init ||
+        nullptr == first_send ||
+        !is_constant_operand(first_send))
+    {
+        return false;
+    }
+    count_elided_check(op_array);
+    return true;
+}
+
+bool openrasp_constant_include_site(zend_execute_data *execute_data)
+{
+    if (nullptr == EX(func) ||
+        !ZEND_USER_CODE(EX(func)->type) ||
+        nullptr == EX(opline) ||
+        EX(opline)->opcode != ZEND_INCLUDE_OR_EVAL)
+    {
+        return false;
+    }
+    const zend_op_array *op_array = &EX(func)->op_array;
+    if (!is_constant_operand(EX(opline)))
+    {
+        return false;
+    }
+    count_elided_check(op_array);
+    return true;
+}
+
+PHP_GINIT_FUNCTION(openrasp_compile)
+{
+#ifdef ZTS
+    new (openrasp_compile_globals) _zend_openrasp_compile_globals;
+#endif
+}
+
+PHP_GSHUTDOWN_FUNCTION(openrasp_compile)
+{
+#ifdef ZTS
+    openrasp_compile_globals->~_zend_openrasp_compile_globals();
+#endif
+}
+
+PHP_MINIT_FUNCTION(openrasp_compile)
+{
+    ZEND_INIT_MODULE_GLOBALS(openrasp_compile, PHP_GINIT(openrasp_compile), PHP_GSHUTDOWN(openrasp_compile));
+    origin_compile_file = zend_compile_file;
+    zend_compile_file = openrasp_compile_file;
+    return SUCCESS;
+}
+
+PHP_MSHUTDOWN_FUNCTION(openrasp_compile)
+{
+    if (zend_compile_file == openrasp_compile_file)
+    {
+        zend_compile_file = origin_compile_file;
+    }
+    ZEND_SHUTDOWN_MODULE_GLOBALS(openrasp_compile, PHP_GSHUTDOWN(openrasp_compile));
+    return SUCCESS;
+}
+
+PHP_RSHUTDOWN_FUNCTION(openrasp_compile)
+{
+    auto &elided_checks = OPENRASP_COMPILE_G(elided_checks);
+    if (!elided_checks.empty() &&
+        openrasp::scm != nullptr &&
+        openrasp::scm->get_debug_level() != 0)
+    {
+        for (auto &item : elided_checks)
+        {
+            openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Elided %ld checks at constant call sites in %s."),
+                           item.second, item.first.c_str());
+        }
+    }
+    elided_checks.clear();
+    return SUCCESS;
+}
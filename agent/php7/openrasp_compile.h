@@ -0,0 +1,43 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "openrasp.h"
+#include <string>
+#include <unordered_map>
+
+ZEND_BEGIN_MODULE_GLOBALS(openrasp_compile)
+std::unordered_map<std::string, long> elided_checks;
+ZEND_END_MODULE_GLOBALS(openrasp_compile)
+
+ZEND_EXTERN_MODULE_GLOBALS(openrasp_compile);
+
+#define OPENRASP_COMPILE_G(v) ZEND_MODULE_GLOBALS_ACCESSOR(openrasp_compile, v)
+
+PHP_MINIT_FUNCTION(openrasp_compile);
+PHP_MSHUTDOWN_FUNCTION(openrasp_compile);
+PHP_RSHUTDOWN_FUNCTION(openrasp_compile);
+
+/**
+ * 当前 hook 的内部函数是否由用户代码以编译期常量（字面量或类常量）作为第一个参数直接调用
+ * 返回 true 时计入所在文件的省略检测次数，调用方据此跳过或缓存检测
+ */
+bool openrasp_constant_call_site(zend_execute_data *execute_data);
+/**
+ * 当前 include/require/eval 的操作数是否为编译期常量
+ */
+bool openrasp_constant_include_site(zend_execute_data *execute_data);
@@ -36,6 +36,10 @@ bool ConfigHolder::update(BaseReader *reader)
   lru.update(reader);
   decompile.update(reader);
   response.update(reader);
+  security.update(reader);
+  ssrf.update(reader);
+  mongo.update(reader);
+  input.update(reader);
   return true;
 }
 
@@ -52,6 +52,10 @@ public:
   LruBlock lru;
   DecompileBlock decompile;
   ResponseBlock response;
+  SecurityBlock security;
+  SsrfBlock ssrf;
+  MongoBlock mongo;
+  InputBlock input;
 
 private:
   long latestUpdateTime = 0;
@@ -18,6 +18,7 @@
 #include "utils/regex.h"
 #include "utils/validator.h"
 #include "openrasp_v8.h"
+#include "openrasp_error.h"
 
 namespace openrasp
 {
@@ -111,6 +112,10 @@ void DecompileBlock::update(BaseReader *reader)
   enable = reader->fetch_bool({"decompile.enable"}, false);
 };
 
+const int64_t ResponseBlock::default_chunk_size = 64 * 1024;
+const int64_t ResponseBlock::default_overlap_window = 4 * 1024;
+const int64_t ResponseBlock::default_prescan_min_digits = 11;
+
 void ResponseBlock::update(BaseReader *reader)
 {
   sampler_interval = reader->fetch_int64({"response.sampler_interval"}, 60,
@@ -118,6 +123,69 @@ void ResponseBlock::update(BaseReader *reader)
                                            return openrasp::limit_int64(value, 60, true);
                                          });
   sampler_burst = reader->fetch_int64({"response.sampler_burst"}, 5);
+  chunk_size = reader->fetch_int64({"response.chunk_size"}, ResponseBlock::default_chunk_size, openrasp::ge_zero_int64);
+  overlap_window = reader->fetch_int64({"response.overlap_window"}, ResponseBlock::default_overlap_window, openrasp::ge_zero_int64);
+  prescan_enable = reader->fetch_bool({"response.prescan.enable"}, true);
+  prescan_min_digits = reader->fetch_int64({"response.prescan.min_digits"}, ResponseBlock::default_prescan_min_digits, openrasp::ge_zero_int64);
+  prescan_signatures = reader->fetch_strings({"response.prescan.signatures"});
+};
+
+const vector<string> SecurityBlock::default_sensitive_paths = {
+    "/etc/issue",
+    "/etc/shadow",
+    "/etc/passwd",
+    "/etc/apache2/apache2.conf",
+    "/root/.bash_history",
+    "/root/.bash_profile",
+    "/proc/",
+    "/sys/",
+    "c:\\windows\\system32\\inetsrv\\metabase.xml",
+    "c:\\windows\\system32\\drivers\\etc\\hosts",
+    "id_rsa",
+    "authorized_keys",
+    ".bash_history",
+    ".mysql_history",
+    ".htaccess",
+    ".user.ini"};
+
+void SecurityBlock::update(BaseReader *reader)
+{
+  sensitive_paths = reader->fetch_strings({"security.sensitive_paths"}, SecurityBlock::default_sensitive_paths);
+};
+
+const int64_t SsrfBlock::default_dns_timeout_millis = 200;
+const int64_t SsrfBlock::default_dns_cache_ttl = 60;
+
+void SsrfBlock::update(BaseReader *reader)
+{
+  dns_timeout_millis = reader->fetch_int64({"ssrf.dns_timeout_millis"}, SsrfBlock::default_dns_timeout_millis, openrasp::ge_zero_int64);
+  dns_cache_ttl = reader->fetch_int64({"ssrf.dns_cache_ttl"}, SsrfBlock::default_dns_cache_ttl, openrasp::ge_zero_int64);
+  custom_cidrs = reader->fetch_strings({"ssrf.custom_cidrs"});
+  classifier = CidrClassifier();
+  for (const auto &cidr : custom_cidrs)
+  {
+    if (!classifier.add(cidr, CidrClassifier::kCustom) && reader->get_exception_report())
+    {
+      openrasp_error(LEVEL_WARNING, CONFIG_ERROR, _("invalid cidr \"%s\", config \"ssrf.custom_cidrs\" ignores this entry"),
+                     cidr.c_str());
+    }
+  }
+};
+
+const int64_t MongoBlock::default_maxbytes = 16 * 1024;
+
+void MongoBlock::update(BaseReader *reader)
+{
+  maxbytes = reader->fetch_int64({"mongo.maxbytes"}, MongoBlock::default_maxbytes, openrasp::ge_zero_int64);
+};
+
+const int64_t InputBlock::default_max_depth = 8;
+const int64_t InputBlock::default_max_entries = 4096;
+
+void InputBlock::update(BaseReader *reader)
+{
+  max_depth = reader->fetch_int64({"input.max_depth"}, InputBlock::default_max_depth, openrasp::ge_zero_int64);
+  max_entries = reader->fetch_int64({"input.max_entries"}, InputBlock::default_max_entries, openrasp::ge_zero_int64);
 };
 
 } // namespace openrasp
\ No newline at end of file
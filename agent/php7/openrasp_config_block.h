@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <memory>
 #include "utils/base_reader.h"
+#include "utils/cidr_classifier.h"
 #include "php/header.h"
 
 namespace openrasp
@@ -128,8 +129,54 @@ public:
 class ResponseBlock
 {
 public:
+  const static int64_t default_chunk_size;
+  const static int64_t default_overlap_window;
   int sampler_interval;
   int sampler_burst;
+  const static int64_t default_prescan_min_digits;
+  int64_t chunk_size = default_chunk_size;
+  int64_t overlap_window = default_overlap_window;
+  bool prescan_enable = true;
+  int64_t prescan_min_digits = default_prescan_min_digits;
+  vector<string> prescan_signatures;
+  void update(BaseReader *reader);
+};
+
+class SecurityBlock
+{
+public:
+  const static vector<string> default_sensitive_paths;
+  vector<string> sensitive_paths;
+  void update(BaseReader *reader);
+};
+
+class SsrfBlock
+{
+public:
+  const static int64_t default_dns_timeout_millis;
+  const static int64_t default_dns_cache_ttl;
+  vector<string> custom_cidrs;
+  int64_t dns_timeout_millis = 200;
+  int64_t dns_cache_ttl = 60;
+  CidrClassifier classifier;
+  void update(BaseReader *reader);
+};
+
+class MongoBlock
+{
+public:
+  const static int64_t default_maxbytes;
+  int64_t maxbytes = 16 * 1024;
+  void update(BaseReader *reader);
+};
+
+class InputBlock
+{
+public:
+  const static int64_t default_max_depth;
+  const static int64_t default_max_entries;
+  int64_t max_depth = 8;
+  int64_t max_entries = 4096;
   void update(BaseReader *reader);
 };
 
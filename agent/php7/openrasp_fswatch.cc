@@ -16,21 +16,16 @@
 
 #include "openrasp_fswatch.h"
 #include "openrasp_ini.h"
+#include "agent/shared_config_manager.h"
 #include "libfswatch/c++/monitor.hpp"
 #include <thread>
-#include <signal.h>
 #include <algorithm>
 #include <exception>
-#ifndef PHP_WIN32
-static std::vector<std::pair<std::string, int>> supported_sapis{
-    {"apache2handler", SIGUSR1},
-    {"fpm-fcgi", SIGUSR2},
-};
-static std::vector<std::pair<std::string, int>>::iterator supported_sapi;
-#else
-#include <windows.h>
-void (*ap_signal_parent)(int) = nullptr;
-#endif
+/**
+ * 文件变化时在共享内存中登记重新加载请求，由单独的构建进程重建快照与配置，
+ * 工作进程在 RINIT 中切换，不再重启 SAPI 主进程，已有的长连接与 opcache 不受影响
+ */
+static std::vector<std::string> supported_sapis{"apache2handler", "fpm-fcgi"};
 static fsw::monitor *monitor = nullptr;
 static std::thread *fswatch_thread = nullptr;
 static pid_t master_pid = 0;
@@ -40,29 +35,16 @@ PHP_MINIT_FUNCTION(openrasp_fswatch)
     {
         return SUCCESS;
     }
-#ifndef PHP_WIN32
-    supported_sapi = std::find_if(supported_sapis.begin(), supported_sapis.end(),
-                                  [](std::pair<std::string, int> i) { return i.first.compare(sapi_module.name) == 0; });
-    if (supported_sapi == supported_sapis.end())
+    if (std::find(supported_sapis.begin(), supported_sapis.end(), sapi_module.name) == supported_sapis.end())
     {
         return SUCCESS;
     }
-#else
+#ifdef PHP_WIN32
     if (getenv("AP_PARENT_PID") != nullptr)
     {
         master_pid = std::stol(getenv("AP_PARENT_PID"));
         return SUCCESS;
     }
-    HMODULE module = GetModuleHandle("libhttpd.dll");
-    *(void **)(&ap_signal_parent) = GetProcAddress(module, "ap_signal_parent");
-    if (ap_signal_parent == nullptr)
-    {
-        *(void **)(&ap_signal_parent) = GetProcAddress(module, "_ap_signal_parent@4");
-    }
-    if (ap_signal_parent == nullptr)
-    {
-        return SUCCESS;
-    }
 #endif
     try
     {
@@ -74,21 +56,12 @@ PHP_MINIT_FUNCTION(openrasp_fswatch)
         monitor = fsw::monitor_factory::create_monitor(
             fsw_monitor_type::system_default_monitor_type, paths,
             [](const std::vector<fsw::event> &events, void *ctx) {
-                try
-                {
-#ifndef PHP_WIN32
-                    if (raise(supported_sapi->second))
-                    {
-                        openrasp_error(LEVEL_WARNING, FSWATCH_ERROR, _("Failed to reload %s"), sapi_module.name);
-                    }
-#else
-                    ap_signal_parent(2);
-#endif
-                }
-                catch (...)
+                if (openrasp::scm == nullptr || openrasp::scm->request_reload() == 0)
                 {
-                    openrasp_error(LEVEL_WARNING, FSWATCH_ERROR, _("An exception occurred while reloading master process, but this message may not be visible"));
+                    openrasp_error(LEVEL_WARNING, FSWATCH_ERROR, _("Failed to request reload of plugins and config"));
+                    return;
                 }
+                openrasp_reload_local();
             });
 
         std::vector<fsw_event_type_filter> event_filters;
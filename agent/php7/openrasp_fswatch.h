@@ -27,5 +27,10 @@ extern "C" {
 #include "php_main.h"
 }
 
+/**
+ * 领取重新加载请求，在单独的构建进程中重新读取 openrasp.yml 与插件目录并发布到共享内存，只在 fswatch 线程中调用（见 openrasp.cc）
+ */
+void openrasp_reload_local();
+
 PHP_MINIT_FUNCTION(openrasp_fswatch);
 PHP_MSHUTDOWN_FUNCTION(openrasp_fswatch);
\ No newline at end of file
@@ -23,15 +23,18 @@
 #include <new>
 #include <map>
 #include <algorithm>
+#include <atomic>
 #include "agent/shared_config_manager.h"
 #include <unordered_map>
 #include "openrasp_content_type.h"
 #include "openrasp_check_type.h"
+#include "utils/string_kernel.h"
 
 extern "C"
 {
 #include "Zend/zend_exceptions.h"
 #include "ext/standard/php_fopen_wrappers.h"
+#include "Zend/zend_extensions.h"
 }
 
 using openrasp::OpenRASPContentType;
@@ -39,14 +42,50 @@ using openrasp::OpenRASPContentType;
 static const int hookHandlerSize = 256;
 static hook_handler_t global_hook_handlers[PriorityType::pTotal][hookHandlerSize] = {0};
 static size_t global_hook_handlers_len[PriorityType::pTotal] = {0};
-static const std::string COLON_TWO_SLASHES = "://";
-static void update_zend_ref_items();
 
-typedef struct _track_vars_pair_t
+typedef struct _fused_hook_entry_t
 {
-    int id;
+    const char *scope;
     const char *name;
-} track_vars_pair;
+    OpenRASPCheckType type;
+    fused_hook_t pre;
+    fused_hook_t post;
+} fused_hook_entry;
+static fused_hook_entry global_fused_hooks[PriorityType::pTotal][hookHandlerSize] = {0};
+static size_t global_fused_hooks_len[PriorityType::pTotal] = {0};
+
+/**
+ * FusedHook 的地址保存在 zend_internal_function.reserved 中，子类复制内部方法时一并复制
+ * reserved 槽位已被占满时，以 scope 与 function_name 在 fused_hooks 中查找
+ */
+struct FusedHookKey
+{
+    const zend_class_entry *scope;
+    const zend_string *name;
+    bool operator==(const FusedHookKey &other) const
+    {
+        return scope == other.scope && name == other.name;
+    }
+};
+struct FusedHookKeyHash
+{
+    size_t operator()(const FusedHookKey &key) const
+    {
+        return std::hash<const void *>()(key.scope) ^ (std::hash<const void *>()(key.name) << 1);
+    }
+};
+struct FusedHook
+{
+    zend_function *function = nullptr;
+    php_function origin = nullptr;
+    //外层在前
+    std::vector<const fused_hook_entry *> entries;
+};
+static std::unordered_map<FusedHookKey, FusedHook, FusedHookKeyHash> fused_hooks;
+static zend_extension fused_hook_extension;
+static int fused_hook_resource = -1;
+static const std::string COLON_TWO_SLASHES = "://";
+static void update_risk_profile();
 
 ZEND_DECLARE_MODULE_GLOBALS(openrasp_hook)
 
@@ -58,37 +97,189 @@ void register_hook_handler(hook_handler_t hook_handler, OpenRASPCheckType type,
     }
 }
 
-bool openrasp_zval_in_request(zval *item)
+void register_fused_hook(const char *scope, const char *name, OpenRASPCheckType type, PriorityType::HookPriority hp, fused_hook_t pre, fused_hook_t post)
 {
-    if (nullptr != item)
+    if (hp < PriorityType::pTotal && global_fused_hooks_len[hp] < hookHandlerSize)
     {
-        auto found = OPENRASP_HOOK_G(zend_ref_items).find(reinterpret_cast<uintptr_t>(Z_COUNTED_P(item)));
-        return found != OPENRASP_HOOK_G(zend_ref_items).end();
+        global_fused_hooks[hp][(global_fused_hooks_len[hp])++] = {scope, name, type, pre, post};
     }
-    return false;
 }
 
-bool fetch_name_in_request(zval *item, std::string &name, std::string &type)
+static const FusedHook *fetch_fused_hook(zend_function *function)
+{
+    if (fused_hook_resource >= 0)
+    {
+        return static_cast<const FusedHook *>(function->internal_function.reserved[fused_hook_resource]);
+    }
+    auto found = fused_hooks.find({function->common.scope, function->common.function_name});
+    return found == fused_hooks.end() ? nullptr : &found->second;
+}
+
+static void fused_hook_dispatch(INTERNAL_FUNCTION_PARAMETERS)
 {
-    if (nullptr != item)
+    const FusedHook *hook = fetch_fused_hook(EX(func));
+    if (nullptr == hook)
+    {
+        //找不到原始 handler 时抛出错误，不能静默吞掉这次调用
+        zend_throw_error(nullptr, "OpenRASP failed to dispatch %s()", ZSTR_VAL(EX(func)->common.function_name));
+        return;
+    }
+    HookArgs hook_args(execute_data);
+    for (const fused_hook_entry *entry : hook->entries)
+    {
+        if (entry->pre && !openrasp_check_type_ignored(entry->type))
+        {
+            entry->pre(INTERNAL_FUNCTION_PARAM_PASSTHRU, entry->type, hook_args);
+        }
+    }
+    hook->origin(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+    for (auto it = hook->entries.rbegin(); it != hook->entries.rend(); ++it)
     {
-        auto found = OPENRASP_HOOK_G(zend_ref_items).find(reinterpret_cast<uintptr_t>(Z_COUNTED_P(item)));
-        if (found != OPENRASP_HOOK_G(zend_ref_items).end())
+        const fused_hook_entry *entry = *it;
+        if (entry->post && !openrasp_check_type_ignored(entry->type))
         {
-            static std::unordered_map<int, std::string> id_names =
+            entry->post(INTERNAL_FUNCTION_PARAM_PASSTHRU, entry->type, hook_args);
+        }
+    }
+}
+
+static zend_function *fetch_hook_target(const char *scope, const char *name)
+{
+    HashTable *ht = nullptr;
+    if (strcmp("global", scope) == 0)
+    {
+        ht = CG(function_table);
+    }
+    else
+    {
+        std::string scope_str(scope);
+        openrasp::string_replace(scope_str, ZEND_TOSTR(BACKSLASH_IN_CLASS), "\\");
+        zend_class_entry *clazz = static_cast<zend_class_entry *>(
+            zend_hash_str_find_ptr(CG(class_table), scope_str.c_str(), scope_str.length()));
+        if (clazz != nullptr)
+        {
+            ht = &(clazz->function_table);
+        }
+    }
+    if (nullptr == ht)
+    {
+        return nullptr;
+    }
+    zend_function *function = static_cast<zend_function *>(zend_hash_str_find_ptr(ht, name, strlen(name)));
+    if (nullptr == function ||
+        function->type != ZEND_INTERNAL_FUNCTION ||
+        function->internal_function.handler == zif_display_disabled_function)
+    {
+        return nullptr;
+    }
+    return function;
+}
+
+/**
+ * 每个函数只安装一个 fused_hook_dispatch，登记在后的检测类型位于外层
+ */
+static void install_fused_hooks()
+{
+    fused_hook_resource = zend_get_resource_handle(&fused_hook_extension);
+    for (size_t i = 0; i < PriorityType::pTotal; ++i)
+    {
+        for (size_t j = 0; j < global_fused_hooks_len[i]; ++j)
+        {
+            const fused_hook_entry *entry = &global_fused_hooks[i][j];
+            zend_function *function = fetch_hook_target(entry->scope, entry->name);
+            if (nullptr == function)
+            {
+                continue;
+            }
+            FusedHook &hook = fused_hooks[{function->common.scope, function->common.function_name}];
+            if (nullptr == hook.origin)
+            {
+                hook.function = function;
+                hook.origin = function->internal_function.handler;
+                function->internal_function.handler = fused_hook_dispatch;
+                if (fused_hook_resource >= 0)
                 {
-                    {TRACK_VARS_POST, "_POST"},
-                    {TRACK_VARS_GET, "_GET"},
-                    {TRACK_VARS_COOKIE, "_COOKIE"}};
-            name = found->second.get_name();
-            int id = found->second.get_id();
-            auto id_found = id_names.find(id);
-            if (id_found != id_names.end())
+                    function->internal_function.reserved[fused_hook_resource] = &hook;
+                }
+            }
+            hook.entries.insert(hook.entries.begin(), entry);
+        }
+    }
+}
+
+/**
+ * 所有 URL 都忽略（hook.white 中的 "*" 或内置检测 action 为 ignore）的检测类型不再付出任何代价：
+ * 全局函数上注册的检测类型全部被忽略时恢复原始 handler，配置变化后在下一个请求开始时整体重新安装
+ * 类方法可能被子类复制（opcache 中也会保留复制时的 handler），ZTS 下函数表在线程间共享，这两种情况保持安装
+ * 前提：检测函数之间的状态只在同一函数的 pre/post 之间传递（如 pg_query 的 error verbosity），
+ * 不记录供其他函数上的检测类型使用的状态（连接信息、错误处理等），因此按函数整体卸载不影响仍启用的类型
+ */
+static void apply_fused_hooks(openrasp::dat_value disabled_check_types)
+{
+#ifdef ZTS
+    static std::atomic_flag logged = ATOMIC_FLAG_INIT;
+    if (openrasp::scm->get_debug_level() != 0 && !logged.test_and_set())
+    {
+        openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Hooks of check types ignored on every URL stay installed in ZTS builds."));
+    }
+#else
+    static bool applied = false;
+    static openrasp::dat_value applied_check_types = 0;
+    if (applied && applied_check_types == disabled_check_types)
+    {
+        return;
+    }
+    for (auto &item : fused_hooks)
+    {
+        FusedHook &hook = item.second;
+        if (nullptr == hook.function ||
+            nullptr != hook.function->common.scope)
+        {
+            continue;
+        }
+        php_function current = hook.function->internal_function.handler;
+        if (current != fused_hook_dispatch && current != hook.origin)
+        {
+            //已被其他模块再次包装
+            continue;
+        }
+        bool enabled = false;
+        for (const fused_hook_entry *entry : hook.entries)
+        {
+            if (((1 << entry->type) & disabled_check_types) == 0)
             {
-                type = id_found->second;
+                enabled = true;
+                break;
             }
-            return true;
         }
+        hook.function->internal_function.handler = enabled ? fused_hook_dispatch : hook.origin;
+    }
+    applied = true;
+    applied_check_types = disabled_check_types;
+#endif
+}
+
+bool openrasp_zval_in_request(zval *item)
+{
+    return OPENRASP_HOOK_G(input_index).contains(item);
+}
+
+bool fetch_name_in_request(zval *item, std::string &name, std::string &type)
+{
+    int id = -1;
+    if (OPENRASP_HOOK_G(input_index).fetch_name(item, name, id))
+    {
+        static std::unordered_map<int, std::string> id_names =
+            {
+                {TRACK_VARS_POST, "_POST"},
+                {TRACK_VARS_GET, "_GET"},
+                {TRACK_VARS_COOKIE, "_COOKIE"}};
+        auto id_found = id_names.find(id);
+        if (id_found != id_names.end())
+        {
+            type = id_found->second;
+        }
+        return true;
     }
     return false;
 }
@@ -106,7 +297,7 @@ bool openrasp_check_type_ignored(OpenRASPCheckType check_type)
     return false;
 }
 
-std::string openrasp_real_path(const char *filename, int length, bool use_include_path, uint32_t w_op)
+static std::string resolve_real_path(const char *filename, int length, bool use_include_path, uint32_t w_op)
 {
     std::string result;
     static const std::unordered_map<std::string, uint32_t> opMap = {
@@ -219,10 +410,69 @@ std::string openrasp_real_path(const char *filename, int length, bool use_includ
     return result;
 }
 
+/**
+ * 绝对路径的解析结果先查 PHP 自身的 realpath cache，再查请求内的缓存
+ * 只缓存解析结果与输入完全相同的路径，即没有符号链接、. 与 .. 的成功解析：
+ * 符号链接可能被未经 hook 的途径改指向，失败的解析可能因随后创建文件而成功
+ * 写入、改名、删除类操作与命令执行可能改变文件系统，会清空请求内的缓存，前者也不缓存自身的结果
+ */
+std::string openrasp_real_path(const char *filename, int length, bool use_include_path, uint32_t w_op)
+{
+    static const uint32_t mutating_ops = WRITING | APPENDING | RENAMESRC | RENAMEDEST | UNLINK;
+    auto &memo = OPENRASP_HOOK_G(realpath_memo);
+    if (length <= 0 || !IS_ABSOLUTE_PATH(filename, length))
+    {
+        OPENRASP_HOOK_G(realpath_fs_resolutions)++;
+        return resolve_real_path(filename, length, use_include_path, w_op);
+    }
+    if (w_op & mutating_ops)
+    {
+        memo.clear();
+        OPENRASP_HOOK_G(realpath_fs_resolutions)++;
+        return resolve_real_path(filename, length, use_include_path, w_op);
+    }
+    OPENRASP_HOOK_G(realpath_lookups)++;
+    std::string key(filename, length);
+    key.push_back('\0');
+    key.append(std::to_string(w_op));
+    auto found = memo.find(key);
+    if (found != memo.end())
+    {
+        OPENRASP_HOOK_G(realpath_memo_hits)++;
+        return found->second;
+    }
+    std::string result;
+    realpath_cache_bucket *bucket = realpath_cache_lookup(filename, length, time(nullptr));
+    if (nullptr != bucket)
+    {
+        OPENRASP_HOOK_G(realpath_cache_hits)++;
+        if (!OPENRASP_CONFIG(plugin.filter) || !php_check_open_basedir(bucket->realpath))
+        {
+            result = std::string(bucket->realpath, bucket->realpath_len);
+        }
+    }
+    else
+    {
+        OPENRASP_HOOK_G(realpath_fs_resolutions)++;
+        result = resolve_real_path(filename, length, use_include_path, w_op);
+    }
+    if (result.length() == static_cast<size_t>(length) &&
+        0 == memcmp(result.data(), filename, length))
+    {
+        memo.emplace(std::move(key), result);
+    }
+    return result;
+}
+
+void openrasp_clear_realpath_memo()
+{
+    OPENRASP_HOOK_G(realpath_memo).clear();
+}
+
 static std::string resolve_request_id(std::string str)
 {
     static std::string placeholder = "%request_id%";
-    std::string request_id = OPENRASP_G(request).get_id();
+    const std::string &request_id = OPENRASP_G(request).get_id();
     size_t start_pos = 0;
     while ((start_pos = str.find(placeholder, start_pos)) != std::string::npos)
     {
@@ -278,7 +528,7 @@ void block_handle()
             {
                 sapi_header_struct *sapi_header = (sapi_header_struct *)element->data;
                 if (nullptr != sapi_header && sapi_header->header_len > 0 &&
-                    strncasecmp(sapi_header->header, "content-type", sizeof("content-type") - 1) == 0)
+                    openrasp::kernel::starts_with_ignore_case(sapi_header->header, sapi_header->header_len, ZEND_STRL("content-type")))
                 {
                     existing_content_type = std::string(sapi_header->header);
                     break;
@@ -364,6 +614,7 @@ PHP_MINIT_FUNCTION(openrasp_hook)
             global_hook_handlers[i][j]();
         }
     }
+    install_fused_hooks();
 
     zend_set_user_opcode_handler(ZEND_INCLUDE_OR_EVAL, include_or_eval_handler);
     zend_set_user_opcode_handler(ZEND_ECHO, echo_print_handler);
@@ -380,72 +631,110 @@ PHP_RINIT_FUNCTION(openrasp_hook)
 {
     if (openrasp::scm != nullptr)
     {
-        std::string url = OPENRASP_G(request).url.get_complete_url();
+        const std::string &url = OPENRASP_G(request).url.get_complete_url();
         if (!url.empty())
         {
             std::size_t found = url.find(COLON_TWO_SLASHES);
             if (found != std::string::npos)
             {
-                OPENRASP_HOOK_G(check_type_white_bit_mask) = openrasp::scm->get_check_type_white_bit_mask(url.substr(found + COLON_TWO_SLASHES.size()));
+                size_t offset = found + COLON_TWO_SLASHES.size();
+                OPENRASP_HOOK_G(check_type_white_bit_mask) = openrasp::scm->get_check_type_white_bit_mask(url.c_str() + offset, url.length() - offset);
             }
         }
         if (OPENRASP_HOOK_G(lru).max_size() != OPENRASP_CONFIG(lru.max_size))
         {
             OPENRASP_HOOK_G(lru).reset(OPENRASP_CONFIG(lru.max_size));
         }
+        openrasp::dat_value disabled_check_types = openrasp::scm->get_check_type_white_bit_mask("", 0);
         std::vector<OpenRASPCheckType> buindin_check_types = CheckTypeTransfer::instance().get_buildin_check_types();
         for (OpenRASPCheckType check_type : buindin_check_types)
         {
             if (openrasp::scm->get_buildin_check_action(check_type) == AC_IGNORE)
             {
                 OPENRASP_HOOK_G(check_type_white_bit_mask) |= (1 << check_type);
+                disabled_check_types |= (1 << check_type);
             }
         }
+        apply_fused_hooks(disabled_check_types);
     }
     OPENRASP_HOOK_G(origin_pg_error_verbos) = -1;
-    update_zend_ref_items();
+    OPENRASP_HOOK_G(include_cache_lookups) = 0;
+    OPENRASP_HOOK_G(include_cache_hits) = 0;
+    OPENRASP_HOOK_G(realpath_lookups) = 0;
+    OPENRASP_HOOK_G(realpath_cache_hits) = 0;
+    OPENRASP_HOOK_G(realpath_memo_hits) = 0;
+    OPENRASP_HOOK_G(realpath_fs_resolutions) = 0;
+    OPENRASP_HOOK_G(input_index).reset(OPENRASP_CONFIG(input.max_depth), OPENRASP_CONFIG(input.max_entries));
+    update_risk_profile();
     return SUCCESS;
 }
 
 PHP_RSHUTDOWN_FUNCTION(openrasp_hook)
 {
-    OPENRASP_HOOK_G(zend_ref_items).clear();
+    if (OPENRASP_HOOK_G(include_cache_lookups) > 0 &&
+        openrasp::scm != nullptr && openrasp::scm->get_debug_level() != 0)
+    {
+        openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Include verdict cache of request (%s) hit %ld of %ld lookups."),
+                       OPENRASP_G(request).url.get_complete_url().c_str(),
+                       OPENRASP_HOOK_G(include_cache_hits), OPENRASP_HOOK_G(include_cache_lookups));
+    }
+    if ((OPENRASP_HOOK_G(realpath_lookups) > 0 || OPENRASP_HOOK_G(realpath_fs_resolutions) > 0) &&
+        openrasp::scm != nullptr && openrasp::scm->get_debug_level() != 0)
+    {
+        openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Realpath resolution of request (%s): %ld memoizable lookups, %ld from realpath cache, %ld from request memo, %ld from filesystem."),
+                       OPENRASP_G(request).url.get_complete_url().c_str(),
+                       OPENRASP_HOOK_G(realpath_lookups), OPENRASP_HOOK_G(realpath_cache_hits),
+                       OPENRASP_HOOK_G(realpath_memo_hits), OPENRASP_HOOK_G(realpath_fs_resolutions));
+    }
+    if (OPENRASP_HOOK_G(input_index).is_truncated() && openrasp::scm != nullptr)
+    {
+        //每个进程首次截断时告警，之后只在 debug 模式下记录
+        static std::atomic_flag warned = ATOMIC_FLAG_INIT;
+        bool first = !warned.test_and_set();
+        if (first || openrasp::scm->get_debug_level() != 0)
+        {
+            openrasp_error(first ? LEVEL_WARNING : LEVEL_DEBUG, RUNTIME_ERROR,
+                           _("Nested parameters of request (%s) exceed input.max_entries (%zu), deeper values are not recognized as user input."),
+                           OPENRASP_G(request).url.get_complete_url().c_str(), static_cast<size_t>(OPENRASP_CONFIG(input.max_entries)));
+        }
+    }
+    OPENRASP_HOOK_G(input_index).clear();
+    OPENRASP_HOOK_G(realpath_memo).clear();
     return SUCCESS;
 }
 
-void update_zend_ref_items()
+void update_risk_profile()
 {
-    static const track_vars_pair pairs[] = {{TRACK_VARS_POST, "_POST"},
-                                            {TRACK_VARS_GET, "_GET"},
-                                            {TRACK_VARS_COOKIE, "_COOKIE"}};
-    int size = sizeof(pairs) / sizeof(pairs[0]);
-    for (int index = 0; index < size; ++index)
-    {
-        zval *global = &PG(http_globals)[pairs[index].id];
-        if (Z_TYPE_P(global) != IS_ARRAY &&
-            !zend_is_auto_global_str(const_cast<char *>(pairs[index].name), strlen(pairs[index].name)))
-        {
-            return;
-        }
-        zval *val = nullptr;
-        zend_string *key = nullptr;
-        zend_ulong idx;
-        ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(global), idx, key, val)
+    static const openrasp::dat_value all_check_types = ((static_cast<openrasp::dat_value>(1) << ALL_TYPE) - 1) & ~static_cast<openrasp::dat_value>(1 << INVALID_TYPE);
+    openrasp::request::RiskProfile &risk_profile = OPENRASP_G(request).get_risk_profile();
+    risk_profile.clear();
+    static const int track_vars[] = {TRACK_VARS_GET, TRACK_VARS_POST, TRACK_VARS_COOKIE};
+    for (int id : track_vars)
+    {
+        risk_profile.update(fetch_http_globals(id));
+    }
+    zval *files = fetch_http_globals(TRACK_VARS_FILES);
+    if (nullptr != files && Z_TYPE_P(files) == IS_ARRAY)
+    {
+        zval *file = nullptr;
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(files), file)
         {
-            zend_refcounted *val_ref = Z_COUNTED_P(val);
-            uintptr_t upt = reinterpret_cast<uintptr_t>(val_ref);
-            std::string name;
-            if (key != nullptr)
-            {
-                name = std::string(ZSTR_VAL(key));
-            }
-            else
+            if (Z_TYPE_P(file) == IS_ARRAY)
             {
-                zend_long actual = idx;
-                name = std::to_string(actual);
+                risk_profile.update(zend_hash_str_find(Z_ARRVAL_P(file), ZEND_STRL("name")), 1);
             }
-            OPENRASP_HOOK_G(zend_ref_items).insert({upt, openrasp::request::ZendRefItem(pairs[index].id, name)});
         }
         ZEND_HASH_FOREACH_END();
     }
+    zval *post = fetch_http_globals(TRACK_VARS_POST);
+    if (nullptr == post || Z_TYPE_P(post) != IS_ARRAY || zend_hash_num_elements(Z_ARRVAL_P(post)) == 0)
+    {
+        risk_profile.update_body(strtoul(OPENRASP_G(request).get_header("content-length").c_str(), nullptr, 10));
+    }
+    risk_profile.set_bypass((OPENRASP_HOOK_G(check_type_white_bit_mask) & all_check_types) == all_check_types);
+    if (openrasp::scm != nullptr && openrasp::scm->get_debug_level() != 0)
+    {
+        openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Risk profile of request (%s) is %s."),
+                       OPENRASP_G(request).url.get_complete_url().c_str(), risk_profile.to_string().c_str());
+    }
 }
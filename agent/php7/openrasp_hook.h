@@ -22,9 +22,10 @@
 #include "openrasp_v8.h"
 #include "openrasp_utils.h"
 #include "openrasp_lru.h"
+#include "utils/lru_key.h"
 #include "openrasp_check_type.h"
 #include "utils/string.h"
-#include "model/zend_ref_item.h"
+#include "model/input_index.h"
 #include "utils/double_array_trie.h"
 
 #ifdef __cplusplus
@@ -78,8 +79,85 @@ extern "C"
 #endif
 #endif
 
-#define OPENRASP_INTERNAL_FUNCTION_PARAMETERS INTERNAL_FUNCTION_PARAMETERS, OpenRASPCheckType check_type
-#define OPENRASP_INTERNAL_FUNCTION_PARAM_PASSTHRU INTERNAL_FUNCTION_PARAM_PASSTHRU, check_type
+/**
+ * 被 hook 函数的参数视图，fused_hook_dispatch 每次调用只构造一次，同一函数上的所有检测类型共用
+ * 取出的参数已解引用，未传入时返回 nullptr/false；类型转换与 zend_parse_parameters 相同，直接作用于原参数
+ */
+class HookArgs
+{
+public:
+    explicit HookArgs(zend_execute_data *execute_data)
+        : num_args(ZEND_CALL_NUM_ARGS(execute_data)),
+          args(num_args > 0 ? ZEND_CALL_ARG(execute_data, 1) : nullptr)
+    {
+    }
+    uint32_t size() const
+    {
+        return num_args;
+    }
+    zval *get(uint32_t i) const
+    {
+        if (i >= num_args)
+        {
+            return nullptr;
+        }
+        zval *arg = args + i;
+        ZVAL_DEREF(arg);
+        return arg;
+    }
+    //"s"
+    bool get_string(uint32_t i, zend_string *&value) const
+    {
+        zval *arg = get(i);
+        return nullptr != arg && zend_parse_arg_str(arg, &value, 0);
+    }
+    //"r"
+    bool get_resource(uint32_t i, zval *&value) const
+    {
+        zval *arg = get(i);
+        return nullptr != arg && zend_parse_arg_resource(arg, &value, 0);
+    }
+    //"a"，allow_object 为 true 时同 "A"
+    bool get_array(uint32_t i, zval *&value, bool allow_object = false) const
+    {
+        zval *arg = get(i);
+        return nullptr != arg && zend_parse_arg_array(arg, &value, 0, allow_object);
+    }
+    //以下用于可选参数，未传入时保持 value 不变并返回 true
+    //"|l"
+    bool optional_long(uint32_t i, zend_long &value) const
+    {
+        zend_bool is_null = 0;
+        zval *arg = get(i);
+        return nullptr == arg || zend_parse_arg_long(arg, &value, &is_null, 0, 0);
+    }
+    //"|b"
+    bool optional_bool(uint32_t i, zend_bool &value) const
+    {
+        zend_bool is_null = 0;
+        zval *arg = get(i);
+        return nullptr == arg || zend_parse_arg_bool(arg, &value, &is_null, 0);
+    }
+    //"|s"，allow_null 为 true 时同 "|s!"，传入 null 时 value 为 nullptr
+    bool optional_string(uint32_t i, zend_string *&value, bool allow_null = false) const
+    {
+        zval *arg = get(i);
+        return nullptr == arg || zend_parse_arg_str(arg, &value, allow_null);
+    }
+    //"|a!"，传入 null 时 value 为 nullptr
+    bool optional_array(uint32_t i, zval *&value) const
+    {
+        zval *arg = get(i);
+        return nullptr == arg || zend_parse_arg_array(arg, &value, 1, 0);
+    }
+
+private:
+    uint32_t num_args;
+    zval *args;
+};
+
+#define OPENRASP_INTERNAL_FUNCTION_PARAMETERS INTERNAL_FUNCTION_PARAMETERS, OpenRASPCheckType check_type, const HookArgs &hook_args
+#define OPENRASP_INTERNAL_FUNCTION_PARAM_PASSTHRU INTERNAL_FUNCTION_PARAM_PASSTHRU, check_type, hook_args
 
 #if (PHP_MAJOR_VERSION == 5) && (PHP_MINOR_VERSION < 4)
 #define OPENRASP_OP1_TYPE(n) ((n)->op1.op_type)
@@ -147,6 +225,7 @@ enum PathOperation
 
 typedef void (*hook_handler_t)();
 typedef void (*php_function)(INTERNAL_FUNCTION_PARAMETERS);
+typedef void (*fused_hook_t)(OPENRASP_INTERNAL_FUNCTION_PARAMETERS);
 /**
  * 使用这个宏定义被 hook 函数的替换函数的函数头部
  * 在函数体的适当位置添加 origin_function(INTERNAL_FUNCTION_PARAM_PASSTHRU); 可继续执行原始函数
@@ -205,23 +284,18 @@ typedef void (*php_function)(INTERNAL_FUNCTION_PARAMETERS);
 #define OPENRASP_HOOK_FUNCTION(name, type) \
     OPENRASP_HOOK_FUNCTION_PRIORITY(name, type, PriorityType::pNormal)
 
-#define HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)                        \
-    void pre_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS);        \
-    void post_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS);       \
-    OPENRASP_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)                   \
-    {                                                                                 \
-        bool pre_type_ignored = openrasp_check_type_ignored(type);                    \
-        if (!pre_type_ignored)                                                        \
-        {                                                                             \
-            pre_##scope##_##name##_##type(INTERNAL_FUNCTION_PARAM_PASSTHRU, (type));  \
-        }                                                                             \
-        origin_function(INTERNAL_FUNCTION_PARAM_PASSTHRU);                            \
-        bool post_type_ignored = openrasp_check_type_ignored(type);                   \
-        if (!post_type_ignored)                                                       \
-        {                                                                             \
-            post_##scope##_##name##_##type(INTERNAL_FUNCTION_PARAM_PASSTHRU, (type)); \
-        }                                                                             \
-    }
+/**
+ * 以下宏只登记 pre/post 检测函数，MINIT 时同一个函数的所有检测类型合并为一个包装函数，
+ * 按登记顺序的逆序执行 pre，调用原始函数后按登记顺序执行 post（与逐层包装时的顺序一致）
+ * pre/post 通过 hook_args 读取参数，不再各自调用 zend_parse_parameters
+ */
+#define FUSED_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority, pre, post)                                             \
+    int scope##_##name##_##type = []() {register_fused_hook(ZEND_TOSTR(scope), ZEND_TOSTR(name), type, priority, pre, post);return 0; }()
+
+#define HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)                  \
+    void pre_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS);  \
+    void post_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS); \
+    FUSED_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority, pre_##scope##_##name##_##type, post_##scope##_##name##_##type)
 
 #define HOOK_FUNCTION_EX(name, scope, type) \
     HOOK_FUNCTION_PRIORITY_EX(name, scope, type, PriorityType::pNormal)
@@ -232,17 +306,9 @@ typedef void (*php_function)(INTERNAL_FUNCTION_PARAMETERS);
 #define HOOK_FUNCTION(name, type) \
     HOOK_FUNCTION_PRIORITY(name, type, PriorityType::pNormal)
 
-#define PRE_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)                   \
-    void pre_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS);       \
-    OPENRASP_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)                  \
-    {                                                                                \
-        bool type_ignored = openrasp_check_type_ignored(type);                       \
-        if (!type_ignored)                                                           \
-        {                                                                            \
-            pre_##scope##_##name##_##type(INTERNAL_FUNCTION_PARAM_PASSTHRU, (type)); \
-        }                                                                            \
-        origin_function(INTERNAL_FUNCTION_PARAM_PASSTHRU);                           \
-    }
+#define PRE_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)             \
+    void pre_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS); \
+    FUSED_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority, pre_##scope##_##name##_##type, nullptr)
 
 #define PRE_HOOK_FUNCTION_EX(name, scope, type) \
     PRE_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, PriorityType::pNormal)
@@ -253,17 +319,9 @@ typedef void (*php_function)(INTERNAL_FUNCTION_PARAMETERS);
 #define PRE_HOOK_FUNCTION(name, type) \
     PRE_HOOK_FUNCTION_PRIORITY(name, type, PriorityType::pNormal)
 
-#define POST_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)                   \
-    void post_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS);       \
-    OPENRASP_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)                   \
-    {                                                                                 \
-        origin_function(INTERNAL_FUNCTION_PARAM_PASSTHRU);                            \
-        bool type_ignored = openrasp_check_type_ignored(type);                        \
-        if (!type_ignored)                                                            \
-        {                                                                             \
-            post_##scope##_##name##_##type(INTERNAL_FUNCTION_PARAM_PASSTHRU, (type)); \
-        }                                                                             \
-    }
+#define POST_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority)             \
+    void post_##scope##_##name##_##type(OPENRASP_INTERNAL_FUNCTION_PARAMETERS); \
+    FUSED_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, priority, nullptr, post_##scope##_##name##_##type)
 
 #define POST_HOOK_FUNCTION_EX(name, scope, type) \
     POST_HOOK_FUNCTION_PRIORITY_EX(name, scope, type, PriorityType::pNormal)
@@ -276,11 +334,18 @@ typedef void (*php_function)(INTERNAL_FUNCTION_PARAMETERS);
 
 ZEND_BEGIN_MODULE_GLOBALS(openrasp_hook)
 openrasp::dat_value check_type_white_bit_mask;
-openrasp::LRU<std::string, bool> lru;
+openrasp::LRU<openrasp::LruKey, bool> lru;
 long origin_pg_error_verbos;
 std::unordered_set<std::string> callable_blacklist;
 std::string echo_filter_regex;
-std::unordered_map<uintptr_t, const openrasp::request::ZendRefItem> zend_ref_items;
+openrasp::request::InputIndex input_index;
+long include_cache_lookups;
+long include_cache_hits;
+std::unordered_map<std::string, std::string> realpath_memo;
+long realpath_lookups;
+long realpath_cache_hits;
+long realpath_memo_hits;
+long realpath_fs_resolutions;
 ZEND_END_MODULE_GLOBALS(openrasp_hook)
 
 ZEND_EXTERN_MODULE_GLOBALS(openrasp_hook);
@@ -303,8 +368,11 @@ PHP_RSHUTDOWN_FUNCTION(openrasp_hook);
 typedef void (*fill_param_t)(HashTable *ht);
 
 std::string openrasp_real_path(const char *filename, int length, bool use_include_path, uint32_t w_op);
+//命令执行前调用，命令可能改变文件系统
+void openrasp_clear_realpath_memo();
 
 void register_hook_handler(hook_handler_t hook_handler, OpenRASPCheckType type, PriorityType::HookPriority hp = PriorityType::pNormal);
+void register_fused_hook(const char *scope, const char *name, OpenRASPCheckType type, PriorityType::HookPriority hp, fused_hook_t pre, fused_hook_t post);
 
 bool openrasp_zval_in_request(zval *item);
 bool fetch_name_in_request(zval *item, std::string &name, std::string &type);
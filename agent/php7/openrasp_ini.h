@@ -37,6 +37,7 @@ public:
   bool remote_management_enable = true;
   bool ssl_verifypeer = false;
   bool iast_enable = false;
+  bool taint_enable = false;
 
   static const char *APPID_REGEX;
   static const char *APPSECRET_REGEX;
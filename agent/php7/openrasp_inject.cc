@@ -16,18 +16,21 @@
 
 #include "openrasp_inject.h"
 #include "openrasp_ini.h"
+#include "utils/string_kernel.h"
 #include <string>
 #include <vector>
 #include <fstream>
 #include <chrono>
 #include <new>
+#include <memory>
 
 ZEND_DECLARE_MODULE_GLOBALS(openrasp_inject)
-std::vector<char> inject_html;
+//热加载时由 RINIT 替换，读取方持有自己的引用
+static std::shared_ptr<const std::vector<char>> inject_html;
 
 void openrasp_load_inject_html()
 {
-    std::vector<char> inject;
+    auto inject = std::make_shared<std::vector<char>>();
     char *path = nullptr;
     spprintf(&path, 0, "%s%cassets%cinject.html", openrasp_ini.root_dir, DEFAULT_SLASH, DEFAULT_SLASH);
     std::ifstream file(path, std::ios::binary | std::ios::ate);
@@ -36,10 +39,10 @@ void openrasp_load_inject_html()
     {
         std::streamsize size = file.tellg();
         file.seekg(0, std::ios::beg);
-        inject.resize(size);
-        file.read(inject.data(), size);
+        inject->resize(size);
+        file.read(inject->data(), size);
     }
-    inject_html = std::move(inject);
+    std::atomic_store(&inject_html, std::shared_ptr<const std::vector<char>>(std::move(inject)));
 }
 
 PHP_GINIT_FUNCTION(openrasp_inject)
@@ -96,7 +99,8 @@ PHP_RINIT_FUNCTION(openrasp_inject)
 }
 PHP_RSHUTDOWN_FUNCTION(openrasp_inject)
 {
-    if (inject_html.size())
+    auto html = std::atomic_load(&inject_html);
+    if (html && html->size())
     {
         bool is_match_inject_prefix = false;
         if (!OPENRASP_CONFIG(inject.urlprefix).empty())
@@ -107,7 +111,8 @@ PHP_RSHUTDOWN_FUNCTION(openrasp_inject)
                 zval *value;
                 if ((value = zend_hash_str_find(Z_ARRVAL(PG(http_globals)[TRACK_VARS_SERVER]), ZEND_STRL("REQUEST_URI"))) != NULL &&
                     Z_TYPE_P(value) == IS_STRING &&
-                    strncasecmp(Z_STRVAL_P(value), OPENRASP_CONFIG(inject.urlprefix).c_str(), OPENRASP_CONFIG(inject.urlprefix).length()) == 0)
+                    openrasp::kernel::starts_with_ignore_case(Z_STRVAL_P(value), Z_STRLEN_P(value),
+                                                              OPENRASP_CONFIG(inject.urlprefix).c_str(), OPENRASP_CONFIG(inject.urlprefix).length()))
                 {
                     is_match_inject_prefix = true;
                 }
@@ -117,7 +122,7 @@ PHP_RSHUTDOWN_FUNCTION(openrasp_inject)
         {
             if (strncasecmp(SG(sapi_headers).mimetype, "text/html", sizeof("text/html") - 1) == 0)
             {
-                php_output_write(inject_html.data(), inject_html.size());
+                php_output_write(html->data(), html->size());
             }
         }
     }
@@ -51,6 +51,11 @@ ZEND_EXTERN_MODULE_GLOBALS(openrasp_inject);
 // #define OPENRASP_INJECT_GP() (&openrasp_inject_globals)
 // #endif
 
+/**
+ * 读取 assets/inject.html，热加载时在 RINIT 中重新调用
+ */
+void openrasp_load_inject_html();
+
 PHP_MINIT_FUNCTION(openrasp_inject);
 PHP_MSHUTDOWN_FUNCTION(openrasp_inject);
 PHP_RINIT_FUNCTION(openrasp_inject);
@@ -2,22 +2,42 @@
 
 #include <unordered_map>
 #include <list>
+#include <string>
 #include <functional>
 
 namespace openrasp
 {
 
+inline size_t lru_key_hash(const std::string &key)
+{
+  return std::hash<std::string>{}(key);
+}
+
+inline bool lru_key_equals(const std::string &key, const std::string &bytes)
+{
+  return key == bytes;
+}
+
+inline std::string lru_key_bytes(const std::string &key)
+{
+  return key;
+}
+
+/**
+ * 按键的哈希索引，同时保存键的完整字节，命中时逐字节校验，哈希冲突视为未命中并在写入时替换
+ * 键类型需提供 lru_key_hash / lru_key_equals / lru_key_bytes
+ */
 template <typename T, typename U>
 class LRU
 {
 private:
   struct Item
   {
-    Item(size_t k, const U &v) : key_hash(k), value(v) {}
+    Item(size_t k, const std::string &b, const U &v) : key_hash(k), key_bytes(b), value(v) {}
     size_t key_hash;
+    std::string key_bytes;
     U value;
   };
-  std::hash<T> hasher;
   std::list<Item> item_list;
   std::unordered_map<size_t, typename list<Item>::iterator> item_map;
   size_t max;
@@ -40,9 +60,9 @@ public:
 
   typename list<Item>::iterator get(const T &key)
   {
-    size_t key_hash = hasher(key);
+    size_t key_hash = lru_key_hash(key);
     auto it = item_map.find(key_hash);
-    if (it != item_map.end())
+    if (it != item_map.end() && lru_key_equals(key, it->second->key_bytes))
     {
       reorder(it->second);
       return it->second;
@@ -58,10 +78,14 @@ public:
     {
       return;
     }
-    size_t key_hash = hasher(key);
+    size_t key_hash = lru_key_hash(key);
     auto it = item_map.find(key_hash);
     if (it != item_map.end())
     {
+      if (!lru_key_equals(key, it->second->key_bytes))
+      {
+        it->second->key_bytes = lru_key_bytes(key);
+      }
       if (it->second->value != value)
       {
         it->second->value = value;
@@ -70,7 +94,7 @@ public:
     }
     else
     {
-      item_list.emplace_front(key_hash, value);
+      item_list.emplace_front(key_hash, lru_key_bytes(key), value);
       auto it = item_list.begin();
       item_map.emplace(key_hash, it);
       reorder(it);
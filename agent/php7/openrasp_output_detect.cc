@@ -25,6 +25,9 @@
 #include "hook/data/response_object.h"
 #include "openrasp_content_type.h"
 #include "utils/sampler.h"
+#include "utils/content_prescan.h"
+#include "utils/string_kernel.h"
+#include <algorithm>
 #include <mutex>
 
 using namespace openrasp;
@@ -33,32 +36,59 @@ ZEND_DECLARE_MODULE_GLOBALS(openrasp_output_detect)
 
 Sampler sampler;
 std::mutex mtx;
+//插件截取命中位置前后 40 个字符作为 parts
+static const size_t prescan_padding = 64;
 
-static void _check_header_content_type_if_html(void *data, void *arg);
-static int _detect_param_occur_in_html_output(const char *param, OpenRASPActionType action);
 static bool _gpc_parameter_filter(const zval *param);
 static const char *get_content_type();
-static int check_xss(const char *content, size_t content_length, const char *content_type);
-static void check_sensitive_content(const char *content, size_t content_length, const char *content_type);
+static void output_stream_start(OutputStream &stream);
+static void collect_xss_candidates(OutputStream &stream);
+static int check_xss(OutputStream &stream, const char *content, size_t content_length);
+static void check_sensitive_content(OutputStream &stream, const char *content, size_t content_length);
+static void update_tail(OutputStream &stream, const char *content, size_t content_length);
+static void pass_output(php_output_context *output_context);
 
 static php_output_handler *openrasp_output_handler_init(const char *handler_name, size_t handler_name_len, size_t chunk_size, int flags);
 static void openrasp_clean_output_start(const char *name, size_t name_len);
 static int openrasp_output_handler(void **nothing, php_output_context *output_context);
 
+/**
+ * 输出每累积 response.chunk_size 字节调用一次（ob_flush 等也会触发），检测后立即向下传递，不再缓冲整个响应
+ * 拦截时已发送的块无法撤回，之后的输出全部丢弃；响应头未发送时仍会修改状态码与跳转地址
+ */
 static int openrasp_output_handler(void **nothing, php_output_context *output_context)
 {
     OUTPUT_G(output_detect) = true;
-    int status = FAILURE;
-    if ((output_context->op & PHP_OUTPUT_HANDLER_START) &&
-        (output_context->op & PHP_OUTPUT_HANDLER_FINAL))
+    auto &stream = OUTPUT_G(stream);
+    bool is_final = (output_context->op & PHP_OUTPUT_HANDLER_FINAL);
+    if (!stream.started)
+    {
+        output_stream_start(stream);
+    }
+    //被清除的输出不会发送，无需检测
+    if (!stream.blocked && !(output_context->op & PHP_OUTPUT_HANDLER_CLEAN))
+    {
+        const char *content = output_context->in.data;
+        size_t content_length = output_context->in.used;
+        check_sensitive_content(stream, content, content_length);
+        if (SUCCESS == check_xss(stream, content, content_length))
+        {
+            stream.blocked = true;
+            reset_response();
+        }
+        else if (!is_final)
+        {
+            update_tail(stream, content, content_length);
+        }
+        stream.sent_length += content_length;
+    }
+    if (!stream.blocked)
     {
-        auto content = output_context->in.data;
-        auto content_length = strnlen(output_context->in.data, output_context->in.size);
-        auto content_type = get_content_type();
-        check_sensitive_content(content, content_length, content_type);
-        status = check_xss(content, content_length, content_type);
+        pass_output(output_context);
     }
-    return status;
+    //仅在处理输出期间屏蔽 block_handle，分块发送后其他检测点仍可拦截
+    OUTPUT_G(output_detect) = is_final;
+    return SUCCESS;
 }
 
 static php_output_handler *openrasp_output_handler_init(const char *handler_name, size_t handler_name_len, size_t chunk_size, int flags)
@@ -67,7 +97,7 @@ static php_output_handler *openrasp_output_handler_init(const char *handler_name
     {
         return nullptr;
     }
-    return php_output_handler_create_internal(handler_name, handler_name_len, openrasp_output_handler, chunk_size, flags);
+    return php_output_handler_create_internal(handler_name, handler_name_len, openrasp_output_handler, OPENRASP_G(config).response.chunk_size, flags);
 }
 
 static void openrasp_clean_output_start(const char *name, size_t name_len)
@@ -92,16 +122,49 @@ static bool _gpc_parameter_filter(const zval *param)
     return false;
 }
 
-static int _detect_param_occur_in_html_output(const char *param, OpenRASPActionType action)
+static void pass_output(php_output_context *output_context)
 {
-    int status = FAILURE;
+    output_context->out.data = output_context->in.data;
+    output_context->out.used = output_context->in.used;
+    output_context->out.size = output_context->in.size;
+    output_context->out.free = output_context->in.free;
+    output_context->in.data = nullptr;
+    output_context->in.used = 0;
+    output_context->in.size = 0;
+    output_context->in.free = 0;
+}
+
+static void output_stream_start(OutputStream &stream)
+{
+    stream.started = true;
+    //首次调用之后响应头即被发送，content-type 不会再变化
+    stream.content_type = get_content_type();
+    stream.overlap_window = OPENRASP_G(config).response.overlap_window;
+    sampler.update(OPENRASP_G(config).response.sampler_interval, OPENRASP_G(config).response.sampler_burst);
+    stream.sensitive_pending = sampler.check();
+    collect_xss_candidates(stream);
+}
+
+static void collect_xss_candidates(OutputStream &stream)
+{
+    // no request input is long enough to be considered, see _gpc_parameter_filter
+    if (OPENRASP_G(request).get_risk_profile().get_max_input_length() <= OUTPUT_G(min_param_length))
+    {
+        return;
+    }
+    auto type = OpenRASPContentType::classify_content_type(stream.content_type);
+    if (OpenRASPContentType::cTextHtml != type && OpenRASPContentType::cNull != type)
+    {
+        return;
+    }
     if (Z_TYPE(PG(http_globals)[TRACK_VARS_GET]) != IS_ARRAY &&
         !zend_is_auto_global_str(ZEND_STRL("_GET")))
     {
-        return FAILURE;
+        return;
     }
     zval *global = &PG(http_globals)[TRACK_VARS_GET];
     int count = 0;
+    size_t max_length = 0;
     zval *val;
     zend_string *key;
     zend_ulong idx;
@@ -111,29 +174,39 @@ static int _detect_param_occur_in_html_output(const char *param, OpenRASPActionT
         {
             if (++count > OUTPUT_G(max_detection_num))
             {
-                continue;
+                break;
             }
-            if (NULL != strstr(param, Z_STRVAL_P(val)))
+            std::string name;
+            if (key != nullptr)
             {
-                std::string name;
-                if (key != nullptr)
-                {
-                    name = std::string(ZSTR_VAL(key));
-                }
-                else
-                {
-                    zend_long actual = idx;
-                    name = std::to_string(actual);
-                }
-                openrasp::data::XssUserInputObject xss_obj(name, val);
-                openrasp::checker::BuiltinDetector builtin_detector(xss_obj);
-                builtin_detector.run();
-                return SUCCESS;
+                name = std::string(ZSTR_VAL(key));
+            }
+            else
+            {
+                zend_long actual = idx;
+                name = std::to_string(actual);
             }
+            stream.xss_candidates.emplace_back(name, std::string(Z_STRVAL_P(val), Z_STRLEN_P(val)));
+            max_length = std::max(max_length, Z_STRLEN_P(val));
         }
     }
     ZEND_HASH_FOREACH_END();
-    return status;
+    if (max_length > 0)
+    {
+        stream.xss_window = std::min(max_length - 1, stream.overlap_window);
+    }
+}
+
+static const std::pair<std::string, std::string> *find_xss_candidate(const OutputStream &stream, const char *content, size_t content_length)
+{
+    for (const auto &candidate : stream.xss_candidates)
+    {
+        if (nullptr != kernel::find_bytes(content, content_length, candidate.second.data(), candidate.second.length()))
+        {
+            return &candidate;
+        }
+    }
+    return nullptr;
 }
 
 static const char *get_content_type()
@@ -145,7 +218,7 @@ static const char *get_content_type()
         {
             sapi_header_struct *sapi_header = (sapi_header_struct *)element->data;
             if (nullptr != sapi_header && sapi_header->header_len > sizeof("content-type:") - 1 &&
-                strncasecmp(sapi_header->header, "content-type:", sizeof("content-type:") - 1) == 0)
+                kernel::starts_with_ignore_case(sapi_header->header, sapi_header->header_len, ZEND_STRL("content-type:")))
             {
                 return sapi_header->header + sizeof("content-type:") - 1;
             }
@@ -154,34 +227,123 @@ static const char *get_content_type()
     return "";
 }
 
-static int check_xss(const char *content, size_t content_length, const char *content_type)
+static int check_xss(OutputStream &stream, const char *content, size_t content_length)
+{
+    if (stream.xss_candidates.empty())
+    {
+        return FAILURE;
+    }
+    auto found = find_xss_candidate(stream, content, content_length);
+    if (nullptr == found && stream.xss_window > 0 && !stream.tail.empty())
+    {
+        //块内已检测过，这里只需覆盖跨越上一块末尾的部分
+        size_t tail_length = std::min(stream.tail.length(), stream.xss_window);
+        std::string seam(stream.tail, stream.tail.length() - tail_length);
+        seam.append(content, std::min(content_length, stream.xss_window));
+        found = find_xss_candidate(stream, seam.data(), seam.length());
+    }
+    if (nullptr == found)
+    {
+        return FAILURE;
+    }
+    //与整体检测一致，每个响应只报告第一个命中的参数
+    auto candidate = *found;
+    stream.xss_candidates.clear();
+    OpenRASPActionType action = openrasp::scm->get_buildin_check_action(XSS_USER_INPUT);
+    zval value;
+    ZVAL_STRINGL(&value, candidate.second.c_str(), candidate.second.length());
+    {
+        openrasp::data::XssUserInputObject xss_obj(candidate.first, &value);
+        openrasp::checker::BuiltinDetector builtin_detector(xss_obj);
+        builtin_detector.run();
+    }
+    zval_ptr_dtor(&value);
+    return (AC_BLOCK == action) ? SUCCESS : FAILURE;
+}
+
+static void check_sensitive_content(OutputStream &stream, const char *content, size_t content_length)
 {
-    int status = FAILURE;
-    auto type = OpenRASPContentType::classify_content_type(content_type);
-    if (OpenRASPContentType::cTextHtml == type || OpenRASPContentType::cNull == type)
+    if (!stream.sensitive_pending || 0 == content_length)
+    {
+        return;
+    }
+    std::string window;
+    size_t base_offset = stream.sent_length;
+    if (!stream.tail.empty())
+    {
+        window.reserve(stream.tail.length() + content_length);
+        window.append(stream.tail).append(content, content_length);
+        content = window.data();
+        content_length = window.length();
+        base_offset -= stream.tail.length();
+    }
+    const auto &response_config = OPENRASP_G(config).response;
+    std::vector<ContentWindow> windows;
+    std::string fragments;
+    if (response_config.prescan_enable)
     {
-        OpenRASPActionType action = openrasp::scm->get_buildin_check_action(XSS_USER_INPUT);
-        status = _detect_param_occur_in_html_output(content, action);
-        if (status == SUCCESS)
+        ContentPrescan prescan(response_config.prescan_min_digits, prescan_padding, response_config.prescan_signatures);
+        windows = prescan.scan(content, content_length);
+        if (windows.empty())
         {
-            status = (AC_BLOCK == action) ? SUCCESS : FAILURE;
+            return;
         }
-        if (status == SUCCESS)
+        size_t covered = 0;
+        for (const auto &item : windows)
         {
-            reset_response();
+            covered += item.length;
+        }
+        //片段覆盖大部分内容时直接检测整块
+        if (covered * 2 > content_length)
+        {
+            windows.clear();
+        }
+        else
+        {
+            fragments.reserve(covered + windows.size());
+            for (auto &item : windows)
+            {
+                if (!fragments.empty())
+                {
+                    fragments.push_back('\n');
+                }
+                fragments.append(content + item.offset, item.length);
+                item.offset += base_offset;
+            }
         }
     }
-    return status;
+    data::ResponseObject data(windows.empty() ? content : fragments.data(),
+                              windows.empty() ? content_length : fragments.length(),
+                              stream.content_type.c_str(),
+                              windows.empty() ? nullptr : &windows);
+    checker::V8Detector checker(data, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis), false);
+    checker.run();
+    //插件只报告第一处命中，已报警的响应不再检测后续的块
+    if (checker.is_alarmed())
+    {
+        stream.sensitive_pending = false;
+    }
 }
 
-static void check_sensitive_content(const char *content, size_t content_length, const char *content_type)
+static void update_tail(OutputStream &stream, const char *content, size_t content_length)
 {
-    sampler.update(OPENRASP_G(config).response.sampler_interval, OPENRASP_G(config).response.sampler_burst);
-    if (sampler.check())
+    size_t window = stream.overlap_window;
+    if (0 == window ||
+        (stream.xss_candidates.empty() && !stream.sensitive_pending))
+    {
+        return;
+    }
+    if (content_length >= window)
     {
-        data::ResponseObject data(content, content_length, content_type);
-        checker::V8Detector checker(data, OPENRASP_HOOK_G(lru), OPENRASP_V8_G(isolate), OPENRASP_CONFIG(plugin.timeout.millis), false);
-        checker.run();
+        stream.tail.assign(content + content_length - window, window);
+    }
+    else
+    {
+        stream.tail.append(content, content_length);
+        if (stream.tail.length() > window)
+        {
+            stream.tail.erase(0, stream.tail.length() - window);
+        }
     }
 }
 
@@ -209,6 +371,7 @@ PHP_MINIT_FUNCTION(openrasp_output_detect)
 PHP_RINIT_FUNCTION(openrasp_output_detect)
 {
     OUTPUT_G(output_detect) = false;
+    OUTPUT_G(stream) = OutputStream();
     if (!openrasp_check_type_ignored(XSS_USER_INPUT))
     {
         openrasp_clean_output_start(ZEND_STRL("openrasp_ob_handler"));
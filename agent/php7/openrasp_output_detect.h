@@ -28,12 +28,36 @@ extern "C"
 #include "php_main.h"
 #include "php_output.h"
 }
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace openrasp
+{
+/**
+ * 输出按块检测时跨块保留的状态
+ * tail 为已检测输出末尾的最多 overlap_window 字节，与下一块拼接后检测跨块的内容
+ */
+struct OutputStream
+{
+  bool started = false;
+  bool blocked = false;
+  bool sensitive_pending = false;
+  std::string content_type;
+  std::vector<std::pair<std::string, std::string>> xss_candidates;
+  size_t xss_window = 0;
+  size_t overlap_window = 0;
+  size_t sent_length = 0;
+  std::string tail;
+};
+} // namespace openrasp
 
 ZEND_BEGIN_MODULE_GLOBALS(openrasp_output_detect)
 bool output_detect;
 std::string filter_regex;
 int64_t min_param_length = 15;
 int64_t max_detection_num = 10;
+openrasp::OutputStream stream;
 ZEND_END_MODULE_GLOBALS(openrasp_output_detect)
 
 ZEND_EXTERN_MODULE_GLOBALS(openrasp_output_detect);
@@ -0,0 +1,626 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "openrasp_taint.h"
+#include "openrasp_hook.h"
+#include "openrasp_ini.h"
+#include "openrasp_utils.h"
+#include "utils/string_kernel.h"
+#include <new>
+#include <algorithm>
+
+extern "C"
+{
+#include "Zend/zend_execute.h"
+}
+
+/**
+ * 轻量污点追踪，由 openrasp.taint_enable 开启
+ * 以 zend_string 地址为键记录来自用户输入的字节区间，并在拼接、sprintf、implode、str_replace、substr 中传递
+ * 记录只能证明“含有用户输入”：未覆盖的函数（如 trim、base64_decode）产生的字符串、表已满后新产生的字符串都查不到，
+ * 查不到只表示“未知”，不能据此跳过检测；字符串释放后记录不会被清理，查询时用长度与内容哈希排除地址复用
+ */
+
+using openrasp::taint::TaintSpan;
+using openrasp::taint::TaintedString;
+
+ZEND_DECLARE_MODULE_GLOBALS(openrasp_taint)
+
+static const size_t max_tainted_strings = 16 * 1024;
+static const int max_source_depth = 8;
+
+bool openrasp_taint_enabled()
+{
+    return openrasp_ini.taint_enable;
+}
+
+const TaintedString *openrasp_taint_lookup(zend_string *str)
+{
+    if (nullptr == str ||
+        ZSTR_IS_INTERNED(str) ||
+        OPENRASP_TAINT_G(strings).empty())
+    {
+        return nullptr;
+    }
+    auto found = OPENRASP_TAINT_G(strings).find(reinterpret_cast<uintptr_t>(str));
+    if (found == OPENRASP_TAINT_G(strings).end())
+    {
+        return nullptr;
+    }
+    if (found->second.length != ZSTR_LEN(str) ||
+        found->second.hash != zend_string_hash_val(str))
+    {
+        OPENRASP_TAINT_G(strings).erase(found);
+        return nullptr;
+    }
+    return &found->second;
+}
+
+static void taint_mark(zend_string *str, std::vector<TaintSpan> &&spans)
+{
+    if (nullptr == str ||
+        ZSTR_IS_INTERNED(str) ||
+        ZSTR_LEN(str) == 0)
+    {
+        return;
+    }
+    auto &strings = OPENRASP_TAINT_G(strings);
+    uintptr_t key = reinterpret_cast<uintptr_t>(str);
+    if (spans.empty())
+    {
+        strings.erase(key);
+        return;
+    }
+    //表满后不再记录，新字符串查不到时按“未知”处理，插件仍会做完整匹配
+    if (strings.size() >= max_tainted_strings &&
+        strings.find(key) == strings.end())
+    {
+        return;
+    }
+    TaintedString &tainted = strings[key];
+    tainted.length = ZSTR_LEN(str);
+    tainted.hash = zend_string_hash_val(str);
+    tainted.spans = std::move(spans);
+}
+
+static void taint_mark_source(zval *value, const char *source, const std::string &name, int depth)
+{
+    ZVAL_DEREF(value);
+    if (Z_TYPE_P(value) == IS_STRING)
+    {
+        taint_mark(Z_STR_P(value), std::vector<TaintSpan>{{0, Z_STRLEN_P(value), source, name}});
+    }
+    else if (Z_TYPE_P(value) == IS_ARRAY && depth < max_source_depth)
+    {
+        zend_string *key = nullptr;
+        zval *item = nullptr;
+        ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(value), key, item)
+        {
+            if (key)
+            {
+                taint_mark(key, std::vector<TaintSpan>{{0, ZSTR_LEN(key), source, name}});
+            }
+            taint_mark_source(item, source, name, depth + 1);
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+}
+
+static void taint_mark_request()
+{
+    static const struct
+    {
+        int id;
+        const char *source;
+    } pairs[] = {{TRACK_VARS_GET, "_GET"},
+                 {TRACK_VARS_POST, "_POST"},
+                 {TRACK_VARS_COOKIE, "_COOKIE"}};
+    for (const auto &pair : pairs)
+    {
+        zval *global = fetch_http_globals(pair.id);
+        if (nullptr == global || Z_TYPE_P(global) != IS_ARRAY)
+        {
+            continue;
+        }
+        zend_string *key = nullptr;
+        zend_ulong idx;
+        zval *value = nullptr;
+        ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(global), idx, key, value)
+        {
+            std::string name = key ? std::string(ZSTR_VAL(key), ZSTR_LEN(key)) : std::to_string(idx);
+            if (key)
+            {
+                taint_mark(key, std::vector<TaintSpan>{{0, ZSTR_LEN(key), pair.source, name}});
+            }
+            taint_mark_source(value, pair.source, name, 0);
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+    zval *server = fetch_http_globals(TRACK_VARS_SERVER);
+    if (nullptr != server && Z_TYPE_P(server) == IS_ARRAY)
+    {
+        zend_string *key = nullptr;
+        zval *value = nullptr;
+        ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(server), key, value)
+        {
+            if (nullptr == key || Z_TYPE_P(value) != IS_STRING)
+            {
+                continue;
+            }
+            std::string header_key = convert_to_header_key(ZSTR_VAL(key), ZSTR_LEN(key));
+            if (!header_key.empty())
+            {
+                taint_mark(Z_STR_P(value), std::vector<TaintSpan>{{0, Z_STRLEN_P(value), "header", header_key}});
+            }
+            else if (zend_string_equals_literal(key, "REQUEST_URI") ||
+                     zend_string_equals_literal(key, "QUERY_STRING"))
+            {
+                taint_mark(Z_STR_P(value), std::vector<TaintSpan>{{0, Z_STRLEN_P(value), "_SERVER", ZSTR_VAL(key)}});
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+}
+
+static bool taint_concat_spans(zend_string **parts, size_t count, std::vector<TaintSpan> &spans)
+{
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const TaintedString *tainted = openrasp_taint_lookup(parts[i]);
+        if (tainted)
+        {
+            for (const auto &span : tainted->spans)
+            {
+                spans.push_back({span.start + offset, span.end + offset, span.source, span.name});
+            }
+        }
+        offset += ZSTR_LEN(parts[i]);
+    }
+    return !spans.empty();
+}
+
+static zend_string *taint_concat_strings(zend_string **parts, size_t count)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (ZSTR_LEN(parts[i]) > SIZE_MAX - _ZSTR_STRUCT_SIZE(len))
+        {
+            return nullptr;
+        }
+        len += ZSTR_LEN(parts[i]);
+    }
+    zend_string *result = zend_string_alloc(len, 0);
+    char *target = ZSTR_VAL(result);
+    for (size_t i = 0; i < count; ++i)
+    {
+        memcpy(target, ZSTR_VAL(parts[i]), ZSTR_LEN(parts[i]));
+        target += ZSTR_LEN(parts[i]);
+    }
+    *target = '\0';
+    return result;
+}
+
+static zval *taint_get_zval_ptr(zend_execute_data *execute_data, zend_uchar op_type, const znode_op *node, zend_free_op *should_free)
+{
+#if (PHP_MAJOR_VERSION == 7 && PHP_MINOR_VERSION < 3)
+    return zend_get_zval_ptr(op_type, node, execute_data, should_free, BP_VAR_IS);
+#else
+    return zend_get_zval_ptr(EX(opline), op_type, node, execute_data, should_free, BP_VAR_IS);
+#endif
+}
+
+static zend_string *taint_fetch_string(zval *value)
+{
+    if (nullptr == value)
+    {
+        return nullptr;
+    }
+    ZVAL_DEREF(value);
+    return Z_TYPE_P(value) == IS_STRING ? Z_STR_P(value) : nullptr;
+}
+
+static void taint_free_op(zend_free_op free_op)
+{
+    if (free_op)
+    {
+        zval_ptr_dtor_nogc(free_op);
+    }
+}
+
+/**
+ * 拼接类 opcode 只在至少一个操作数被标记、且操作数均为字符串时接管，其余情况交回原 handler
+ * 因此不会改变类型转换、notice 与异常的行为
+ */
+static int taint_concat_handler(zend_execute_data *execute_data)
+{
+    const zend_op *opline = EX(opline);
+    if (OPENRASP_TAINT_G(strings).empty())
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zend_free_op free_op1 = nullptr;
+    zend_free_op free_op2 = nullptr;
+    zend_string *parts[2];
+    parts[0] = taint_fetch_string(taint_get_zval_ptr(execute_data, opline->op1_type, &opline->op1, &free_op1));
+    parts[1] = taint_fetch_string(taint_get_zval_ptr(execute_data, opline->op2_type, &opline->op2, &free_op2));
+    std::vector<TaintSpan> spans;
+    if (nullptr == parts[0] ||
+        nullptr == parts[1] ||
+        !taint_concat_spans(parts, 2, spans))
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zend_string *result = taint_concat_strings(parts, 2);
+    if (nullptr == result)
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    taint_free_op(free_op1);
+    taint_free_op(free_op2);
+    ZVAL_NEW_STR(EX_VAR(opline->result.var), result);
+    taint_mark(result, std::move(spans));
+    EX(opline) = opline + 1;
+    return ZEND_USER_OPCODE_CONTINUE;
+}
+
+static int taint_rope_end_handler(zend_execute_data *execute_data)
+{
+    const zend_op *opline = EX(opline);
+    if (OPENRASP_TAINT_G(strings).empty())
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zend_free_op free_op2 = nullptr;
+    zend_string *last = taint_fetch_string(taint_get_zval_ptr(execute_data, opline->op2_type, &opline->op2, &free_op2));
+    if (nullptr == last)
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zend_string **rope = reinterpret_cast<zend_string **>(EX_VAR(opline->op1.var));
+    std::vector<zend_string *> parts(rope, rope + opline->extended_value);
+    parts.push_back(last);
+    std::vector<TaintSpan> spans;
+    if (!taint_concat_spans(parts.data(), parts.size(), spans))
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zend_string *result = taint_concat_strings(parts.data(), parts.size());
+    if (nullptr == result)
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    for (uint32_t i = 0; i < opline->extended_value; ++i)
+    {
+        zend_string_release(parts[i]);
+    }
+    taint_free_op(free_op2);
+    ZVAL_NEW_STR(EX_VAR(opline->result.var), result);
+    taint_mark(result, std::move(spans));
+    EX(opline) = opline + 1;
+    return ZEND_USER_OPCODE_CONTINUE;
+}
+
+static int taint_assign_concat_handler(zend_execute_data *execute_data)
+{
+    const zend_op *opline = EX(opline);
+#if (PHP_MAJOR_VERSION == 7 && PHP_MINOR_VERSION < 4)
+    // ZEND_ASSIGN_DIM / ZEND_ASSIGN_OBJ
+    bool plain_var = opline->extended_value == 0;
+#else
+    bool plain_var = opline->extended_value == ZEND_CONCAT;
+#endif
+    if (!plain_var ||
+        opline->op1_type != IS_CV ||
+        OPENRASP_TAINT_G(strings).empty())
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zval *var = EX_VAR(opline->op1.var);
+    if (Z_TYPE_P(var) != IS_STRING)
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zend_free_op free_op2 = nullptr;
+    zend_string *parts[2];
+    parts[0] = Z_STR_P(var);
+    parts[1] = taint_fetch_string(taint_get_zval_ptr(execute_data, opline->op2_type, &opline->op2, &free_op2));
+    std::vector<TaintSpan> spans;
+    if (nullptr == parts[1] ||
+        !taint_concat_spans(parts, 2, spans))
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    zend_string *result = taint_concat_strings(parts, 2);
+    if (nullptr == result)
+    {
+        return ZEND_USER_OPCODE_DISPATCH;
+    }
+    taint_free_op(free_op2);
+    zval_ptr_dtor_nogc(var);
+    ZVAL_NEW_STR(var, result);
+    if (opline->result_type != IS_UNUSED)
+    {
+        ZVAL_COPY(EX_VAR(opline->result.var), var);
+    }
+    taint_mark(result, std::move(spans));
+    EX(opline) = opline + 1;
+    return ZEND_USER_OPCODE_CONTINUE;
+}
+
+/**
+ * 无法精确计算偏移时，在结果中查找被标记的片段，找不到则整个结果视为被标记
+ */
+static void taint_inherit(zend_string *result, zend_string *input, std::vector<TaintSpan> &spans)
+{
+    const TaintedString *tainted = openrasp_taint_lookup(input);
+    if (nullptr == tainted || input == result)
+    {
+        return;
+    }
+    const char *haystack = ZSTR_VAL(result);
+    for (const auto &span : tainted->spans)
+    {
+        size_t len = span.end - span.start;
+        const char *found = len > 0 ? openrasp::kernel::find_bytes(haystack, ZSTR_LEN(result), ZSTR_VAL(input) + span.start, len) : nullptr;
+        if (found)
+        {
+            size_t start = found - haystack;
+            spans.push_back({start, start + len, span.source, span.name});
+        }
+        else
+        {
+            spans.push_back({0, ZSTR_LEN(result), span.source, span.name});
+        }
+    }
+}
+
+static void taint_inherit_zval(zend_string *result, zval *input, std::vector<TaintSpan> &spans)
+{
+    ZVAL_DEREF(input);
+    if (Z_TYPE_P(input) == IS_STRING)
+    {
+        taint_inherit(result, Z_STR_P(input), spans);
+    }
+    else if (Z_TYPE_P(input) == IS_ARRAY)
+    {
+        zval *item = nullptr;
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(input), item)
+        {
+            zend_string *str = taint_fetch_string(item);
+            if (str)
+            {
+                taint_inherit(result, str, spans);
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+}
+
+static void taint_propagate_args(INTERNAL_FUNCTION_PARAMETERS)
+{
+    if (OPENRASP_TAINT_G(strings).empty())
+    {
+        return;
+    }
+    zend_string *result = Z_STR_P(return_value);
+    std::vector<TaintSpan> spans;
+    for (uint32_t i = 1; i <= ZEND_NUM_ARGS(); ++i)
+    {
+        taint_inherit_zval(result, ZEND_CALL_ARG(execute_data, i), spans);
+    }
+    if (!spans.empty())
+    {
+        taint_mark(result, std::move(spans));
+    }
+}
+
+static void taint_propagate_substr(INTERNAL_FUNCTION_PARAMETERS)
+{
+    if (ZEND_NUM_ARGS() < 2)
+    {
+        return;
+    }
+    zend_string *str = taint_fetch_string(ZEND_CALL_ARG(execute_data, 1));
+    zend_string *result = Z_STR_P(return_value);
+    const TaintedString *tainted = openrasp_taint_lookup(str);
+    if (nullptr == tainted || str == result || ZSTR_LEN(result) == 0)
+    {
+        return;
+    }
+    zend_long start = zval_get_long(ZEND_CALL_ARG(execute_data, 2));
+    if (start < 0)
+    {
+        start = std::max<zend_long>(0, static_cast<zend_long>(ZSTR_LEN(str)) + start);
+    }
+    size_t from = static_cast<size_t>(start);
+    size_t to = from + ZSTR_LEN(result);
+    std::vector<TaintSpan> spans;
+    if (to <= ZSTR_LEN(str) &&
+        memcmp(ZSTR_VAL(str) + from, ZSTR_VAL(result), ZSTR_LEN(result)) == 0)
+    {
+        for (const auto &span : tainted->spans)
+        {
+            size_t span_start = std::max(span.start, from);
+            size_t span_end = std::min(span.end, to);
+            if (span_start < span_end)
+            {
+                spans.push_back({span_start - from, span_end - from, span.source, span.name});
+            }
+        }
+    }
+    else
+    {
+        taint_inherit(result, str, spans);
+    }
+    if (!spans.empty())
+    {
+        taint_mark(result, std::move(spans));
+    }
+}
+
+static void taint_propagate_file_get_contents(INTERNAL_FUNCTION_PARAMETERS)
+{
+    zend_string *filename = ZEND_NUM_ARGS() > 0 ? taint_fetch_string(ZEND_CALL_ARG(execute_data, 1)) : nullptr;
+    if (filename && zend_string_equals_literal_ci(filename, "php://input"))
+    {
+        taint_mark(Z_STR_P(return_value), std::vector<TaintSpan>{{0, Z_STRLEN_P(return_value), "body", "php://input"}});
+    }
+}
+
+#define TAINT_HOOK_FUNCTION(name, propagator)                   \
+    static php_function origin_taint_##name = nullptr;          \
+    static void hook_taint_##name(INTERNAL_FUNCTION_PARAMETERS) \
+    {                                                           \
+        origin_taint_##name(INTERNAL_FUNCTION_PARAM_PASSTHRU);  \
+        if (Z_TYPE_P(return_value) == IS_STRING)                \
+        {                                                       \
+            propagator(INTERNAL_FUNCTION_PARAM_PASSTHRU);       \
+        }                                                       \
+    }
+
+#define TAINT_REPLACE_FUNCTION(name) \
+    taint_replace_function(ZEND_STRL(#name), hook_taint_##name, &origin_taint_##name)
+
+TAINT_HOOK_FUNCTION(sprintf, taint_propagate_args)
+TAINT_HOOK_FUNCTION(vsprintf, taint_propagate_args)
+TAINT_HOOK_FUNCTION(implode, taint_propagate_args)
+TAINT_HOOK_FUNCTION(join, taint_propagate_args)
+TAINT_HOOK_FUNCTION(str_replace, taint_propagate_args)
+TAINT_HOOK_FUNCTION(substr, taint_propagate_substr)
+TAINT_HOOK_FUNCTION(file_get_contents, taint_propagate_file_get_contents)
+
+static void taint_replace_function(const char *name, size_t len, php_function handler, php_function *origin)
+{
+    zend_function *function = static_cast<zend_function *>(zend_hash_str_find_ptr(CG(function_table), name, len));
+    if (function &&
+        function->type == ZEND_INTERNAL_FUNCTION &&
+        function->internal_function.handler != zif_display_disabled_function)
+    {
+        *origin = function->internal_function.handler;
+        function->internal_function.handler = handler;
+    }
+}
+
+void openrasp_taint_fill_params(v8::Isolate *isolate, v8::Local<v8::Object> params, zval *value)
+{
+    if (!openrasp_taint_enabled() ||
+        nullptr == value ||
+        Z_TYPE_P(value) != IS_STRING)
+    {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    zend_string *str = Z_STR_P(value);
+    const TaintedString *tainted = openrasp_taint_lookup(str);
+    if (nullptr == tainted)
+    {
+        //单字符字符串可能来自共享的驻留字符串，不作判断
+        if (ZSTR_LEN(str) == 0 || (ZSTR_IS_INTERNED(str) && ZSTR_LEN(str) > 1))
+        {
+            params->Set(context, openrasp::NewV8String(isolate, "tainted"), v8::False(isolate)).IsJust();
+        }
+        return;
+    }
+    params->Set(context, openrasp::NewV8String(isolate, "tainted"), v8::True(isolate)).IsJust();
+    std::vector<TaintSpan> spans(tainted->spans);
+    std::sort(spans.begin(), spans.end(), [](const TaintSpan &a, const TaintSpan &b) { return a.start < b.start; });
+    const char *data = ZSTR_VAL(str);
+    auto utf16_offset = [data](size_t byte_offset) {
+        size_t units = 0;
+        for (size_t i = 0; i < byte_offset; ++i)
+        {
+            unsigned char c = data[i];
+            if ((c & 0xC0) != 0x80)
+            {
+                units += c >= 0xF0 ? 2 : 1;
+            }
+        }
+        return units;
+    };
+    v8::Local<v8::Array> arr = v8::Array::New(isolate, spans.size());
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        v8::Local<v8::Object> obj = v8::Object::New(isolate);
+        obj->Set(context, openrasp::NewV8String(isolate, "source"), openrasp::NewV8String(isolate, spans[i].source)).IsJust();
+        obj->Set(context, openrasp::NewV8String(isolate, "name"), openrasp::NewV8String(isolate, spans[i].name)).IsJust();
+        obj->Set(context, openrasp::NewV8String(isolate, "start"), v8::Integer::New(isolate, static_cast<int>(utf16_offset(spans[i].start)))).IsJust();
+        obj->Set(context, openrasp::NewV8String(isolate, "end"), v8::Integer::New(isolate, static_cast<int>(utf16_offset(spans[i].end)))).IsJust();
+        arr->Set(context, i, obj).IsJust();
+    }
+    params->Set(context, openrasp::NewV8String(isolate, "taint_spans"), arr).IsJust();
+}
+
+PHP_GINIT_FUNCTION(openrasp_taint)
+{
+#ifdef ZTS
+    new (openrasp_taint_globals) _zend_openrasp_taint_globals;
+#endif
+}
+
+PHP_GSHUTDOWN_FUNCTION(openrasp_taint)
+{
+#ifdef ZTS
+    openrasp_taint_globals->~_zend_openrasp_taint_globals();
+#endif
+}
+
+PHP_MINIT_FUNCTION(openrasp_taint)
+{
+    ZEND_INIT_MODULE_GLOBALS(openrasp_taint, PHP_GINIT(openrasp_taint), PHP_GSHUTDOWN(openrasp_taint));
+    if (!openrasp_taint_enabled())
+    {
+        return SUCCESS;
+    }
+    zend_set_user_opcode_handler(ZEND_CONCAT, taint_concat_handler);
+    zend_set_user_opcode_handler(ZEND_FAST_CONCAT, taint_concat_handler);
+    zend_set_user_opcode_handler(ZEND_ROPE_END, taint_rope_end_handler);
+#if (PHP_MAJOR_VERSION == 7 && PHP_MINOR_VERSION < 4)
+    zend_set_user_opcode_handler(ZEND_ASSIGN_CONCAT, taint_assign_concat_handler);
+#else
+    zend_set_user_opcode_handler(ZEND_ASSIGN_OP, taint_assign_concat_handler);
+#endif
+    TAINT_REPLACE_FUNCTION(sprintf);
+    TAINT_REPLACE_FUNCTION(vsprintf);
+    TAINT_REPLACE_FUNCTION(implode);
+    TAINT_REPLACE_FUNCTION(join);
+    TAINT_REPLACE_FUNCTION(str_replace);
+    TAINT_REPLACE_FUNCTION(substr);
+    TAINT_REPLACE_FUNCTION(file_get_contents);
+    return SUCCESS;
+}
+
+PHP_MSHUTDOWN_FUNCTION(openrasp_taint)
+{
+    ZEND_SHUTDOWN_MODULE_GLOBALS(openrasp_taint, PHP_GSHUTDOWN(openrasp_taint));
+    return SUCCESS;
+}
+
+PHP_RINIT_FUNCTION(openrasp_taint)
+{
+    if (openrasp_taint_enabled())
+    {
+        taint_mark_request();
+    }
+    return SUCCESS;
+}
+
+PHP_RSHUTDOWN_FUNCTION(openrasp_taint)
+{
+    OPENRASP_TAINT_G(strings).clear();
+    return SUCCESS;
+}
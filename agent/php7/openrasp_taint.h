@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "openrasp.h"
+#include "openrasp_v8.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace openrasp
+{
+namespace taint
+{
+
+/**
+ * 字符串中来自用户输入的一段，[start, end) 为字节偏移
+ */
+struct TaintSpan
+{
+  size_t start;
+  size_t end;
+  std::string source;
+  std::string name;
+};
+
+struct TaintedString
+{
+  size_t length;
+  //标记时的内容哈希，查询时不一致说明原字符串已释放、地址被复用或内容被原地修改
+  zend_ulong hash;
+  std::vector<TaintSpan> spans;
+};
+
+} // namespace taint
+} // namespace openrasp
+
+ZEND_BEGIN_MODULE_GLOBALS(openrasp_taint)
+std::unordered_map<uintptr_t, openrasp::taint::TaintedString> strings;
+ZEND_END_MODULE_GLOBALS(openrasp_taint)
+
+ZEND_EXTERN_MODULE_GLOBALS(openrasp_taint);
+
+#define OPENRASP_TAINT_G(v) ZEND_MODULE_GLOBALS_ACCESSOR(openrasp_taint, v)
+
+PHP_MINIT_FUNCTION(openrasp_taint);
+PHP_MSHUTDOWN_FUNCTION(openrasp_taint);
+PHP_RINIT_FUNCTION(openrasp_taint);
+PHP_RSHUTDOWN_FUNCTION(openrasp_taint);
+
+bool openrasp_taint_enabled();
+const openrasp::taint::TaintedString *openrasp_taint_lookup(zend_string *str);
+/**
+ * 开启污点追踪时，向检测参数中写入 tainted 与 taint_spans（UTF-16 偏移，便于插件直接截取）
+ * 命中记录时 tainted 为 true；只有编译期常量字符串才确定不含用户输入，tainted 为 false；其余情况不写入 tainted
+ */
+void openrasp_taint_fill_params(v8::Isolate *isolate, v8::Local<v8::Object> params, zval *value);
@@ -22,6 +22,8 @@
 #include <string>
 #include <unordered_set>
 #include "utils/regex.h"
+#include "agent/shared_dns_manager.h"
+#include "agent/shared_config_manager.h"
 extern "C"
 {
 #include "php_ini.h"
@@ -487,4 +489,19 @@ bool maybe_ssrf_vulnerability(std::string protocol)
     }
     auto found = protocols.find(protocol);
     return found != protocols.end();
-}
\ No newline at end of file
+}
+
+openrasp::DnsStatus openrasp_lookup_host(const std::string &host, std::vector<std::string> &ips)
+{
+    if (openrasp::sdm != nullptr)
+    {
+        openrasp::DnsStatus status = openrasp::sdm->resolve(host, ips, OPENRASP_CONFIG(ssrf.dns_timeout_millis), OPENRASP_CONFIG(ssrf.dns_cache_ttl));
+        if (openrasp::scm != nullptr && openrasp::scm->get_debug_level() != 0)
+        {
+            openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("DNS lookup of %s returns status %d, shared DNS cache hits %ld, misses %ld."),
+                           host.c_str(), status, openrasp::sdm->get_hits(), openrasp::sdm->get_misses());
+        }
+        return status;
+    }
+    return openrasp::lookup_host(host, ips, OPENRASP_CONFIG(ssrf.dns_timeout_millis));
+}
@@ -19,6 +19,7 @@
 
 #include "openrasp.h"
 #include "utils/url.h"
+#include "utils/net.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -66,5 +67,6 @@ bool openrasp_call_user_function(HashTable *function_table, zval *object, const
 bool get_long_constant(const std::string &key, long &value);
 bool maybe_ssrf_vulnerability(zval *file);
 bool maybe_ssrf_vulnerability(std::string protcol);
+openrasp::DnsStatus openrasp_lookup_host(const std::string &host, std::vector<std::string> &ips);
 
 #endif
\ No newline at end of file
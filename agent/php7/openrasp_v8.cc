@@ -64,6 +64,98 @@ PHP_GSHUTDOWN_FUNCTION(openrasp_v8)
 #endif
 }
 
+/**
+ * 把快照中插件声明的内置动作、SQL 错误码等写入共享内存
+ */
+static void publish_snapshot_settings(Snapshot *snapshot, int64_t timestamp)
+{
+    std::map<OpenRASPCheckType, OpenRASPActionType> type_action_map;
+    std::map<std::string, std::string> buildin_action_map = CheckTypeTransfer::instance().get_buildin_action_map();
+    Isolate *isolate = Isolate::New(snapshot, timestamp);
+    extract_buildin_action(isolate, buildin_action_map);
+    for (auto iter = buildin_action_map.begin(); iter != buildin_action_map.end(); iter++)
+    {
+        type_action_map.insert({CheckTypeTransfer::instance().name_to_type(iter->first), string_to_action(iter->second)});
+    }
+    openrasp::scm->set_buildin_check_action(type_action_map);
+    openrasp::scm->set_mysql_error_codes(extract_int64_array(isolate, "RASP.algorithmConfig.sql_exception.mysql.error_code", SharedConfigBlock::MYSQL_ERROR_CODE_MAX_SIZE));
+    openrasp::scm->set_sqlite_error_codes(extract_int64_array(isolate, "RASP.algorithmConfig.sql_exception.sqlite.error_code", SharedConfigBlock::SQLITE_ERROR_CODE_MAX_SIZE));
+    openrasp::scm->build_pg_error_array(isolate);
+    openrasp::scm->build_env_key_array(isolate);
+    isolate->Dispose();
+}
+
+static std::string snapshot_file_path()
+{
+    return std::string(openrasp_ini.root_dir) + DEFAULT_SLASH + std::string("snapshot.dat");
+}
+
+/**
+ * 加载其他进程生成的快照文件，失败时保留当前快照
+ */
+static void adopt_snapshot_file(uint64_t timestamp)
+{
+    if (timestamp > 0 &&
+        (!process_globals.snapshot_blob ||
+         process_globals.snapshot_blob->IsExpired(timestamp)))
+    {
+        std::unique_lock<std::mutex> lock(process_globals.mtx, std::try_to_lock);
+        if (lock &&
+            (!process_globals.snapshot_blob ||
+             process_globals.snapshot_blob->IsExpired(timestamp)))
+        {
+            Snapshot *blob = new Snapshot(snapshot_file_path(), timestamp);
+            if (!blob->IsOk())
+            {
+                delete blob;
+            }
+            else
+            {
+                delete process_globals.snapshot_blob;
+                process_globals.snapshot_blob = blob;
+                OPENRASP_HOOK_G(lru).clear();
+            }
+        }
+    }
+}
+
+namespace openrasp
+{
+bool rebuild_snapshot(int64_t timestamp)
+{
+    std::vector<PluginFile> plugin_src_list = read_plugins();
+    Platform::Get()->Startup();
+    Snapshot snapshot(process_globals.plugin_config, plugin_src_list, OpenRASPInfo::PHP_OPENRASP_VERSION, timestamp, nullptr);
+    if (!snapshot.IsOk())
+    {
+        Platform::Get()->Shutdown();
+        openrasp_error(LEVEL_WARNING, PLUGIN_ERROR, _("Fail to reload plugins, keep the previous ones."));
+        return false;
+    }
+    //先写临时文件再改名，其他进程不会读到写了一半的快照
+    std::string filename = snapshot_file_path();
+    std::string tmp_filename = filename + ".tmp";
+#ifndef _WIN32
+    mode_t oldmask = umask(0);
+#endif
+    bool saved = snapshot.Save(tmp_filename) && rename(tmp_filename.c_str(), filename.c_str()) == 0;
+#ifndef _WIN32
+    umask(oldmask);
+#endif
+    if (!saved)
+    {
+        Platform::Get()->Shutdown();
+        openrasp_error(LEVEL_WARNING, PLUGIN_ERROR, _("Fail to write snapshot to %s, cuz of %s."),
+                       filename.c_str(), strerror(errno));
+        unlink(tmp_filename.c_str());
+        return false;
+    }
+    publish_snapshot_settings(&snapshot, timestamp);
+    Platform::Get()->Shutdown();
+    return true;
+}
+} // namespace openrasp
+
 PHP_MINIT_FUNCTION(openrasp_v8)
 {
     ZEND_INIT_MODULE_GLOBALS(openrasp_v8, PHP_GINIT(openrasp_v8), PHP_GSHUTDOWN(openrasp_v8));
@@ -97,22 +189,9 @@ PHP_MINIT_FUNCTION(openrasp_v8)
         else
         {
             process_globals.snapshot_blob = snapshot;
-            std::map<OpenRASPCheckType, OpenRASPActionType> type_action_map;
-            std::map<std::string, std::string> buildin_action_map = CheckTypeTransfer::instance().get_buildin_action_map();
             auto duration = std::chrono::system_clock::now().time_since_epoch();
             auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-            Isolate *isolate = Isolate::New(snapshot, millis);
-            extract_buildin_action(isolate, buildin_action_map);
-            for (auto iter = buildin_action_map.begin(); iter != buildin_action_map.end(); iter++)
-            {
-                type_action_map.insert({CheckTypeTransfer::instance().name_to_type(iter->first), string_to_action(iter->second)});
-            }
-            openrasp::scm->set_buildin_check_action(type_action_map);
-            openrasp::scm->set_mysql_error_codes(extract_int64_array(isolate, "RASP.algorithmConfig.sql_exception.mysql.error_code", SharedConfigBlock::MYSQL_ERROR_CODE_MAX_SIZE));
-            openrasp::scm->set_sqlite_error_codes(extract_int64_array(isolate, "RASP.algorithmConfig.sql_exception.sqlite.error_code", SharedConfigBlock::SQLITE_ERROR_CODE_MAX_SIZE));
-            openrasp::scm->build_pg_error_array(isolate);
-            openrasp::scm->build_env_key_array(isolate);
-            isolate->Dispose();
+            publish_snapshot_settings(snapshot, millis);
         }
         Platform::Get()->Shutdown();
     }
@@ -139,32 +218,14 @@ PHP_RINIT_FUNCTION(openrasp_v8)
 #ifdef HAVE_OPENRASP_REMOTE_MANAGER
     if (openrasp_ini.remote_management_enable && oam != nullptr)
     {
-        uint64_t timestamp = oam->get_plugin_update_timestamp();
-        if (timestamp > 0 &&
-            (!process_globals.snapshot_blob ||
-             process_globals.snapshot_blob->IsExpired(timestamp)))
-        {
-            std::unique_lock<std::mutex> lock(process_globals.mtx, std::try_to_lock);
-            if (lock &&
-                (!process_globals.snapshot_blob ||
-                 process_globals.snapshot_blob->IsExpired(timestamp)))
-            {
-                std::string filename = std::string(openrasp_ini.root_dir) + DEFAULT_SLASH + std::string("snapshot.dat");
-                Snapshot *blob = new Snapshot(filename, timestamp);
-                if (!blob->IsOk())
-                {
-                    delete blob;
-                }
-                else
-                {
-                    delete process_globals.snapshot_blob;
-                    process_globals.snapshot_blob = blob;
-                    OPENRASP_HOOK_G(lru).clear();
-                }
-            }
-        }
+        adopt_snapshot_file(oam->get_plugin_update_timestamp());
     }
+    else
 #endif
+    {
+        //本地模式热加载后的快照
+        adopt_snapshot_file(openrasp::scm->get_reload_snapshot_timestamp());
+    }
     if (process_globals.snapshot_blob)
     {
         if (!OPENRASP_V8_G(isolate) || OPENRASP_V8_G(isolate)->IsExpired(process_globals.snapshot_blob->timestamp))
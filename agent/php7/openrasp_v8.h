@@ -41,6 +41,13 @@ std::vector<int64_t> extract_int64_array(Isolate *isolate, const std::string &va
 std::vector<std::string> extract_string_array(Isolate *isolate, const std::string &value, int limit, const std::vector<std::string> &default_value = std::vector<std::string>());
 int64_t extract_int64(Isolate *isolate, const std::string &value, const int64_t &default_value);
 std::string extract_string(Isolate *isolate, const std::string &value, const std::string &default_value);
+/**
+ * 重新读取插件目录并生成快照文件，同时更新共享内存中由插件决定的配置；失败时不影响当前快照
+ * 不修改 process_globals，只在本地模式热加载的构建进程中调用
+ */
+bool rebuild_snapshot(int64_t timestamp);
+//只读取插件目录，不修改 process_globals
+std::vector<PluginFile> read_plugins();
 void load_plugins();
 void plugin_log(const std::string &message);
 } // namespace openrasp
@@ -159,7 +159,7 @@ static void header_getter(v8::Local<v8::Name> name, const v8::PropertyCallbackIn
     v8::Isolate *isolate = info.GetIsolate();
     auto context = isolate->GetCurrentContext();
     v8::Local<v8::Object> obj = v8::Object::New(isolate);
-    std::map<std::string, std::string> headers = OPENRASP_G(request).get_header();
+    const std::map<std::string, std::string> &headers = OPENRASP_G(request).get_header();
     for (auto iter = headers.begin(); iter != headers.end(); iter++)
     {
         obj->Set(context, NewV8String(isolate, iter->first), NewV8String(isolate, iter->second)).IsJust();
@@ -169,43 +169,20 @@ static void header_getter(v8::Local<v8::Name> name, const v8::PropertyCallbackIn
 static void body_getter(v8::Local<v8::Name> name, const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     info.GetReturnValue().Set(v8::ArrayBuffer::New(info.GetIsolate(), nullptr, 0, v8::ArrayBufferCreationMode::kInternalized));
-
-    php_stream *stream = php_stream_open_wrapper("php://input", "rb", 0, nullptr);
-    if (!stream)
+    //与报警日志共用同一份请求体，上限为 body.maxbytes
+    const std::string &raw_body = OPENRASP_G(request).get_parameter().get_raw_body();
+    if (raw_body.empty())
     {
         return;
     }
-
-    size_t len = 0, maxlen = 4 * 1024;
-    char *buffer = (char *)malloc(maxlen);
-    char *ptr = buffer;
-    while ((len < maxlen) && !php_stream_eof(stream))
-    {
-        size_t ret = php_stream_read(stream, ptr, maxlen - len);
-        if (!ret)
-        {
-            break;
-        }
-        len += ret;
-        ptr += ret;
-    }
-    if (len)
-    {
-        *ptr = '\0';
-    }
-    else
-    {
-        free(buffer);
-        buffer = nullptr;
-    }
-
-    stream->is_persistent ? php_stream_pclose(stream) : php_stream_close(stream);
+    char *buffer = (char *)malloc(raw_body.length());
     if (!buffer)
     {
         return;
     }
+    memcpy(buffer, raw_body.data(), raw_body.length());
     v8::Isolate *isolate = info.GetIsolate();
-    v8::Local<v8::ArrayBuffer> arraybuffer = v8::ArrayBuffer::New(isolate, buffer, MIN(len, maxlen), v8::ArrayBufferCreationMode::kInternalized);
+    v8::Local<v8::ArrayBuffer> arraybuffer = v8::ArrayBuffer::New(isolate, buffer, raw_body.length(), v8::ArrayBufferCreationMode::kInternalized);
     info.GetReturnValue().Set(arraybuffer);
 }
 static void server_getter(v8::Local<v8::Name> name, const v8::PropertyCallbackInfo<v8::Value> &info)
@@ -255,15 +232,27 @@ static void json_body_getter(v8::Local<v8::Name> name, const v8::PropertyCallbac
                        OPENRASP_G(request).get_id().c_str(), Z_STRVAL_P(origin_zv));
         std::string content_type_vlaue = std::string(Z_STRVAL_P(origin_zv));
         OpenRASPContentType::ContentType k_type = OpenRASPContentType::classify_content_type(content_type_vlaue);
-        zend_string *body = nullptr;
-        if (OpenRASPContentType::ContentType::cApplicationJson == k_type &&
-            (body = fetch_request_body(PHP_STREAM_COPY_ALL)) != nullptr)
+        if (OpenRASPContentType::ContentType::cApplicationJson == k_type)
         {
-            if (ZSTR_LEN(body) > 0)
+            //请求体不超过 body.maxbytes 时直接复用已读取的内容，否则仍需完整读取才能解析
+            bool complete = false;
+            const std::string &raw_body = OPENRASP_G(request).get_parameter().get_raw_body(&complete);
+            zend_string *body = nullptr;
+            if (complete)
+            {
+                if (!raw_body.empty())
+                {
+                    complete_body = std::string(raw_body.c_str());
+                }
+            }
+            else if ((body = fetch_request_body(PHP_STREAM_COPY_ALL)) != nullptr)
             {
-                complete_body = std::string(ZSTR_VAL(body));
+                if (ZSTR_LEN(body) > 0)
+                {
+                    complete_body = std::string(ZSTR_VAL(body));
+                }
+                zend_string_release(body);
             }
-            zend_string_release(body);
         }
     }
     openrasp_error(LEVEL_DEBUG, RUNTIME_ERROR, _("Complete body of request (%s) is %s."),
@@ -233,7 +233,7 @@ void alarm_info(Isolate *isolate, v8::Local<v8::String> type, v8::Local<v8::Obje
     }
 }
 
-void load_plugins()
+std::vector<PluginFile> read_plugins()
 {
     std::vector<PluginFile> plugin_src_list;
     std::string plugin_path(std::string(openrasp_ini.root_dir) + DEFAULT_SLASH + std::string("plugins"));
@@ -270,7 +270,14 @@ void load_plugins()
         free(ent[i]);
     }
     free(ent);
-    process_globals.plugin_src_list = plugin_src_list;
+    return plugin_src_list;
+}
+
+void load_plugins()
+{
+    std::vector<PluginFile> plugin_src_list = read_plugins();
+    std::lock_guard<std::mutex> lock(process_globals.mtx);
+    process_globals.plugin_src_list = std::move(plugin_src_list);
 }
 
 void extract_buildin_action(Isolate *isolate, std::map<std::string, std::string> &buildin_action_map)
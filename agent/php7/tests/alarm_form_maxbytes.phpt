@@ -0,0 +1,29 @@
+--TEST--
+alarm form (truncated at body.maxbytes)
+--SKIPIF--
+<?php
+$conf = <<<CONF
+body.maxbytes: 32
+CONF;
+$plugin = <<<EOF
+plugin.register('command', params => {
+    assert(params.command == 'echo test')
+    return {action: 'log'}
+})
+EOF;
+include(__DIR__.'/skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--CGI--
+--POST--
+a=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+--FILE--
+<?php
+include(__DIR__.'/timezone.inc');
+header('Content-type: text/plain');
+exec('echo test');
+passthru('tail -n 1 /tmp/openrasp/logs/alarm/alarm.log.'.date("Y-m-d"));
+?>
+--EXPECTREGEX--
+.*"form":"\{\\"a\\":\\"x{24}\\"\}".*
@@ -0,0 +1,27 @@
+--TEST--
+alarm json (unpaired high surrogate is rejected)
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('command', params => {
+    assert(params.command == 'echo test')
+    return {action: 'log'}
+})
+EOF;
+include(__DIR__.'/skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--CGI--
+--POST_RAW--
+Content-Type: application/json
+{"a":"\uD800\u0041"}
+--FILE--
+<?php
+include(__DIR__.'/timezone.inc');
+header('Content-type: text/plain');
+exec('echo test');
+passthru('tail -n 1 /tmp/openrasp/logs/alarm/alarm.log.'.date("Y-m-d"));
+?>
+--EXPECTREGEX--
+.*"json":"\{\}".*
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * DoubleArrayTrie 构建与查询的微基准，不依赖 PHP，单独编译运行：
+ *   mkdir -p /tmp/dat && cp utils/double_array_trie.h /tmp/dat/
+ *   g++ -std=c++11 -O2 -I/tmp/dat tests/bench/double_array_trie_bench.cc -o /tmp/dat/bench && /tmp/dat/bench
+ * （utils/string.h 会遮蔽系统的 <string.h>，因此不能直接 -Iutils）
+ */
+
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include "double_array_trie.h"
+
+using openrasp::DoubleArrayTrie;
+
+static std::vector<std::string> make_keys(size_t n, std::mt19937 &rng)
+{
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        std::string key;
+        size_t len = 6 + rng() % 20;
+        for (size_t j = 0; j < len; ++j)
+        {
+            key.push_back('a' + rng() % 26);
+        }
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+template <class Fn>
+static double ns_per_query(const std::vector<std::string> &queries, int rounds, Fn &&fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (const std::string &q : queries)
+        {
+            fn(q);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (rounds * queries.size());
+}
+
+int main()
+{
+    const int rounds = 10;
+    for (size_t n : {10000, 100000})
+    {
+        std::mt19937 rng(42);
+        std::vector<std::string> keys = make_keys(n, rng);
+        //查询串为 key 后追加随机后缀，保证每次查询至少命中一个前缀
+        std::vector<std::string> queries;
+        queries.reserve(keys.size());
+        for (const std::string &key : keys)
+        {
+            queries.push_back(key + "=" + std::to_string(rng()));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        DoubleArrayTrie dat;
+        int error = dat.build(keys.size(), &keys, 0, 0);
+        auto end = std::chrono::steady_clock::now();
+        double build_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+        size_t hits = 0;
+        double vector_ns = ns_per_query(queries, rounds, [&](const std::string &q) {
+            hits += dat.prefix_search(q.c_str(), q.length()).size();
+        });
+        double callback_ns = ns_per_query(queries, rounds, [&](const std::string &q) {
+            hits += dat.foreach_prefix(q.c_str(), q.length(), [](const DoubleArrayTrie::result_pair_type &) { return true; });
+        });
+        double buffer_ns = ns_per_query(queries, rounds, [&](const std::string &q) {
+            DoubleArrayTrie::result_pair_type results[8];
+            hits += dat.prefix_search(q.c_str(), q.length(), results, 8);
+        });
+        double longest_ns = ns_per_query(queries, rounds, [&](const std::string &q) {
+            hits += dat.longest_prefix(q.c_str(), q.length()).value != -1;
+        });
+
+        printf("keys=%zu error=%d size=%zu build=%.1fms vector=%.1fns callback=%.1fns buffer=%.1fns longest=%.1fns hits=%zu\n",
+               keys.size(), error, dat.total_size(), build_ms,
+               vector_ns, callback_ns, buffer_ns, longest_ns, hits);
+    }
+    return 0;
+}
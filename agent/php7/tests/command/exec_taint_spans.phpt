@@ -0,0 +1,34 @@
+--TEST--
+hook exec with taint tracking
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('command', params => {
+    assert(params.command == 'echo ab;id -n && ls')
+    assert(params.tainted === true)
+    assert(params.taint_spans.length == 2)
+    assert(params.taint_spans[0].source == '_GET')
+    assert(params.taint_spans[0].name == 'a')
+    assert(params.taint_spans[0].start == 5)
+    assert(params.taint_spans[0].end == 10)
+    assert(params.taint_spans[1].name == 'b')
+    assert(params.taint_spans[1].start == 11)
+    assert(params.taint_spans[1].end == 13)
+    return block
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+openrasp.taint_enable=on
+--GET--
+a=xab;idx&b=-n
+--FILE--
+<?php
+$cmd = 'echo ' . substr($_GET['a'], 1, 5);
+$cmd .= " {$_GET['b']}";
+exec(sprintf('%s && %s', $cmd, 'ls'));
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
@@ -0,0 +1,25 @@
+--TEST--
+hook exec with taint tracking (untracked transform is unknown, not clean)
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('command', params => {
+    assert(params.command == 'echo test;id')
+    assert(params.tainted === undefined)
+    assert(params.taint_spans === undefined)
+    return block
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+openrasp.taint_enable=on
+--GET--
+a=+echo+test;id+
+--FILE--
+<?php
+exec(trim($_GET['a']));
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
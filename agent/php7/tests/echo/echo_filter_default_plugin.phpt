@@ -0,0 +1,25 @@
+--TEST--
+hook echo_filter with the official plugin pattern
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+RASP.algorithmConfig = {
+     xss_echo: {
+        filter_regex: "<![\\\\-\\\\[A-Za-z]|<([A-Za-z]{1,12})[\\\\/>\\\\x00-\\\\x20]",
+        name:   '算法1 - PHP: 禁止直接输出 GPC 参数',
+        action: 'block'
+    }
+}
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--GET--
+a=<svg%09onload=alert(1)>
+--FILE--
+<?php
+echo $_GET['a'];
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
@@ -0,0 +1,27 @@
+--TEST--
+hook echo (GET parameter still recognized after nested POST flood)
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+RASP.algorithmConfig = {
+     xss_echo: {
+        name:   '算法1 - PHP: 禁止直接输出 GPC 参数',
+        action: 'block'
+    }
+}
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+max_input_vars=1000
+--GET--
+a=<b>test</b>
+--POST--
+p0[a][b][c][d][e]=xx&p1[a][b][c][d][e]=xx&p2[a][b][c][d][e]=xx&p3[a][b][c][d][e]=xx&p4[a][b][c][d][e]=xx&p5[a][b][c][d][e]=xx&p6[a][b][c][d][e]=xx&p7[a][b][c][d][e]=xx&p8[a][b][c][d][e]=xx&p9[a][b][c][d][e]=xx&p10[a][b][c][d][e]=xx&p11[a][b][c][d][e]=xx&p12[a][b][c][d][e]=xx&p13[a][b][c][d][e]=xx&p14[a][b][c][d][e]=xx&p15[a][b][c][d][e]=xx&p16[a][b][c][d][e]=xx&p17[a][b][c][d][e]=xx&p18[a][b][c][d][e]=xx&p19[a][b][c][d][e]=xx&p20[a][b][c][d][e]=xx&p21[a][b][c][d][e]=xx&p22[a][b][c][d][e]=xx&p23[a][b][c][d][e]=xx&p24[a][b][c][d][e]=xx&p25[a][b][c][d][e]=xx&p26[a][b][c][d][e]=xx&p27[a][b][c][d][e]=xx&p28[a][b][c][d][e]=xx&p29[a][b][c][d][e]=xx&p30[a][b][c][d][e]=xx&p31[a][b][c][d][e]=xx&p32[a][b][c][d][e]=xx&p33[a][b][c][d][e]=xx&p34[a][b][c][d][e]=xx&p35[a][b][c][d][e]=xx&p36[a][b][c][d][e]=xx&p37[a][b][c][d][e]=xx&p38[a][b][c][d][e]=xx&p39[a][b][c][d][e]=xx&p40[a][b][c][d][e]=xx&p41[a][b][c][d][e]=xx&p42[a][b][c][d][e]=xx&p43[a][b][c][d][e]=xx&p44[a][b][c][d][e]=xx&p45[a][b][c][d][e]=xx&p46[a][b][c][d][e]=xx&p47[a][b][c][d][e]=xx&p48[a][b][c][d][e]=xx&p49[a][b][c][d][e]=xx&p50[a][b][c][d][e]=xx&p51[a][b][c][d][e]=xx&p52[a][b][c][d][e]=xx&p53[a][b][c][d][e]=xx&p54[a][b][c][d][e]=xx&p55[a][b][c][d][e]=xx&p56[a][b][c][d][e]=xx&p57[a][b][c][d][e]=xx&p58[a][b][c][d][e]=xx&p59[a][b][c][d][e]=xx&p60[a][b][c][d][e]=xx&p61[a][b][c][d][e]=xx&p62[a][b][c][d][e]=xx&p63[a][b][c][d][e]=xx&p64[a][b][c][d][e]=xx&p65[a][b][c][d][e]=xx&p66[a][b][c][d][e]=xx&p67[a][b][c][d][e]=xx&p68[a][b][c][d][e]=xx&p69[a][b][c][d][e]=xx&p70[a][b][c][d][e]=xx&p71[a][b][c][d][e]=xx&p72[a][b][c][d][e]=xx&p73[a][b][c][d][e]=xx&p74[a][b][c][d][e]=xx&p75[a][b][c][d][e]=xx&p76[a][b][c][d][e]=xx&p77[a][b][c][d][e]=xx&p78[a][b][c][d][e]=xx&p79[a][b][c][d][e]=xx&p80[a][b][c][d][e]=xx&p81[a][b][c][d][e]=xx&p82[a][b][c][d][e]=xx&p83[a][b][c][d][e]=xx&p84[a][b][c][d][e]=xx&p85[a][b][c][d][e]=xx&p86[a][b][c][d][e]=xx&p87[a][b][c][d][e]=xx&p88[a][b][c][d][e]=xx&p89[a][b][c][d][e]=xx&p90[a][b][c][d][e]=xx&p91[a][b][c][d][e]=xx&p92[a][b][c][d][e]=xx&p93[a][b][c][d][e]=xx&p94[a][b][c][d][e]=xx&p95[a][b][c][d][e]=xx&p96[a][b][c][d][e]=xx&p97[a][b][c][d][e]=xx&p98[a][b][c][d][e]=xx&p99[a][b][c][d][e]=xx&p100[a][b][c][d][e]=xx&p101[a][b][c][d][e]=xx&p102[a][b][c][d][e]=xx&p103[a][b][c][d][e]=xx&p104[a][b][c][d][e]=xx&p105[a][b][c][d][e]=xx&p106[a][b][c][d][e]=xx&p107[a][b][c][d][e]=xx&p108[a][b][c][d][e]=xx&p109[a][b][c][d][e]=xx&p110[a][b][c][d][e]=xx&p111[a][b][c][d][e]=xx&p112[a][b][c][d][e]=xx&p113[a][b][c][d][e]=xx&p114[a][b][c][d][e]=xx&p115[a][b][c][d][e]=xx&p116[a][b][c][d][e]=xx&p117[a][b][c][d][e]=xx&p118[a][b][c][d][e]=xx&p119[a][b][c][d][e]=xx&p120[a][b][c][d][e]=xx&p121[a][b][c][d][e]=xx&p122[a][b][c][d][e]=xx&p123[a][b][c][d][e]=xx&p124[a][b][c][d][e]=xx&p125[a][b][c][d][e]=xx&p126[a][b][c][d][e]=xx&p127[a][b][c][d][e]=xx&p128[a][b][c][d][e]=xx&p129[a][b][c][d][e]=xx&p130[a][b][c][d][e]=xx&p131[a][b][c][d][e]=xx&p132[a][b][c][d][e]=xx&p133[a][b][c][d][e]=xx&p134[a][b][c][d][e]=xx&p135[a][b][c][d][e]=xx&p136[a][b][c][d][e]=xx&p137[a][b][c][d][e]=xx&p138[a][b][c][d][e]=xx&p139[a][b][c][d][e]=xx&p140[a][b][c][d][e]=xx&p141[a][b][c][d][e]=xx&p142[a][b][c][d][e]=xx&p143[a][b][c][d][e]=xx&p144[a][b][c][d][e]=xx&p145[a][b][c][d][e]=xx&p146[a][b][c][d][e]=xx&p147[a][b][c][d][e]=xx&p148[a][b][c][d][e]=xx&p149[a][b][c][d][e]=xx&p150[a][b][c][d][e]=xx&p151[a][b][c][d][e]=xx&p152[a][b][c][d][e]=xx&p153[a][b][c][d][e]=xx&p154[a][b][c][d][e]=xx&p155[a][b][c][d][e]=xx&p156[a][b][c][d][e]=xx&p157[a][b][c][d][e]=xx&p158[a][b][c][d][e]=xx&p159[a][b][c][d][e]=xx&p160[a][b][c][d][e]=xx&p161[a][b][c][d][e]=xx&p162[a][b][c][d][e]=xx&p163[a][b][c][d][e]=xx&p164[a][b][c][d][e]=xx&p165[a][b][c][d][e]=xx&p166[a][b][c][d][e]=xx&p167[a][b][c][d][e]=xx&p168[a][b][c][d][e]=xx&p169[a][b][c][d][e]=xx&p170[a][b][c][d][e]=xx&p171[a][b][c][d][e]=xx&p172[a][b][c][d][e]=xx&p173[a][b][c][d][e]=xx&p174[a][b][c][d][e]=xx&p175[a][b][c][d][e]=xx&p176[a][b][c][d][e]=xx&p177[a][b][c][d][e]=xx&p178[a][b][c][d][e]=xx&p179[a][b][c][d][e]=xx&p180[a][b][c][d][e]=xx&p181[a][b][c][d][e]=xx&p182[a][b][c][d][e]=xx&p183[a][b][c][d][e]=xx&p184[a][b][c][d][e]=xx&p185[a][b][c][d][e]=xx&p186[a][b][c][d][e]=xx&p187[a][b][c][d][e]=xx&p188[a][b][c][d][e]=xx&p189[a][b][c][d][e]=xx&p190[a][b][c][d][e]=xx&p191[a][b][c][d][e]=xx&p192[a][b][c][d][e]=xx&p193[a][b][c][d][e]=xx&p194[a][b][c][d][e]=xx&p195[a][b][c][d][e]=xx&p196[a][b][c][d][e]=xx&p197[a][b][c][d][e]=xx&p198[a][b][c][d][e]=xx&p199[a][b][c][d][e]=xx&p200[a][b][c][d][e]=xx&p201[a][b][c][d][e]=xx&p202[a][b][c][d][e]=xx&p203[a][b][c][d][e]=xx&p204[a][b][c][d][e]=xx&p205[a][b][c][d][e]=xx&p206[a][b][c][d][e]=xx&p207[a][b][c][d][e]=xx&p208[a][b][c][d][e]=xx&p209[a][b][c][d][e]=xx&p210[a][b][c][d][e]=xx&p211[a][b][c][d][e]=xx&p212[a][b][c][d][e]=xx&p213[a][b][c][d][e]=xx&p214[a][b][c][d][e]=xx&p215[a][b][c][d][e]=xx&p216[a][b][c][d][e]=xx&p217[a][b][c][d][e]=xx&p218[a][b][c][d][e]=xx&p219[a][b][c][d][e]=xx&p220[a][b][c][d][e]=xx&p221[a][b][c][d][e]=xx&p222[a][b][c][d][e]=xx&p223[a][b][c][d][e]=xx&p224[a][b][c][d][e]=xx&p225[a][b][c][d][e]=xx&p226[a][b][c][d][e]=xx&p227[a][b][c][d][e]=xx&p228[a][b][c][d][e]=xx&p229[a][b][c][d][e]=xx&p230[a][b][c][d][e]=xx&p231[a][b][c][d][e]=xx&p232[a][b][c][d][e]=xx&p233[a][b][c][d][e]=xx&p234[a][b][c][d][e]=xx&p235[a][b][c][d][e]=xx&p236[a][b][c][d][e]=xx&p237[a][b][c][d][e]=xx&p238[a][b][c][d][e]=xx&p239[a][b][c][d][e]=xx&p240[a][b][c][d][e]=xx&p241[a][b][c][d][e]=xx&p242[a][b][c][d][e]=xx&p243[a][b][c][d][e]=xx&p244[a][b][c][d][e]=xx&p245[a][b][c][d][e]=xx&p246[a][b][c][d][e]=xx&p247[a][b][c][d][e]=xx&p248[a][b][c][d][e]=xx&p249[a][b][c][d][e]=xx&p250[a][b][c][d][e]=xx&p251[a][b][c][d][e]=xx&p252[a][b][c][d][e]=xx&p253[a][b][c][d][e]=xx&p254[a][b][c][d][e]=xx&p255[a][b][c][d][e]=xx&p256[a][b][c][d][e]=xx&p257[a][b][c][d][e]=xx&p258[a][b][c][d][e]=xx&p259[a][b][c][d][e]=xx&p260[a][b][c][d][e]=xx&p261[a][b][c][d][e]=xx&p262[a][b][c][d][e]=xx&p263[a][b][c][d][e]=xx&p264[a][b][c][d][e]=xx&p265[a][b][c][d][e]=xx&p266[a][b][c][d][e]=xx&p267[a][b][c][d][e]=xx&p268[a][b][c][d][e]=xx&p269[a][b][c][d][e]=xx&p270[a][b][c][d][e]=xx&p271[a][b][c][d][e]=xx&p272[a][b][c][d][e]=xx&p273[a][b][c][d][e]=xx&p274[a][b][c][d][e]=xx&p275[a][b][c][d][e]=xx&p276[a][b][c][d][e]=xx&p277[a][b][c][d][e]=xx&p278[a][b][c][d][e]=xx&p279[a][b][c][d][e]=xx&p280[a][b][c][d][e]=xx&p281[a][b][c][d][e]=xx&p282[a][b][c][d][e]=xx&p283[a][b][c][d][e]=xx&p284[a][b][c][d][e]=xx&p285[a][b][c][d][e]=xx&p286[a][b][c][d][e]=xx&p287[a][b][c][d][e]=xx&p288[a][b][c][d][e]=xx&p289[a][b][c][d][e]=xx&p290[a][b][c][d][e]=xx&p291[a][b][c][d][e]=xx&p292[a][b][c][d][e]=xx&p293[a][b][c][d][e]=xx&p294[a][b][c][d][e]=xx&p295[a][b][c][d][e]=xx&p296[a][b][c][d][e]=xx&p297[a][b][c][d][e]=xx&p298[a][b][c][d][e]=xx&p299[a][b][c][d][e]=xx&p300[a][b][c][d][e]=xx&p301[a][b][c][d][e]=xx&p302[a][b][c][d][e]=xx&p303[a][b][c][d][e]=xx&p304[a][b][c][d][e]=xx&p305[a][b][c][d][e]=xx&p306[a][b][c][d][e]=xx&p307[a][b][c][d][e]=xx&p308[a][b][c][d][e]=xx&p309[a][b][c][d][e]=xx&p310[a][b][c][d][e]=xx&p311[a][b][c][d][e]=xx&p312[a][b][c][d][e]=xx&p313[a][b][c][d][e]=xx&p314[a][b][c][d][e]=xx&p315[a][b][c][d][e]=xx&p316[a][b][c][d][e]=xx&p317[a][b][c][d][e]=xx&p318[a][b][c][d][e]=xx&p319[a][b][c][d][e]=xx&p320[a][b][c][d][e]=xx&p321[a][b][c][d][e]=xx&p322[a][b][c][d][e]=xx&p323[a][b][c][d][e]=xx&p324[a][b][c][d][e]=xx&p325[a][b][c][d][e]=xx&p326[a][b][c][d][e]=xx&p327[a][b][c][d][e]=xx&p328[a][b][c][d][e]=xx&p329[a][b][c][d][e]=xx&p330[a][b][c][d][e]=xx&p331[a][b][c][d][e]=xx&p332[a][b][c][d][e]=xx&p333[a][b][c][d][e]=xx&p334[a][b][c][d][e]=xx&p335[a][b][c][d][e]=xx&p336[a][b][c][d][e]=xx&p337[a][b][c][d][e]=xx&p338[a][b][c][d][e]=xx&p339[a][b][c][d][e]=xx&p340[a][b][c][d][e]=xx&p341[a][b][c][d][e]=xx&p342[a][b][c][d][e]=xx&p343[a][b][c][d][e]=xx&p344[a][b][c][d][e]=xx&p345[a][b][c][d][e]=xx&p346[a][b][c][d][e]=xx&p347[a][b][c][d][e]=xx&p348[a][b][c][d][e]=xx&p349[a][b][c][d][e]=xx&p350[a][b][c][d][e]=xx&p351[a][b][c][d][e]=xx&p352[a][b][c][d][e]=xx&p353[a][b][c][d][e]=xx&p354[a][b][c][d][e]=xx&p355[a][b][c][d][e]=xx&p356[a][b][c][d][e]=xx&p357[a][b][c][d][e]=xx&p358[a][b][c][d][e]=xx&p359[a][b][c][d][e]=xx&p360[a][b][c][d][e]=xx&p361[a][b][c][d][e]=xx&p362[a][b][c][d][e]=xx&p363[a][b][c][d][e]=xx&p364[a][b][c][d][e]=xx&p365[a][b][c][d][e]=xx&p366[a][b][c][d][e]=xx&p367[a][b][c][d][e]=xx&p368[a][b][c][d][e]=xx&p369[a][b][c][d][e]=xx&p370[a][b][c][d][e]=xx&p371[a][b][c][d][e]=xx&p372[a][b][c][d][e]=xx&p373[a][b][c][d][e]=xx&p374[a][b][c][d][e]=xx&p375[a][b][c][d][e]=xx&p376[a][b][c][d][e]=xx&p377[a][b][c][d][e]=xx&p378[a][b][c][d][e]=xx&p379[a][b][c][d][e]=xx&p380[a][b][c][d][e]=xx&p381[a][b][c][d][e]=xx&p382[a][b][c][d][e]=xx&p383[a][b][c][d][e]=xx&p384[a][b][c][d][e]=xx&p385[a][b][c][d][e]=xx&p386[a][b][c][d][e]=xx&p387[a][b][c][d][e]=xx&p388[a][b][c][d][e]=xx&p389[a][b][c][d][e]=xx&p390[a][b][c][d][e]=xx&p391[a][b][c][d][e]=xx&p392[a][b][c][d][e]=xx&p393[a][b][c][d][e]=xx&p394[a][b][c][d][e]=xx&p395[a][b][c][d][e]=xx&p396[a][b][c][d][e]=xx&p397[a][b][c][d][e]=xx&p398[a][b][c][d][e]=xx&p399[a][b][c][d][e]=xx&p400[a][b][c][d][e]=xx&p401[a][b][c][d][e]=xx&p402[a][b][c][d][e]=xx&p403[a][b][c][d][e]=xx&p404[a][b][c][d][e]=xx&p405[a][b][c][d][e]=xx&p406[a][b][c][d][e]=xx&p407[a][b][c][d][e]=xx&p408[a][b][c][d][e]=xx&p409[a][b][c][d][e]=xx&p410[a][b][c][d][e]=xx&p411[a][b][c][d][e]=xx&p412[a][b][c][d][e]=xx&p413[a][b][c][d][e]=xx&p414[a][b][c][d][e]=xx&p415[a][b][c][d][e]=xx&p416[a][b][c][d][e]=xx&p417[a][b][c][d][e]=xx&p418[a][b][c][d][e]=xx&p419[a][b][c][d][e]=xx&p420[a][b][c][d][e]=xx&p421[a][b][c][d][e]=xx&p422[a][b][c][d][e]=xx&p423[a][b][c][d][e]=xx&p424[a][b][c][d][e]=xx&p425[a][b][c][d][e]=xx&p426[a][b][c][d][e]=xx&p427[a][b][c][d][e]=xx&p428[a][b][c][d][e]=xx&p429[a][b][c][d][e]=xx&p430[a][b][c][d][e]=xx&p431[a][b][c][d][e]=xx&p432[a][b][c][d][e]=xx&p433[a][b][c][d][e]=xx&p434[a][b][c][d][e]=xx&p435[a][b][c][d][e]=xx&p436[a][b][c][d][e]=xx&p437[a][b][c][d][e]=xx&p438[a][b][c][d][e]=xx&p439[a][b][c][d][e]=xx&p440[a][b][c][d][e]=xx&p441[a][b][c][d][e]=xx&p442[a][b][c][d][e]=xx&p443[a][b][c][d][e]=xx&p444[a][b][c][d][e]=xx&p445[a][b][c][d][e]=xx&p446[a][b][c][d][e]=xx&p447[a][b][c][d][e]=xx&p448[a][b][c][d][e]=xx&p449[a][b][c][d][e]=xx&p450[a][b][c][d][e]=xx&p451[a][b][c][d][e]=xx&p452[a][b][c][d][e]=xx&p453[a][b][c][d][e]=xx&p454[a][b][c][d][e]=xx&p455[a][b][c][d][e]=xx&p456[a][b][c][d][e]=xx&p457[a][b][c][d][e]=xx&p458[a][b][c][d][e]=xx&p459[a][b][c][d][e]=xx&p460[a][b][c][d][e]=xx&p461[a][b][c][d][e]=xx&p462[a][b][c][d][e]=xx&p463[a][b][c][d][e]=xx&p464[a][b][c][d][e]=xx&p465[a][b][c][d][e]=xx&p466[a][b][c][d][e]=xx&p467[a][b][c][d][e]=xx&p468[a][b][c][d][e]=xx&p469[a][b][c][d][e]=xx&p470[a][b][c][d][e]=xx&p471[a][b][c][d][e]=xx&p472[a][b][c][d][e]=xx&p473[a][b][c][d][e]=xx&p474[a][b][c][d][e]=xx&p475[a][b][c][d][e]=xx&p476[a][b][c][d][e]=xx&p477[a][b][c][d][e]=xx&p478[a][b][c][d][e]=xx&p479[a][b][c][d][e]=xx&p480[a][b][c][d][e]=xx&p481[a][b][c][d][e]=xx&p482[a][b][c][d][e]=xx&p483[a][b][c][d][e]=xx&p484[a][b][c][d][e]=xx&p485[a][b][c][d][e]=xx&p486[a][b][c][d][e]=xx&p487[a][b][c][d][e]=xx&p488[a][b][c][d][e]=xx&p489[a][b][c][d][e]=xx&p490[a][b][c][d][e]=xx&p491[a][b][c][d][e]=xx&p492[a][b][c][d][e]=xx&p493[a][b][c][d][e]=xx&p494[a][b][c][d][e]=xx&p495[a][b][c][d][e]=xx&p496[a][b][c][d][e]=xx&p497[a][b][c][d][e]=xx&p498[a][b][c][d][e]=xx&p499[a][b][c][d][e]=xx&p500[a][b][c][d][e]=xx&p501[a][b][c][d][e]=xx&p502[a][b][c][d][e]=xx&p503[a][b][c][d][e]=xx&p504[a][b][c][d][e]=xx&p505[a][b][c][d][e]=xx&p506[a][b][c][d][e]=xx&p507[a][b][c][d][e]=xx&p508[a][b][c][d][e]=xx&p509[a][b][c][d][e]=xx&p510[a][b][c][d][e]=xx&p511[a][b][c][d][e]=xx&p512[a][b][c][d][e]=xx&p513[a][b][c][d][e]=xx&p514[a][b][c][d][e]=xx&p515[a][b][c][d][e]=xx&p516[a][b][c][d][e]=xx&p517[a][b][c][d][e]=xx&p518[a][b][c][d][e]=xx&p519[a][b][c][d][e]=xx&p520[a][b][c][d][e]=xx&p521[a][b][c][d][e]=xx&p522[a][b][c][d][e]=xx&p523[a][b][c][d][e]=xx&p524[a][b][c][d][e]=xx&p525[a][b][c][d][e]=xx&p526[a][b][c][d][e]=xx&p527[a][b][c][d][e]=xx&p528[a][b][c][d][e]=xx&p529[a][b][c][d][e]=xx&p530[a][b][c][d][e]=xx&p531[a][b][c][d][e]=xx&p532[a][b][c][d][e]=xx&p533[a][b][c][d][e]=xx&p534[a][b][c][d][e]=xx&p535[a][b][c][d][e]=xx&p536[a][b][c][d][e]=xx&p537[a][b][c][d][e]=xx&p538[a][b][c][d][e]=xx&p539[a][b][c][d][e]=xx&p540[a][b][c][d][e]=xx&p541[a][b][c][d][e]=xx&p542[a][b][c][d][e]=xx&p543[a][b][c][d][e]=xx&p544[a][b][c][d][e]=xx&p545[a][b][c][d][e]=xx&p546[a][b][c][d][e]=xx&p547[a][b][c][d][e]=xx&p548[a][b][c][d][e]=xx&p549[a][b][c][d][e]=xx&p550[a][b][c][d][e]=xx&p551[a][b][c][d][e]=xx&p552[a][b][c][d][e]=xx&p553[a][b][c][d][e]=xx&p554[a][b][c][d][e]=xx&p555[a][b][c][d][e]=xx&p556[a][b][c][d][e]=xx&p557[a][b][c][d][e]=xx&p558[a][b][c][d][e]=xx&p559[a][b][c][d][e]=xx&p560[a][b][c][d][e]=xx&p561[a][b][c][d][e]=xx&p562[a][b][c][d][e]=xx&p563[a][b][c][d][e]=xx&p564[a][b][c][d][e]=xx&p565[a][b][c][d][e]=xx&p566[a][b][c][d][e]=xx&p567[a][b][c][d][e]=xx&p568[a][b][c][d][e]=xx&p569[a][b][c][d][e]=xx&p570[a][b][c][d][e]=xx&p571[a][b][c][d][e]=xx&p572[a][b][c][d][e]=xx&p573[a][b][c][d][e]=xx&p574[a][b][c][d][e]=xx&p575[a][b][c][d][e]=xx&p576[a][b][c][d][e]=xx&p577[a][b][c][d][e]=xx&p578[a][b][c][d][e]=xx&p579[a][b][c][d][e]=xx&p580[a][b][c][d][e]=xx&p581[a][b][c][d][e]=xx&p582[a][b][c][d][e]=xx&p583[a][b][c][d][e]=xx&p584[a][b][c][d][e]=xx&p585[a][b][c][d][e]=xx&p586[a][b][c][d][e]=xx&p587[a][b][c][d][e]=xx&p588[a][b][c][d][e]=xx&p589[a][b][c][d][e]=xx&p590[a][b][c][d][e]=xx&p591[a][b][c][d][e]=xx&p592[a][b][c][d][e]=xx&p593[a][b][c][d][e]=xx&p594[a][b][c][d][e]=xx&p595[a][b][c][d][e]=xx&p596[a][b][c][d][e]=xx&p597[a][b][c][d][e]=xx&p598[a][b][c][d][e]=xx&p599[a][b][c][d][e]=xx&p600[a][b][c][d][e]=xx&p601[a][b][c][d][e]=xx&p602[a][b][c][d][e]=xx&p603[a][b][c][d][e]=xx&p604[a][b][c][d][e]=xx&p605[a][b][c][d][e]=xx&p606[a][b][c][d][e]=xx&p607[a][b][c][d][e]=xx&p608[a][b][c][d][e]=xx&p609[a][b][c][d][e]=xx&p610[a][b][c][d][e]=xx&p611[a][b][c][d][e]=xx&p612[a][b][c][d][e]=xx&p613[a][b][c][d][e]=xx&p614[a][b][c][d][e]=xx&p615[a][b][c][d][e]=xx&p616[a][b][c][d][e]=xx&p617[a][b][c][d][e]=xx&p618[a][b][c][d][e]=xx&p619[a][b][c][d][e]=xx&p620[a][b][c][d][e]=xx&p621[a][b][c][d][e]=xx&p622[a][b][c][d][e]=xx&p623[a][b][c][d][e]=xx&p624[a][b][c][d][e]=xx&p625[a][b][c][d][e]=xx&p626[a][b][c][d][e]=xx&p627[a][b][c][d][e]=xx&p628[a][b][c][d][e]=xx&p629[a][b][c][d][e]=xx&p630[a][b][c][d][e]=xx&p631[a][b][c][d][e]=xx&p632[a][b][c][d][e]=xx&p633[a][b][c][d][e]=xx&p634[a][b][c][d][e]=xx&p635[a][b][c][d][e]=xx&p636[a][b][c][d][e]=xx&p637[a][b][c][d][e]=xx&p638[a][b][c][d][e]=xx&p639[a][b][c][d][e]=xx&p640[a][b][c][d][e]=xx&p641[a][b][c][d][e]=xx&p642[a][b][c][d][e]=xx&p643[a][b][c][d][e]=xx&p644[a][b][c][d][e]=xx&p645[a][b][c][d][e]=xx&p646[a][b][c][d][e]=xx&p647[a][b][c][d][e]=xx&p648[a][b][c][d][e]=xx&p649[a][b][c][d][e]=xx&p650[a][b][c][d][e]=xx&p651[a][b][c][d][e]=xx&p652[a][b][c][d][e]=xx&p653[a][b][c][d][e]=xx&p654[a][b][c][d][e]=xx&p655[a][b][c][d][e]=xx&p656[a][b][c][d][e]=xx&p657[a][b][c][d][e]=xx&p658[a][b][c][d][e]=xx&p659[a][b][c][d][e]=xx&p660[a][b][c][d][e]=xx&p661[a][b][c][d][e]=xx&p662[a][b][c][d][e]=xx&p663[a][b][c][d][e]=xx&p664[a][b][c][d][e]=xx&p665[a][b][c][d][e]=xx&p666[a][b][c][d][e]=xx&p667[a][b][c][d][e]=xx&p668[a][b][c][d][e]=xx&p669[a][b][c][d][e]=xx&p670[a][b][c][d][e]=xx&p671[a][b][c][d][e]=xx&p672[a][b][c][d][e]=xx&p673[a][b][c][d][e]=xx&p674[a][b][c][d][e]=xx&p675[a][b][c][d][e]=xx&p676[a][b][c][d][e]=xx&p677[a][b][c][d][e]=xx&p678[a][b][c][d][e]=xx&p679[a][b][c][d][e]=xx&p680[a][b][c][d][e]=xx&p681[a][b][c][d][e]=xx&p682[a][b][c][d][e]=xx&p683[a][b][c][d][e]=xx&p684[a][b][c][d][e]=xx&p685[a][b][c][d][e]=xx&p686[a][b][c][d][e]=xx&p687[a][b][c][d][e]=xx&p688[a][b][c][d][e]=xx&p689[a][b][c][d][e]=xx&p690[a][b][c][d][e]=xx&p691[a][b][c][d][e]=xx&p692[a][b][c][d][e]=xx&p693[a][b][c][d][e]=xx&p694[a][b][c][d][e]=xx&p695[a][b][c][d][e]=xx&p696[a][b][c][d][e]=xx&p697[a][b][c][d][e]=xx&p698[a][b][c][d][e]=xx&p699[a][b][c][d][e]=xx&p700[a][b][c][d][e]=xx&p701[a][b][c][d][e]=xx&p702[a][b][c][d][e]=xx&p703[a][b][c][d][e]=xx&p704[a][b][c][d][e]=xx&p705[a][b][c][d][e]=xx&p706[a][b][c][d][e]=xx&p707[a][b][c][d][e]=xx&p708[a][b][c][d][e]=xx&p709[a][b][c][d][e]=xx&p710[a][b][c][d][e]=xx&p711[a][b][c][d][e]=xx&p712[a][b][c][d][e]=xx&p713[a][b][c][d][e]=xx&p714[a][b][c][d][e]=xx&p715[a][b][c][d][e]=xx&p716[a][b][c][d][e]=xx&p717[a][b][c][d][e]=xx&p718[a][b][c][d][e]=xx&p719[a][b][c][d][e]=xx&p720[a][b][c][d][e]=xx&p721[a][b][c][d][e]=xx&p722[a][b][c][d][e]=xx&p723[a][b][c][d][e]=xx&p724[a][b][c][d][e]=xx&p725[a][b][c][d][e]=xx&p726[a][b][c][d][e]=xx&p727[a][b][c][d][e]=xx&p728[a][b][c][d][e]=xx&p729[a][b][c][d][e]=xx&p730[a][b][c][d][e]=xx&p731[a][b][c][d][e]=xx&p732[a][b][c][d][e]=xx&p733[a][b][c][d][e]=xx&p734[a][b][c][d][e]=xx&p735[a][b][c][d][e]=xx&p736[a][b][c][d][e]=xx&p737[a][b][c][d][e]=xx&p738[a][b][c][d][e]=xx&p739[a][b][c][d][e]=xx&p740[a][b][c][d][e]=xx&p741[a][b][c][d][e]=xx&p742[a][b][c][d][e]=xx&p743[a][b][c][d][e]=xx&p744[a][b][c][d][e]=xx&p745[a][b][c][d][e]=xx&p746[a][b][c][d][e]=xx&p747[a][b][c][d][e]=xx&p748[a][b][c][d][e]=xx&p749[a][b][c][d][e]=xx&p750[a][b][c][d][e]=xx&p751[a][b][c][d][e]=xx&p752[a][b][c][d][e]=xx&p753[a][b][c][d][e]=xx&p754[a][b][c][d][e]=xx&p755[a][b][c][d][e]=xx&p756[a][b][c][d][e]=xx&p757[a][b][c][d][e]=xx&p758[a][b][c][d][e]=xx&p759[a][b][c][d][e]=xx&p760[a][b][c][d][e]=xx&p761[a][b][c][d][e]=xx&p762[a][b][c][d][e]=xx&p763[a][b][c][d][e]=xx&p764[a][b][c][d][e]=xx&p765[a][b][c][d][e]=xx&p766[a][b][c][d][e]=xx&p767[a][b][c][d][e]=xx&p768[a][b][c][d][e]=xx&p769[a][b][c][d][e]=xx&p770[a][b][c][d][e]=xx&p771[a][b][c][d][e]=xx&p772[a][b][c][d][e]=xx&p773[a][b][c][d][e]=xx&p774[a][b][c][d][e]=xx&p775[a][b][c][d][e]=xx&p776[a][b][c][d][e]=xx&p777[a][b][c][d][e]=xx&p778[a][b][c][d][e]=xx&p779[a][b][c][d][e]=xx&p780[a][b][c][d][e]=xx&p781[a][b][c][d][e]=xx&p782[a][b][c][d][e]=xx&p783[a][b][c][d][e]=xx&p784[a][b][c][d][e]=xx&p785[a][b][c][d][e]=xx&p786[a][b][c][d][e]=xx&p787[a][b][c][d][e]=xx&p788[a][b][c][d][e]=xx&p789[a][b][c][d][e]=xx&p790[a][b][c][d][e]=xx&p791[a][b][c][d][e]=xx&p792[a][b][c][d][e]=xx&p793[a][b][c][d][e]=xx&p794[a][b][c][d][e]=xx&p795[a][b][c][d][e]=xx&p796[a][b][c][d][e]=xx&p797[a][b][c][d][e]=xx&p798[a][b][c][d][e]=xx&p799[a][b][c][d][e]=xx&p800[a][b][c][d][e]=xx&p801[a][b][c][d][e]=xx&p802[a][b][c][d][e]=xx&p803[a][b][c][d][e]=xx&p804[a][b][c][d][e]=xx&p805[a][b][c][d][e]=xx&p806[a][b][c][d][e]=xx&p807[a][b][c][d][e]=xx&p808[a][b][c][d][e]=xx&p809[a][b][c][d][e]=xx&p810[a][b][c][d][e]=xx&p811[a][b][c][d][e]=xx&p812[a][b][c][d][e]=xx&p813[a][b][c][d][e]=xx&p814[a][b][c][d][e]=xx&p815[a][b][c][d][e]=xx&p816[a][b][c][d][e]=xx&p817[a][b][c][d][e]=xx&p818[a][b][c][d][e]=xx&p819[a][b][c][d][e]=xx&p820[a][b][c][d][e]=xx&p821[a][b][c][d][e]=xx&p822[a][b][c][d][e]=xx&p823[a][b][c][d][e]=xx&p824[a][b][c][d][e]=xx&p825[a][b][c][d][e]=xx&p826[a][b][c][d][e]=xx&p827[a][b][c][d][e]=xx&p828[a][b][c][d][e]=xx&p829[a][b][c][d][e]=xx&p830[a][b][c][d][e]=xx&p831[a][b][c][d][e]=xx&p832[a][b][c][d][e]=xx&p833[a][b][c][d][e]=xx&p834[a][b][c][d][e]=xx&p835[a][b][c][d][e]=xx&p836[a][b][c][d][e]=xx&p837[a][b][c][d][e]=xx&p838[a][b][c][d][e]=xx&p839[a][b][c][d][e]=xx&p840[a][b][c][d][e]=xx&p841[a][b][c][d][e]=xx&p842[a][b][c][d][e]=xx&p843[a][b][c][d][e]=xx&p844[a][b][c][d][e]=xx&p845[a][b][c][d][e]=xx&p846[a][b][c][d][e]=xx&p847[a][b][c][d][e]=xx&p848[a][b][c][d][e]=xx&p849[a][b][c][d][e]=xx&p850[a][b][c][d][e]=xx&p851[a][b][c][d][e]=xx&p852[a][b][c][d][e]=xx&p853[a][b][c][d][e]=xx&p854[a][b][c][d][e]=xx&p855[a][b][c][d][e]=xx&p856[a][b][c][d][e]=xx&p857[a][b][c][d][e]=xx&p858[a][b][c][d][e]=xx&p859[a][b][c][d][e]=xx&p860[a][b][c][d][e]=xx&p861[a][b][c][d][e]=xx&p862[a][b][c][d][e]=xx&p863[a][b][c][d][e]=xx&p864[a][b][c][d][e]=xx&p865[a][b][c][d][e]=xx&p866[a][b][c][d][e]=xx&p867[a][b][c][d][e]=xx&p868[a][b][c][d][e]=xx&p869[a][b][c][d][e]=xx&p870[a][b][c][d][e]=xx&p871[a][b][c][d][e]=xx&p872[a][b][c][d][e]=xx&p873[a][b][c][d][e]=xx&p874[a][b][c][d][e]=xx&p875[a][b][c][d][e]=xx&p876[a][b][c][d][e]=xx&p877[a][b][c][d][e]=xx&p878[a][b][c][d][e]=xx&p879[a][b][c][d][e]=xx&p880[a][b][c][d][e]=xx&p881[a][b][c][d][e]=xx&p882[a][b][c][d][e]=xx&p883[a][b][c][d][e]=xx&p884[a][b][c][d][e]=xx&p885[a][b][c][d][e]=xx&p886[a][b][c][d][e]=xx&p887[a][b][c][d][e]=xx&p888[a][b][c][d][e]=xx&p889[a][b][c][d][e]=xx&p890[a][b][c][d][e]=xx&p891[a][b][c][d][e]=xx&p892[a][b][c][d][e]=xx&p893[a][b][c][d][e]=xx&p894[a][b][c][d][e]=xx&p895[a][b][c][d][e]=xx&p896[a][b][c][d][e]=xx&p897[a][b][c][d][e]=xx&p898[a][b][c][d][e]=xx&p899[a][b][c][d][e]=xx
+--FILE--
+<?php
+echo $_GET['a'];
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
@@ -0,0 +1,27 @@
+--TEST--
+hook echo (nested parameter deeper than input.max_depth)
+--SKIPIF--
+<?php
+$conf = <<<CONF
+input.max_depth: 2
+CONF;
+$plugin = <<<EOF
+RASP.algorithmConfig = {
+     xss_echo: {
+        name:   '算法1 - PHP: 禁止直接输出 GPC 参数',
+        action: 'block'
+    }
+}
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--GET--
+a[b][c]=<b>test</b>
+--FILE--
+<?php
+echo $_GET['a']['b']['c'];
+?>
+--EXPECT--
+<b>test</b>
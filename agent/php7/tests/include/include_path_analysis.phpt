@@ -0,0 +1,34 @@
+--TEST--
+hook include (path analysis)
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('include', params => {
+    assert(params.traversal_depth == 1)
+    assert(params.scheme == '')
+    assert(!params.outside_webroot)
+    assert(!params.sensitive)
+    return block
+})
+EOF;
+$conf = <<<CONF
+security.sensitive_paths:
+  - "/etc/passwd"
+CONF;
+include(__DIR__.'/../skipif.inc');
+file_put_contents('/tmp/openrasp/tmpfile.txt', 'temp');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--GET--
+a=force_to_cgi
+--ENV--
+return <<<END
+DOCUMENT_ROOT=/tmp
+END;
+--FILE--
+<?php
+include('/tmp/openrasp/../openrasp/tmpfile.txt');
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
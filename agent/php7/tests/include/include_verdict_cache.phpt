@@ -0,0 +1,30 @@
+--TEST--
+hook include verdict cache
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+var include_count = 0
+plugin.register('include', params => {
+    assert(params.realpath.endsWith('/include.txt'))
+    include_count++
+    if (include_count > 1) {
+        return block
+    }
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--FILE--
+<?php
+for ($i = 0; $i < 2; $i++) {
+    include(__DIR__.'/../include.txt');
+}
+touch(__DIR__.'/../include.txt', time() + 10);
+include(__DIR__.'/../include.txt');
+?>
+--EXPECTREGEX--
+openrasp
+openrasp
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
@@ -0,0 +1,19 @@
+--TEST--
+constant sink call sites in debug log
+--SKIPIF--
+<?php
+$conf = <<<CONF
+debug.level: 1
+CONF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--FILE--
+<?php
+include(__DIR__.'/../timezone.inc');
+exec('true');
+passthru('grep "compile_constant_sites_debug" /tmp/openrasp/logs/rasp/rasp.log.'.date("Y-m-d").' | tail -n 1');
+?>
+--EXPECTREGEX--
+.*Compiled .*compile_constant_sites_debug.php with 3 sink call sites, 2 of them with constant arguments.*
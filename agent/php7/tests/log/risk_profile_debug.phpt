@@ -0,0 +1,20 @@
+--TEST--
+risk profile in debug log
+--SKIPIF--
+<?php
+$conf = <<<CONF
+debug.level: 1
+CONF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--GET--
+id=1%27%20or%201&page=2
+--FILE--
+<?php
+include(__DIR__.'/../timezone.inc');
+passthru('grep "Risk profile" /tmp/openrasp/logs/rasp/rasp.log.'.date("Y-m-d").' | tail -n 1');
+?>
+--EXPECTREGEX--
+.*Risk profile of request .* is input_count=2 input_bytes=8 max_input_length=7 meta=sql\|html bypass=false.*
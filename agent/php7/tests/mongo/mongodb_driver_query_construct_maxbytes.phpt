@@ -0,0 +1,28 @@
+--TEST--
+hook MongoDB\Driver\Query::__construct mongo.maxbytes
+--SKIPIF--
+<?php
+if (PHP_VERSION_ID < 50500) die('Skipped: not supported (version < 5.5.0)');
+$conf = <<<CONF
+mongo.maxbytes: 32
+CONF;
+$plugin = <<<EOF
+plugin.register('mongodb', params => {
+    assert(params.query == '{"likes":100,"name":"aaaaaaaaaa","\$where":"sleep(1)"}')
+    assert(JSON.parse(params.query).likes == 100)
+    assert(JSON.parse(params.query)["\$where"] == 'sleep(1)')
+    assert(params.class.endsWith('Query'))
+    return block
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+if (!extension_loaded("mongodb")) die("Skipped: mongodb extension required.");
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--FILE--
+<?php
+$query = new MongoDB\Driver\Query(['likes' => 100, 'name' => str_repeat('a', 64), '$where' => 'sleep(1)']);
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
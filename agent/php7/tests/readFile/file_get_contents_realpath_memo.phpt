@@ -0,0 +1,25 @@
+--TEST--
+hook file_get_contents after the file is created in the same request
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('readFile', params => {
+    assert(params.realpath == '/tmp/openrasp/realpath_memo.txt')
+    return block
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--FILE--
+<?php
+$file = '/tmp/openrasp/realpath_memo.txt';
+@unlink($file);
+@file_get_contents($file);
+@file_get_contents($file);
+file_put_contents($file, 'openrasp');
+echo file_get_contents($file);
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
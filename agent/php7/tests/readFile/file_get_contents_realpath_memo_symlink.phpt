@@ -0,0 +1,32 @@
+--TEST--
+hook file_get_contents after a symlink is retargeted by a command
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('readFile', params => {
+    if (params.realpath == '/tmp/openrasp/realpath_memo_b/x.txt') {
+        return block
+    }
+    return {action: 'ignore'}
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--FILE--
+<?php
+$dir = '/tmp/openrasp/';
+@mkdir($dir.'realpath_memo_a');
+@mkdir($dir.'realpath_memo_b');
+file_put_contents($dir.'realpath_memo_a/x.txt', 'a');
+file_put_contents($dir.'realpath_memo_b/x.txt', 'b');
+exec('ln -sfn '.$dir.'realpath_memo_a '.$dir.'realpath_memo_link');
+clearstatcache(true);
+echo file_get_contents($dir.'realpath_memo_link/x.txt');
+exec('ln -sfn '.$dir.'realpath_memo_b '.$dir.'realpath_memo_link');
+clearstatcache(true);
+echo file_get_contents($dir.'realpath_memo_link/x.txt');
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
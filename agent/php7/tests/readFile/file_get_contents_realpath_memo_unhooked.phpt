@@ -0,0 +1,25 @@
+--TEST--
+hook file_get_contents after the file is created by an unhooked function
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('readFile', params => {
+    assert(params.realpath == '/tmp/openrasp/realpath_memo_unhooked.txt')
+    return block
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--FILE--
+<?php
+$file = '/tmp/openrasp/realpath_memo_unhooked.txt';
+@unlink($file);
+@file_get_contents($file);
+touch($file);
+clearstatcache();
+echo file_get_contents($file);
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
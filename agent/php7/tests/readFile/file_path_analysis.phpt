@@ -0,0 +1,29 @@
+--TEST--
+hook file_get_contents (path analysis)
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('readFile', params => {
+    assert(params.traversal_depth == 3)
+    assert(params.scheme == '')
+    assert(params.outside_webroot)
+    assert(params.sensitive)
+    return block
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--GET--
+a=force_to_cgi
+--ENV--
+return <<<END
+DOCUMENT_ROOT=/tmp/openrasp
+END;
+--FILE--
+<?php
+var_dump(file_get_contents('/tmp/openrasp/../../../etc/passwd'));
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
@@ -4,7 +4,7 @@ policy sensitive response
 <?php
 $plugin = <<<EOF
 plugin.register('response', params => {
-  assert(params.content.indexOf('1234567890') != -1)
+  assert(params.content.indexOf('12345678901') != -1)
   return {
     action: 'log',
     message: 'sensitive',
@@ -22,7 +22,7 @@ expose_php=false
 display_errors=false
 --FILE--
 <?php
-echo "1234567890";
+echo "12345678901";
 ?>
 --EXPECT--
-1234567890
\ No newline at end of file
+12345678901
\ No newline at end of file
@@ -0,0 +1,33 @@
+--TEST--
+policy sensitive response (prescan windows)
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+plugin.register('response', params => {
+  assert(params.content.indexOf('138 1234 5678') != -1)
+  assert(params.content.indexOf('padding') == -1)
+  assert(params.content_windows.length == 1)
+  assert(params.content_windows[0].offset == 0)
+  return {
+    action: 'log',
+    message: 'sensitive',
+    params: {
+      a: 1
+    }
+  }
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+expose_php=false
+display_errors=false
+--FILE--
+<?php
+echo "phone: 138 1234 5678\n";
+echo str_repeat(" ", 64) . str_repeat("padding", 100) . "\n";
+?>
+--EXPECTF--
+phone: 138 1234 5678
+%spadding%s
@@ -0,0 +1,33 @@
+--TEST--
+hook curl_exec (obfuscated ip)
+--SKIPIF--
+<?php
+if (!function_exists("curl_init")) die("Skipped: curl is disabled.");
+$plugin = <<<EOF
+plugin.register('ssrf', params => {
+    assert(params.normalized_hostname == '127.0.0.1')
+    assert(params.hostname_obfuscated)
+    assert(params.hostname_class == 'loopback')
+    assert(params.internal)
+    return block
+})
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--GET--
+url=http://0x7f.1/
+--FILE--
+<?php 
+	$url = @$_GET['url'];
+	if(!empty($url)){
+		$ch = curl_init($url);
+		curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
+		curl_setopt($ch, CURLOPT_NOSIGNAL, 1);
+		curl_setopt($ch, CURLOPT_TIMEOUT_MS, 200);
+		curl_exec($ch);
+	}
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
@@ -12,6 +12,7 @@ plugin.register('ssrfRedirect', params => {
     assert(params.hostname == 'uee.me')
 	assert(params.hostname2 == '127.0.0.1')
     assert(Array.isArray(params.ip))
+    assert(typeof params.primary_ip == 'string')
     return block
 })
 EOF;
@@ -0,0 +1,29 @@
+--TEST--
+hook system (webshell, class constant from define())
+--SKIPIF--
+<?php
+$plugin = <<<EOF
+RASP.algorithmConfig = {
+    webshell_command: {
+        name:   '算法2 - 拦截简单的 PHP 命令执行后门',
+        action: 'block'
+    }
+}
+EOF;
+include(__DIR__.'/../skipif.inc');
+?>
+--INI--
+openrasp.root_dir=/tmp/openrasp
+--GET--
+a=cd
+--FILE--
+<?php
+define('C', $_GET['a']);
+class A
+{
+    const X = C;
+}
+system(A::X);
+?>
+--EXPECTREGEX--
+<\/script><script>location.href="http[s]?:\/\/.*?request_id=[0-9a-f]{32}"<\/script>
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "cidr_classifier.h"
+#include <cstring>
+#include <cstdlib>
+#include <arpa/inet.h>
+
+namespace openrasp
+{
+
+static inline int key_bit(const uint8_t key[16], int index)
+{
+    return (key[index >> 3] >> (7 - (index & 7))) & 1;
+}
+
+static int common_prefix_len(const uint8_t lhs[16], const uint8_t rhs[16], int limit)
+{
+    int len = 0;
+    while (len < limit && key_bit(lhs, len) == key_bit(rhs, len))
+    {
+        ++len;
+    }
+    return len;
+}
+
+CidrClassifier::CidrClassifier()
+{
+    static const uint8_t zero[16] = {0};
+    new_node(zero, 0, kNone);
+    static const struct
+    {
+        const char *cidr;
+        Category category;
+    } builtin[] = {
+        {"0.0.0.0/8", kLoopback},
+        {"127.0.0.0/8", kLoopback},
+        {"::1/128", kLoopback},
+        {"::/128", kLoopback},
+        {"10.0.0.0/8", kPrivate},
+        {"172.16.0.0/12", kPrivate},
+        {"192.168.0.0/16", kPrivate},
+        {"100.64.0.0/10", kPrivate},
+        {"fc00::/7", kPrivate},
+        {"169.254.0.0/16", kLinkLocal},
+        {"fe80::/10", kLinkLocal},
+        {"169.254.169.254/32", kMetadata},
+        {"100.100.100.200/32", kMetadata},
+        {"fd00:ec2::254/128", kMetadata}};
+    for (const auto &item : builtin)
+    {
+        add(item.cidr, item.category);
+    }
+}
+
+int32_t CidrClassifier::new_node(const uint8_t key[16], uint8_t prefix_len, int8_t category)
+{
+    Node node;
+    memset(node.key, 0, sizeof(node.key));
+    for (int i = 0; i < prefix_len; ++i)
+    {
+        if (key_bit(key, i))
+        {
+            node.key[i >> 3] |= (0x80 >> (i & 7));
+        }
+    }
+    node.prefix_len = prefix_len;
+    node.category = category;
+    node.child[0] = node.child[1] = -1;
+    nodes.push_back(node);
+    return static_cast<int32_t>(nodes.size() - 1);
+}
+
+void CidrClassifier::insert(const uint8_t key[16], uint8_t prefix_len, Category category)
+{
+    int32_t idx = 0;
+    while (true)
+    {
+        if (nodes[idx].prefix_len == prefix_len)
+        {
+            nodes[idx].category = category;
+            return;
+        }
+        int branch = key_bit(key, nodes[idx].prefix_len);
+        int32_t child = nodes[idx].child[branch];
+        if (child < 0)
+        {
+            int32_t leaf = new_node(key, prefix_len, category);
+            nodes[idx].child[branch] = leaf;
+            return;
+        }
+        int limit = prefix_len < nodes[child].prefix_len ? prefix_len : nodes[child].prefix_len;
+        int common = common_prefix_len(key, nodes[child].key, limit);
+        if (common == nodes[child].prefix_len)
+        {
+            idx = child;
+            continue;
+        }
+        if (common == prefix_len)
+        {
+            int32_t inner = new_node(key, prefix_len, category);
+            nodes[inner].child[key_bit(nodes[child].key, common)] = child;
+            nodes[idx].child[branch] = inner;
+            return;
+        }
+        int32_t split = new_node(key, common, kNone);
+        int32_t leaf = new_node(key, prefix_len, category);
+        nodes[split].child[key_bit(nodes[child].key, common)] = child;
+        nodes[split].child[key_bit(key, common)] = leaf;
+        nodes[idx].child[branch] = split;
+        return;
+    }
+}
+
+bool CidrClassifier::parse_address(const std::string &address, uint8_t key[16], bool &v4)
+{
+    struct in_addr in4;
+    struct in6_addr in6;
+    if (inet_pton(AF_INET, address.c_str(), &in4) == 1)
+    {
+        memset(key, 0, 16);
+        key[10] = key[11] = 0xff;
+        memcpy(key + 12, &in4, 4);
+        v4 = true;
+        return true;
+    }
+    std::string addr = address.substr(0, address.find('%'));
+    if (inet_pton(AF_INET6, addr.c_str(), &in6) == 1)
+    {
+        memcpy(key, &in6, 16);
+        v4 = false;
+        return true;
+    }
+    return false;
+}
+
+bool CidrClassifier::add(const std::string &cidr, Category category)
+{
+    size_t slash = cidr.find('/');
+    std::string address = cidr.substr(0, slash);
+    uint8_t key[16];
+    bool v4 = false;
+    if (!parse_address(address, key, v4))
+    {
+        return false;
+    }
+    int max_len = v4 ? 32 : 128;
+    int prefix_len = max_len;
+    if (slash != std::string::npos)
+    {
+        const std::string len_str = cidr.substr(slash + 1);
+        char *end = nullptr;
+        long value = strtol(len_str.c_str(), &end, 10);
+        if (len_str.empty() || *end != '\0' || value < 0 || value > max_len)
+        {
+            return false;
+        }
+        prefix_len = static_cast<int>(value);
+    }
+    insert(key, static_cast<uint8_t>(v4 ? prefix_len + 96 : prefix_len), category);
+    return true;
+}
+
+CidrClassifier::Category CidrClassifier::classify(const std::string &ip) const
+{
+    uint8_t key[16];
+    bool v4 = false;
+    if (nodes.empty() || !parse_address(ip, key, v4))
+    {
+        return kNone;
+    }
+    int8_t best = kNone;
+    int32_t idx = 0;
+    while (idx >= 0)
+    {
+        const Node &node = nodes[idx];
+        if (common_prefix_len(key, node.key, node.prefix_len) != node.prefix_len)
+        {
+            break;
+        }
+        if (node.category != kNone)
+        {
+            best = node.category;
+        }
+        if (node.prefix_len >= 128)
+        {
+            break;
+        }
+        idx = node.child[key_bit(key, node.prefix_len)];
+    }
+    return static_cast<Category>(best);
+}
+
+size_t CidrClassifier::size() const
+{
+    return nodes.size();
+}
+
+const char *CidrClassifier::category_name(Category category)
+{
+    switch (category)
+    {
+    case kPrivate:
+        return "private";
+    case kLoopback:
+        return "loopback";
+    case kLinkLocal:
+        return "link_local";
+    case kMetadata:
+        return "metadata";
+    case kCustom:
+        return "custom";
+    case kNone:
+    default:
+        return "";
+    }
+}
+
+} // namespace openrasp
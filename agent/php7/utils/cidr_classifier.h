@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _OPENRASP_UTILS_CIDR_CLASSIFIER_H_
+#define _OPENRASP_UTILS_CIDR_CLASSIFIER_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace openrasp
+{
+
+/**
+ * 基于压缩前缀树 (radix tree) 的 IP 网段分类，最长前缀匹配
+ * IPv4 地址以 IPv4-mapped IPv6 (::ffff:0:0/96) 的形式存储，两种协议共用一棵树
+ */
+class CidrClassifier
+{
+public:
+    enum Category
+    {
+        kNone = 0,
+        kPrivate,
+        kLoopback,
+        kLinkLocal,
+        kMetadata,
+        kCustom
+    };
+
+private:
+    struct Node
+    {
+        uint8_t key[16];
+        uint8_t prefix_len;
+        int8_t category;
+        int32_t child[2];
+    };
+    std::vector<Node> nodes;
+
+    int32_t new_node(const uint8_t key[16], uint8_t prefix_len, int8_t category);
+    void insert(const uint8_t key[16], uint8_t prefix_len, Category category);
+
+    static bool parse_address(const std::string &address, uint8_t key[16], bool &v4);
+
+public:
+    CidrClassifier();
+    bool add(const std::string &cidr, Category category);
+    Category classify(const std::string &ip) const;
+    size_t size() const;
+
+    static const char *category_name(Category category);
+};
+
+} // namespace openrasp
+
+#endif
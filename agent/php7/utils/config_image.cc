@@ -0,0 +1,323 @@
+/*
+ * Copyright 2017-2018 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "config_image.h"
+#include <cstring>
+
+namespace openrasp
+{
+
+static const uint32_t config_image_magic = 0x474D4943; // "CIMG"
+
+static const char type_string = 's';
+static const char type_int64 = 'i';
+static const char type_bool = 'b';
+static const char type_object_keys = 'k';
+static const char type_strings = 'a';
+
+struct ImageHeader
+{
+  uint32_t magic;
+  uint32_t count;
+  int64_t version;
+};
+
+struct ImageEntry
+{
+  uint32_t key_offset;
+  uint32_t key_length;
+  uint32_t value_offset;
+  uint32_t value_length;
+};
+
+//key 之后追加分隔符与类型，同一个 key 以不同类型读取时互不影响
+static std::string entry_key(const std::vector<std::string> &keys, char type)
+{
+  std::string key = BaseReader::stringfy_keys(keys);
+  key.push_back('\0');
+  key.push_back(type);
+  return key;
+}
+
+static std::string encode_strings(const std::vector<std::string> &values)
+{
+  std::string result;
+  for (const std::string &value : values)
+  {
+    uint32_t length = value.length();
+    result.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    result.append(value);
+  }
+  return result;
+}
+
+ConfigImageWriter::ConfigImageWriter(BaseReader *source)
+    : source(source)
+{
+  error = (nullptr == source || source->has_error());
+}
+
+void ConfigImageWriter::record(const std::vector<std::string> &keys, char type, const std::string &value)
+{
+  entries[entry_key(keys, type)] = value;
+}
+
+std::string ConfigImageWriter::fetch_string(const std::vector<std::string> &keys, const std::string &default_value,
+                                            const std::function<std::string(const std::string &value)> &validator)
+{
+  std::string result = source->fetch_string(keys, default_value, validator);
+  record(keys, type_string, result);
+  return result;
+}
+
+int64_t ConfigImageWriter::fetch_int64(const std::vector<std::string> &keys, const int64_t &default_value,
+                                       const std::function<std::string(int64_t value)> &validator)
+{
+  int64_t result = source->fetch_int64(keys, default_value, validator);
+  record(keys, type_int64, std::string(reinterpret_cast<const char *>(&result), sizeof(result)));
+  return result;
+}
+
+bool ConfigImageWriter::fetch_bool(const std::vector<std::string> &keys, const bool &default_value)
+{
+  bool result = source->fetch_bool(keys, default_value);
+  record(keys, type_bool, std::string(1, result ? '\1' : '\0'));
+  return result;
+}
+
+std::vector<std::string> ConfigImageWriter::fetch_object_keys(const std::vector<std::string> &keys)
+{
+  std::vector<std::string> result = source->fetch_object_keys(keys);
+  record(keys, type_object_keys, encode_strings(result));
+  return result;
+}
+
+std::vector<std::string> ConfigImageWriter::fetch_strings(const std::vector<std::string> &keys, const std::vector<std::string> &default_value)
+{
+  std::vector<std::string> result = source->fetch_strings(keys, default_value);
+  record(keys, type_strings, encode_strings(result));
+  return result;
+}
+
+void ConfigImageWriter::load(const std::string &content)
+{
+  source->load(content);
+  error = source->has_error();
+}
+
+std::string ConfigImageWriter::dump(const std::vector<std::string> &keys, bool pretty)
+{
+  return source->dump(keys, pretty);
+}
+
+std::string ConfigImageWriter::dump(bool pretty)
+{
+  return source->dump(pretty);
+}
+
+std::string ConfigImageWriter::build(int64_t version) const
+{
+  ImageHeader header;
+  header.magic = config_image_magic;
+  header.count = entries.size();
+  header.version = version;
+  std::vector<ImageEntry> index;
+  std::string pool;
+  size_t pool_offset = sizeof(ImageHeader) + entries.size() * sizeof(ImageEntry);
+  //std::map 已按 key 排序，读取时可以直接二分查找
+  for (auto &item : entries)
+  {
+    ImageEntry entry;
+    entry.key_offset = pool_offset + pool.size();
+    entry.key_length = item.first.length();
+    pool.append(item.first);
+    entry.value_offset = pool_offset + pool.size();
+    entry.value_length = item.second.length();
+    pool.append(item.second);
+    index.push_back(entry);
+  }
+  std::string image;
+  image.reserve(pool_offset + pool.size());
+  image.append(reinterpret_cast<const char *>(&header), sizeof(header));
+  image.append(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(ImageEntry));
+  image.append(pool);
+  return image;
+}
+
+ConfigImageReader::ConfigImageReader(const char *data, size_t size)
+{
+  ImageHeader header;
+  if (nullptr == data || size < sizeof(header))
+  {
+    error = true;
+    error_msg = "config image is empty";
+    return;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != config_image_magic ||
+      sizeof(ImageHeader) + static_cast<size_t>(header.count) * sizeof(ImageEntry) > size)
+  {
+    error = true;
+    error_msg = "config image is corrupted";
+    return;
+  }
+  this->data = data;
+  this->size = size;
+  count = header.count;
+  image_version = header.version;
+}
+
+bool ConfigImageReader::find(const std::vector<std::string> &keys, char type, const char *&value, size_t &length) const
+{
+  std::string key = entry_key(keys, type);
+  size_t low = 0;
+  size_t high = count;
+  while (low < high)
+  {
+    size_t mid = low + (high - low) / 2;
+    ImageEntry entry;
+    memcpy(&entry, data + sizeof(ImageHeader) + mid * sizeof(ImageEntry), sizeof(entry));
+    if (static_cast<size_t>(entry.key_offset) + entry.key_length > size ||
+        static_cast<size_t>(entry.value_offset) + entry.value_length > size)
+    {
+      return false;
+    }
+    int result = key.compare(0, std::string::npos, data + entry.key_offset, entry.key_length);
+    if (result == 0)
+    {
+      value = data + entry.value_offset;
+      length = entry.value_length;
+      return true;
+    }
+    if (result > 0)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return false;
+}
+
+bool ConfigImageReader::decode_strings(const char *value, size_t length, std::vector<std::string> &result)
+{
+  size_t offset = 0;
+  while (offset < length)
+  {
+    uint32_t item_length = 0;
+    if (length - offset < sizeof(item_length))
+    {
+      return false;
+    }
+    memcpy(&item_length, value + offset, sizeof(item_length));
+    offset += sizeof(item_length);
+    if (length - offset < item_length)
+    {
+      return false;
+    }
+    result.emplace_back(value + offset, item_length);
+    offset += item_length;
+  }
+  return true;
+}
+
+std::string ConfigImageReader::fetch_string(const std::vector<std::string> &keys, const std::string &default_value,
+                                            const std::function<std::string(const std::string &value)> &validator)
+{
+  const char *value = nullptr;
+  size_t length = 0;
+  if (!find(keys, type_string, value, length))
+  {
+    return default_value;
+  }
+  std::string result(value, length);
+  if (nullptr != validator && !validator(result).empty())
+  {
+    return default_value;
+  }
+  return result;
+}
+
+int64_t ConfigImageReader::fetch_int64(const std::vector<std::string> &keys, const int64_t &default_value,
+                                       const std::function<std::string(int64_t value)> &validator)
+{
+  const char *value = nullptr;
+  size_t length = 0;
+  int64_t result = default_value;
+  if (!find(keys, type_int64, value, length) || length != sizeof(result))
+  {
+    return default_value;
+  }
+  memcpy(&result, value, sizeof(result));
+  if (nullptr != validator && !validator(result).empty())
+  {
+    return default_value;
+  }
+  return result;
+}
+
+bool ConfigImageReader::fetch_bool(const std::vector<std::string> &keys, const bool &default_value)
+{
+  const char *value = nullptr;
+  size_t length = 0;
+  if (!find(keys, type_bool, value, length) || length != 1)
+  {
+    return default_value;
+  }
+  return value[0] != '\0';
+}
+
+std::vector<std::string> ConfigImageReader::fetch_object_keys(const std::vector<std::string> &keys)
+{
+  std::vector<std::string> result;
+  const char *value = nullptr;
+  size_t length = 0;
+  if (!find(keys, type_object_keys, value, length) || !decode_strings(value, length, result))
+  {
+    return std::vector<std::string>();
+  }
+  return result;
+}
+
+std::vector<std::string> ConfigImageReader::fetch_strings(const std::vector<std::string> &keys, const std::vector<std::string> &default_value)
+{
+  std::vector<std::string> result;
+  const char *value = nullptr;
+  size_t length = 0;
+  if (!find(keys, type_strings, value, length) || !decode_strings(value, length, result))
+  {
+    return default_value;
+  }
+  return result;
+}
+
+void ConfigImageReader::load(const std::string &content)
+{
+}
+
+std::string ConfigImageReader::dump(const std::vector<std::string> &keys, bool pretty)
+{
+  return "";
+}
+
+std::string ConfigImageReader::dump(bool pretty)
+{
+  return "";
+}
+
+} // namespace openrasp
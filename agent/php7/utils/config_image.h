@@ -0,0 +1,89 @@
+/*
+ * Copyright 2017-2018 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OPENRASP_UTILS_CONFIG_IMAGE_H_
+#define _OPENRASP_UTILS_CONFIG_IMAGE_H_
+
+#include "base_reader.h"
+#include <map>
+
+namespace openrasp
+{
+
+/**
+ * 配置镜像：agent 解析并校验一次配置，把每个配置项最终读到的值写成一段连续的二进制数据放入共享内存，
+ * 工作进程用 ConfigImageReader 直接按 key 二分查找，不再各自读取并解析 cloud-config.json
+ */
+class ConfigImageWriter : public BaseReader
+{
+private:
+  BaseReader *source;
+  std::map<std::string, std::string> entries;
+
+  void record(const std::vector<std::string> &keys, char type, const std::string &value);
+
+public:
+  explicit ConfigImageWriter(BaseReader *source);
+  virtual std::string fetch_string(const std::vector<std::string> &keys, const std::string &default_value = "",
+                                   const std::function<std::string(const std::string &value)> &validator = nullptr);
+  virtual int64_t fetch_int64(const std::vector<std::string> &keys, const int64_t &default_value = 0,
+                              const std::function<std::string(int64_t value)> &validator = nullptr);
+  virtual bool fetch_bool(const std::vector<std::string> &keys, const bool &default_value = false);
+  virtual std::vector<std::string> fetch_object_keys(const std::vector<std::string> &keys);
+  virtual std::vector<std::string> fetch_strings(const std::vector<std::string> &keys, const std::vector<std::string> &default_value = std::vector<std::string>());
+  virtual void load(const std::string &content);
+  virtual std::string dump(const std::vector<std::string> &keys, bool pretty = false);
+  virtual std::string dump(bool pretty = false);
+
+  std::string build(int64_t version) const;
+};
+
+/**
+ * 只读视图，数据由调用方持有；未记录的配置项返回默认值
+ */
+class ConfigImageReader : public BaseReader
+{
+private:
+  const char *data = nullptr;
+  size_t size = 0;
+  uint32_t count = 0;
+  int64_t image_version = 0;
+
+  bool find(const std::vector<std::string> &keys, char type, const char *&value, size_t &length) const;
+  static bool decode_strings(const char *value, size_t length, std::vector<std::string> &result);
+
+public:
+  ConfigImageReader(const char *data, size_t size);
+  virtual std::string fetch_string(const std::vector<std::string> &keys, const std::string &default_value = "",
+                                   const std::function<std::string(const std::string &value)> &validator = nullptr);
+  virtual int64_t fetch_int64(const std::vector<std::string> &keys, const int64_t &default_value = 0,
+                              const std::function<std::string(int64_t value)> &validator = nullptr);
+  virtual bool fetch_bool(const std::vector<std::string> &keys, const bool &default_value = false);
+  virtual std::vector<std::string> fetch_object_keys(const std::vector<std::string> &keys);
+  virtual std::vector<std::string> fetch_strings(const std::vector<std::string> &keys, const std::vector<std::string> &default_value = std::vector<std::string>());
+  virtual void load(const std::string &content);
+  virtual std::string dump(const std::vector<std::string> &keys, bool pretty = false);
+  virtual std::string dump(bool pretty = false);
+
+  inline int64_t version() const
+  {
+    return image_version;
+  }
+};
+
+} // namespace openrasp
+
+#endif
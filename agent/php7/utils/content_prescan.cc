@@ -0,0 +1,168 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "content_prescan.h"
+#include "string_kernel.h"
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace openrasp
+{
+
+static inline bool is_digit(unsigned char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+static inline bool is_utf8_continuation(unsigned char ch)
+{
+    return (ch & 0xC0) == 0x80;
+}
+
+ContentPrescan::ContentPrescan(size_t min_digits, size_t padding, const std::vector<std::string> &signatures)
+    : min_digits(min_digits), padding(padding), signatures(signatures)
+{
+}
+
+std::vector<ContentWindow> ContentPrescan::scan(const char *data, size_t length) const
+{
+    std::vector<ContentWindow> windows;
+    if (nullptr == data || 0 == length)
+    {
+        return windows;
+    }
+    if (min_digits > 0)
+    {
+        find_digit_runs(data, length, min_digits, windows);
+    }
+    find_signatures(data, length, signatures, windows);
+    return merge_windows(windows, data, length, padding);
+}
+
+void ContentPrescan::find_digit_runs(const char *data, size_t length, size_t min_digits, std::vector<ContentWindow> &runs)
+{
+    size_t digits = 0;
+    size_t run_start = 0;
+    size_t last_digit = 0;
+    auto finish_run = [&]() {
+        if (digits > 0 && digits >= min_digits)
+        {
+            runs.push_back({run_start, last_digit + 1 - run_start});
+        }
+        digits = 0;
+    };
+    size_t i = 0;
+    while (i < length)
+    {
+        size_t block_end = length;
+#if defined(__SSE2__)
+        if (length - i >= 16)
+        {
+            //16 字节一组判断是否含有数字，大部分响应内容整块跳过
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+            __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(9)), shifted);
+            if (0 == _mm_movemask_epi8(in_range))
+            {
+                finish_run();
+                i += 16;
+                continue;
+            }
+            block_end = i + 16;
+        }
+#endif
+        for (; i < block_end; ++i)
+        {
+            unsigned char ch = static_cast<unsigned char>(data[i]);
+            if (is_digit(ch))
+            {
+                if (0 == digits)
+                {
+                    run_start = i;
+                }
+                ++digits;
+                last_digit = i;
+            }
+            else if (digits > 0 && (ch == ' ' || ch == '-') && i == last_digit + 1)
+            {
+                //数字之间允许一个分隔符
+            }
+            else
+            {
+                finish_run();
+            }
+        }
+    }
+    finish_run();
+}
+
+void ContentPrescan::find_signatures(const char *data, size_t length, const std::vector<std::string> &signatures, std::vector<ContentWindow> &hits)
+{
+    for (const auto &signature : signatures)
+    {
+        size_t pos = 0;
+        while (pos < length)
+        {
+            const char *found = kernel::find_bytes(data + pos, length - pos, signature.data(), signature.length());
+            if (nullptr == found)
+            {
+                break;
+            }
+            size_t offset = found - data;
+            hits.push_back({offset, signature.length()});
+            pos = offset + signature.length();
+        }
+    }
+}
+
+std::vector<ContentWindow> ContentPrescan::merge_windows(std::vector<ContentWindow> &windows, const char *data, size_t length, size_t padding)
+{
+    std::vector<ContentWindow> merged;
+    for (auto &window : windows)
+    {
+        size_t start = window.offset > padding ? window.offset - padding : 0;
+        size_t end = std::min(length, window.offset + window.length + padding);
+        while (start > 0 && is_utf8_continuation(data[start]))
+        {
+            --start;
+        }
+        while (end < length && is_utf8_continuation(data[end]))
+        {
+            ++end;
+        }
+        window = {start, end - start};
+    }
+    std::sort(windows.begin(), windows.end(), [](const ContentWindow &lhs, const ContentWindow &rhs) {
+        return lhs.offset < rhs.offset;
+    });
+    for (const auto &window : windows)
+    {
+        if (!merged.empty() && window.offset <= merged.back().offset + merged.back().length)
+        {
+            size_t end = std::max(merged.back().offset + merged.back().length, window.offset + window.length);
+            merged.back().length = end - merged.back().offset;
+        }
+        else
+        {
+            merged.push_back(window);
+        }
+    }
+    return merged;
+}
+
+} // namespace openrasp
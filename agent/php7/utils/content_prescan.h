@@ -0,0 +1,58 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OPENRASP_UTILS_CONTENT_PRESCAN_H_
+#define _OPENRASP_UTILS_CONTENT_PRESCAN_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace openrasp
+{
+
+struct ContentWindow
+{
+    size_t offset;
+    size_t length;
+};
+
+/**
+ * 响应内容预扫描，只把可能包含敏感信息的片段交给插件
+ *
+ * 候选片段为至少 min_digits 个数字组成的数字串（相邻数字之间允许一个空格或 -，覆盖身份证、手机号、银行卡，0 表示不扫描数字），
+ * 以及 signatures 中任一字符串出现的位置；每个片段向两侧各扩展 padding 字节（不截断 UTF-8 字符），重叠的片段合并
+ */
+class ContentPrescan
+{
+private:
+    size_t min_digits;
+    size_t padding;
+    std::vector<std::string> signatures;
+
+public:
+    ContentPrescan(size_t min_digits, size_t padding, const std::vector<std::string> &signatures);
+
+    std::vector<ContentWindow> scan(const char *data, size_t length) const;
+
+    static void find_digit_runs(const char *data, size_t length, size_t min_digits, std::vector<ContentWindow> &runs);
+    static void find_signatures(const char *data, size_t length, const std::vector<std::string> &signatures, std::vector<ContentWindow> &hits);
+    static std::vector<ContentWindow> merge_windows(std::vector<ContentWindow> &windows, const char *data, size_t length, size_t padding);
+};
+
+} // namespace openrasp
+
+#endif
@@ -18,8 +18,11 @@
 #define _DOUBLE_ARRAY_TRIE_H_
 
 #include <vector>
+#include <string>
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <cstdint>
 #include <exception>
 
 namespace openrasp
@@ -31,10 +34,8 @@ template <class T>
 inline T *_resize(T *ptr, size_t n, size_t l, T v)
 {
   T *tmp = new T[l];
-  for (size_t i = 0; i < n; ++i)
-    tmp[i] = ptr[i];
-  for (size_t i = n; i < l; ++i)
-    tmp[i] = v;
+  std::copy(ptr, ptr + n, tmp);
+  std::fill(tmp + n, tmp + l, v);
   delete[] ptr;
   return tmp;
 }
@@ -121,8 +122,30 @@ public:
     key_size_ = key_size;
     value_ = value;
     progress_ = 0;
+    error_ = 0;
 
-    resize(8192);
+    //长度只计算一次；每一层复用同一个 siblings 缓冲区，构建过程中不再为每个节点分配 vector
+    size_t max_length = 0;
+    size_t total_length = 0;
+    if (!length_)
+    {
+      key_lengths_.resize(key_size);
+      for (size_t i = 0; i < key_size; ++i)
+        key_lengths_[i] = (*key)[i].length();
+      length_ = key_lengths_.data();
+    }
+    for (size_t i = 0; i < key_size; ++i)
+    {
+      max_length = _max(max_length, length_[i]);
+      total_length += length_[i];
+    }
+    sibling_pool_.clear();
+    sibling_pool_.resize(max_length + 2);
+
+    next_free_.assign(1, 0);
+    prev_free_.assign(1, 0);
+    //节点数不超过总字节数加 key 数，按此预分配以减少扩容拷贝
+    resize(_max(static_cast<size_t>(8192), total_length + key_size + 256));
 
     array_[0].base = 1;
     next_check_pos_ = 0;
@@ -132,12 +155,21 @@ public:
     root_node.right = key_size;
     root_node.depth = 0;
 
-    std::vector<node_t> siblings;
+    std::vector<node_t> &siblings = sibling_pool_[0];
     fetch(root_node, siblings);
     insert(siblings);
 
     delete[] used_;
     used_ = 0;
+    key_lengths_.clear();
+    key_lengths_.shrink_to_fit();
+    sibling_pool_.clear();
+    sibling_pool_.shrink_to_fit();
+    next_free_.clear();
+    next_free_.shrink_to_fit();
+    prev_free_.clear();
+    prev_free_.shrink_to_fit();
+    length_ = 0;
 
     return error_;
   }
@@ -172,43 +204,101 @@ public:
     return result;
   }
 
-  std::vector<result_pair_type> prefix_search(const char *key,
-                                              size_t len = 0,
-                                              size_t node_pos = 0) const
+  /**
+   * 按从短到长的顺序对 key 的每个前缀匹配调用 callback(const result_pair_type &)，
+   * callback 返回 false 时立即停止；不分配内存，返回匹配次数
+   */
+  template <class Callback>
+  size_t foreach_prefix(const char *key,
+                        size_t len,
+                        Callback &&callback,
+                        size_t node_pos = 0) const
   {
-    std::vector<result_pair_type> result;
-    if (!len)
-      len = std::strlen(key);
-
-    register array_type_ b = array_[node_pos].base;
-    register size_t num = 0;
-    register array_type_ n;
-    register array_u_type_ p;
+    size_t num = 0;
+    array_type_ b = array_[node_pos].base;
+    array_type_ n;
+    array_u_type_ p;
+    result_pair_type result;
 
-    for (register size_t i = 0; i < len; ++i)
+    for (size_t i = 0; i < len; ++i)
     {
       p = b; // + 0;
       n = array_[p].base;
       if ((array_u_type_)b == array_[p].check && n < 0)
       {
-        result.push_back({-n - 1, i});
+        ++num;
+        set_result(&result, -n - 1, i);
+        if (!callback(static_cast<const result_pair_type &>(result)))
+          return num;
       }
 
       p = b + (unsigned char)(key[i]) + 1;
       if ((array_u_type_)b == array_[p].check)
         b = array_[p].base;
       else
-        return result;
+        return num;
     }
 
     p = b;
     n = array_[p].base;
-
     if ((array_u_type_)b == array_[p].check && n < 0)
     {
-      result.push_back({-n - 1, len});
+      ++num;
+      set_result(&result, -n - 1, len);
+      callback(static_cast<const result_pair_type &>(result));
     }
+    return num;
+  }
+
+  /**
+   * 结果写入调用方提供的数组，最多 max_results 个，返回写入个数
+   */
+  size_t prefix_search(const char *key,
+                       size_t len,
+                       result_pair_type *results,
+                       size_t max_results,
+                       size_t node_pos = 0) const
+  {
+    size_t num = 0;
+    if (!max_results)
+      return 0;
+    foreach_prefix(key, len, [&](const result_pair_type &result) {
+      results[num++] = result;
+      return num < max_results;
+    },
+                   node_pos);
+    return num;
+  }
+
+  /**
+   * 最长前缀匹配，状态转移失败时立即返回；未命中时 value 为 -1
+   */
+  result_pair_type longest_prefix(const char *key,
+                                  size_t len,
+                                  size_t node_pos = 0) const
+  {
+    result_pair_type longest;
+    set_result(&longest, -1, 0);
+    foreach_prefix(key, len, [&](const result_pair_type &result) {
+      longest = result;
+      return true;
+    },
+                   node_pos);
+    return longest;
+  }
 
+  std::vector<result_pair_type> prefix_search(const char *key,
+                                              size_t len = 0,
+                                              size_t node_pos = 0) const
+  {
+    std::vector<result_pair_type> result;
+    if (!len)
+      len = std::strlen(key);
+    foreach_prefix(key, len, [&](const result_pair_type &pair) {
+      result.push_back(pair);
+      return true;
+    },
+                   node_pos);
     return result;
   }
 
@@ -239,37 +329,71 @@ private:
   size_t next_check_pos_;
   bool no_delete_;
   int error_;
+  std::vector<size_t> key_lengths_;
+  std::vector<std::vector<node_t>> sibling_pool_;
+  std::vector<uint32_t> next_free_;
+  std::vector<uint32_t> prev_free_;
+
+  //构建时按倍数扩容，避免逐个位置扩容导致的反复复制
+  void reserve(const size_t min_size)
+  {
+    if (alloc_size_ < min_size)
+      resize(_max(min_size, alloc_size_ + (alloc_size_ >> 1)));
+  }
 
   size_t resize(const size_t new_size)
   {
     unit_t tmp;
     tmp.base = 0;
     tmp.check = 0;
+    size_t old_size = alloc_size_;
     array_ = _resize(array_, alloc_size_, new_size, tmp);
     used_ = _resize(used_, alloc_size_, new_size,
                     static_cast<unsigned char>(0));
     alloc_size_ = new_size;
+    if (!next_free_.empty())
+    {
+      next_free_.resize(new_size);
+      prev_free_.resize(new_size);
+      for (size_t i = _max(old_size, static_cast<size_t>(1)); i < new_size; ++i)
+        link_free(i);
+    }
     return new_size;
   }
 
+  //空闲位置组成以 0（根节点，永不空闲）为哨兵的双向链表，按下标递增排列
+  void link_free(size_t pos)
+  {
+    uint32_t tail = prev_free_[0];
+    next_free_[tail] = pos;
+    prev_free_[pos] = tail;
+    next_free_[pos] = 0;
+    prev_free_[0] = pos;
+  }
+
+  void unlink_free(size_t pos)
+  {
+    next_free_[prev_free_[pos]] = next_free_[pos];
+    prev_free_[next_free_[pos]] = prev_free_[pos];
+  }
+
   size_t fetch(const node_t &parent, std::vector<node_t> &siblings)
   {
     if (error_ < 0)
       return 0;
 
     array_u_type_ prev = 0;
+    siblings.clear();
     try
     {
       for (size_t i = parent.left; i < parent.right; ++i)
       {
-        if ((length_ ? length_[i] : key_->at(i).length()) < parent.depth)
+        if (length_[i] < parent.depth)
           continue;
 
-        const unsigned char *tmp = reinterpret_cast<const unsigned char *>(key_->at(i).c_str());
-
         array_u_type_ cur = 0;
-        if ((length_ ? length_[i] : key_->at(i).length()) != parent.depth)
-          cur = (array_u_type_)tmp[parent.depth] + 1;
+        if (length_[i] != parent.depth)
+          cur = (array_u_type_)(unsigned char)(*key_)[i][parent.depth] + 1;
 
         if (prev > cur)
         {
@@ -310,62 +434,58 @@ private:
       return 0;
 
     size_t begin = 0;
-    size_t pos = _max((size_t)siblings[0].code + 1, next_check_pos_) - 1;
-    size_t nonzero_num = 0;
+    const size_t first_code = siblings[0].code;
+    const size_t last_code = siblings[siblings.size() - 1].code;
+    size_t pos = _max(first_code + 1, next_check_pos_);
+    size_t free_num = 0;
     int first = 0;
 
-    if (alloc_size_ <= pos)
-      resize(pos + 1);
+    reserve(pos + 1);
+    while (array_[pos].check)
+      reserve(++pos + 1);
 
+    //从第一个空闲位置开始沿空闲链表查找，跳过已占用的位置
     while (true)
     {
-    next:
-      ++pos;
-
-      if (alloc_size_ <= pos)
-        resize(pos + 1);
-
-      if (array_[pos].check)
-      {
-        ++nonzero_num;
-        continue;
-      }
-      else if (!first)
+      ++free_num;
+      if (!first)
       {
         next_check_pos_ = pos;
         first = 1;
       }
 
-      begin = pos - siblings[0].code;
-      if (alloc_size_ <= (begin + siblings[siblings.size() - 1].code))
-        resize(static_cast<size_t>(alloc_size_ *
-                                   _max(1.05, 1.0 * key_size_ / progress_)));
+      begin = pos - first_code;
+      reserve(begin + last_code + 1);
 
-      if (used_[begin])
-        continue;
+      bool conflict = used_[begin] != 0;
+      for (size_t i = 1; !conflict && i < siblings.size(); ++i)
+        conflict = array_[begin + siblings[i].code].check != 0;
+      if (!conflict)
+        break;
 
-      for (size_t i = 1; i < siblings.size(); ++i)
-        if (array_[begin + siblings[i].code].check != 0)
-          goto next;
-
-      break;
+      if (next_free_[pos] == 0)
+        resize(alloc_size_ + (alloc_size_ >> 1));
+      pos = next_free_[pos];
     }
 
-    if (1.0 * nonzero_num / (pos - next_check_pos_ + 1) >= 0.95)
+    if (1.0 * (pos - next_check_pos_ + 1 - free_num) / (pos - next_check_pos_ + 1) >= 0.95)
       next_check_pos_ = pos;
 
     used_[begin] = 1;
-    size_ = _max(size_, begin + static_cast<size_t>(siblings[siblings.size() - 1].code + 1));
+    size_ = _max(size_, begin + last_code + 1);
 
     for (size_t i = 0; i < siblings.size(); ++i)
+    {
       array_[begin + siblings[i].code].check = begin;
+      unlink_free(begin + siblings[i].code);
+    }
 
     try
     {
       /* code */
       for (size_t i = 0; i < siblings.size(); ++i)
       {
-        std::vector<node_t> new_siblings;
+        std::vector<node_t> &new_siblings = sibling_pool_[siblings[i].depth];
 
         if (!fetch(siblings[i], new_siblings))
         {
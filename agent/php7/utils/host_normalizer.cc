@@ -0,0 +1,185 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "host_normalizer.h"
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <arpa/inet.h>
+
+namespace openrasp
+{
+
+HostNormalizer::HostNormalizer(const openrasp::Url &url)
+{
+    if (!url.has_error())
+    {
+        normalize(url.get_host());
+    }
+}
+
+HostNormalizer::HostNormalizer(const std::string &origin)
+{
+    normalize(origin);
+}
+
+void HostNormalizer::normalize(const std::string &origin)
+{
+    std::string lower;
+    lower.reserve(origin.length());
+    for (char ch : origin)
+    {
+        lower.push_back(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    if (lower.length() > 2 && lower.front() == '[' && lower.back() == ']')
+    {
+        lower = lower.substr(1, lower.length() - 2);
+    }
+    if (lower.find(':') != std::string::npos)
+    {
+        std::string addr = lower.substr(0, lower.find('%'));
+        struct in6_addr in6;
+        char buf[INET6_ADDRSTRLEN] = {0};
+        if (inet_pton(AF_INET6, addr.c_str(), &in6) == 1 &&
+            inet_ntop(AF_INET6, &in6, buf, sizeof(buf)) != nullptr)
+        {
+            host = std::string(buf);
+            ip = true;
+            obfuscated = (host != lower);
+            return;
+        }
+    }
+    while (!lower.empty() && lower.back() == '.')
+    {
+        lower.pop_back();
+    }
+    uint32_t addr = 0;
+    if (parse_ipv4(lower, addr))
+    {
+        char buf[INET_ADDRSTRLEN] = {0};
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u",
+                 (addr >> 24) & 0xff, (addr >> 16) & 0xff, (addr >> 8) & 0xff, addr & 0xff);
+        host = std::string(buf);
+        ip = true;
+        obfuscated = (host != origin);
+        return;
+    }
+    host = lower;
+}
+
+std::string HostNormalizer::get_host() const
+{
+    return host;
+}
+
+bool HostNormalizer::is_ip() const
+{
+    return ip;
+}
+
+bool HostNormalizer::is_obfuscated() const
+{
+    return obfuscated;
+}
+
+bool HostNormalizer::parse_ipv4(const std::string &origin, uint32_t &addr)
+{
+    uint64_t parts[4] = {0};
+    int count = 0;
+    size_t pos = 0;
+    const size_t len = origin.length();
+    if (len == 0)
+    {
+        return false;
+    }
+    while (true)
+    {
+        if (count == 4 || pos >= len)
+        {
+            return false;
+        }
+        int base = 10;
+        if (origin[pos] == '0' && pos + 1 < len && (origin[pos + 1] == 'x' || origin[pos + 1] == 'X'))
+        {
+            base = 16;
+            pos += 2;
+        }
+        else if (origin[pos] == '0' && pos + 1 < len && origin[pos + 1] != '.')
+        {
+            base = 8;
+            pos += 1;
+        }
+        uint64_t value = 0;
+        size_t digits = 0;
+        while (pos < len && origin[pos] != '.')
+        {
+            char ch = origin[pos];
+            int digit = -1;
+            if (ch >= '0' && ch <= '9')
+            {
+                digit = ch - '0';
+            }
+            else if (base == 16 && ch >= 'a' && ch <= 'f')
+            {
+                digit = ch - 'a' + 10;
+            }
+            else if (base == 16 && ch >= 'A' && ch <= 'F')
+            {
+                digit = ch - 'A' + 10;
+            }
+            if (digit < 0 || digit >= base)
+            {
+                return false;
+            }
+            value = value * base + digit;
+            if (value > 0xffffffffULL)
+            {
+                return false;
+            }
+            ++digits;
+            ++pos;
+        }
+        if (digits == 0 && base != 8)
+        {
+            return false;
+        }
+        parts[count++] = value;
+        if (pos >= len)
+        {
+            break;
+        }
+        ++pos;
+    }
+    uint64_t result = 0;
+    for (int i = 0; i < count - 1; ++i)
+    {
+        if (parts[i] > 0xff)
+        {
+            return false;
+        }
+        result |= parts[i] << (8 * (3 - i));
+    }
+    uint64_t last_max = 0xffffffffULL >> (8 * (count - 1));
+    if (parts[count - 1] > last_max)
+    {
+        return false;
+    }
+    addr = static_cast<uint32_t>(result | parts[count - 1]);
+    return true;
+}
+
+} // namespace openrasp
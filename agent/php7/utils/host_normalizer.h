@@ -0,0 +1,57 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _OPENRASP_UTILS_HOST_NORMALIZER_H_
+#define _OPENRASP_UTILS_HOST_NORMALIZER_H_
+
+#include <string>
+#include "url.h"
+
+namespace openrasp
+{
+
+/**
+ * 规范化 url 中的 host
+ * 
+ * 域名转小写并去掉结尾的 .
+ * IPv4 按照 inet_aton 的规则解析，兼容十进制、八进制、十六进制以及省略写法，例如
+ * 2130706433、0177.0.0.1、0x7f.1、127.1 都会被规范化为 127.0.0.1
+ * IPv6 去掉中括号以及 zone id 后按照 inet_ntop 输出
+ */
+class HostNormalizer
+{
+private:
+    std::string host;
+    bool ip = false;
+    bool obfuscated = false;
+
+    void normalize(const std::string &origin);
+
+public:
+    explicit HostNormalizer(const openrasp::Url &url);
+    explicit HostNormalizer(const std::string &origin);
+
+    std::string get_host() const;
+    bool is_ip() const;
+    bool is_obfuscated() const;
+
+    static bool parse_ipv4(const std::string &origin, uint32_t &addr);
+};
+
+} // namespace openrasp
+
+#endif
@@ -0,0 +1,441 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "json_validator.h"
+
+namespace openrasp
+{
+
+static inline bool is_space(unsigned char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool is_digit(unsigned char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline int hex_value(unsigned char c)
+{
+    if (is_digit(c))
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+void JsonValidator::reset()
+{
+    state = kValue;
+    stack.clear();
+    in_key = false;
+    error = false;
+    pending = 0;
+    code_unit = 0;
+    low_surrogate = false;
+    literal = nullptr;
+}
+
+bool JsonValidator::feed(const char *data, size_t length)
+{
+    if (error)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (!step(static_cast<unsigned char>(data[i])))
+        {
+            error = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JsonValidator::finish()
+{
+    if (error)
+    {
+        return false;
+    }
+    //顶层数字没有结束符
+    if (state == kZero || state == kInteger || state == kFraction || state == kExponent)
+    {
+        end_value();
+    }
+    return state == kDone;
+}
+
+void JsonValidator::end_value()
+{
+    state = stack.empty() ? kDone : kCommaOrEnd;
+}
+
+bool JsonValidator::end_number(unsigned char c)
+{
+    end_value();
+    return step(c);
+}
+
+bool JsonValidator::begin_value(unsigned char c)
+{
+    switch (c)
+    {
+    case '{':
+    case '[':
+        if (stack.size() >= max_depth)
+        {
+            return false;
+        }
+        stack.push_back(c);
+        state = c == '{' ? kKeyOrEnd : kValueOrEnd;
+        return true;
+    case '"':
+        in_key = false;
+        state = kString;
+        return true;
+    case '-':
+        state = kMinus;
+        return true;
+    case '0':
+        state = kZero;
+        return true;
+    case 't':
+        literal = "rue";
+        state = kLiteral;
+        return true;
+    case 'f':
+        literal = "alse";
+        state = kLiteral;
+        return true;
+    case 'n':
+        literal = "ull";
+        state = kLiteral;
+        return true;
+    default:
+        if (c >= '1' && c <= '9')
+        {
+            state = kInteger;
+            return true;
+        }
+        return false;
+    }
+}
+
+bool JsonValidator::step(unsigned char c)
+{
+    switch (state)
+    {
+    case kValue:
+        return is_space(c) || begin_value(c);
+    case kValueOrEnd:
+        if (is_space(c))
+        {
+            return true;
+        }
+        if (c == ']')
+        {
+            stack.pop_back();
+            end_value();
+            return true;
+        }
+        return begin_value(c);
+    case kKeyOrEnd:
+    case kKey:
+        if (is_space(c))
+        {
+            return true;
+        }
+        if (c == '}' && state == kKeyOrEnd)
+        {
+            stack.pop_back();
+            end_value();
+            return true;
+        }
+        if (c == '"')
+        {
+            in_key = true;
+            state = kString;
+            return true;
+        }
+        return false;
+    case kColon:
+        if (c == ':')
+        {
+            state = kValue;
+            return true;
+        }
+        return is_space(c);
+    case kCommaOrEnd:
+        if (is_space(c))
+        {
+            return true;
+        }
+        if (c == ',')
+        {
+            state = stack.back() == '{' ? kKey : kValue;
+            return true;
+        }
+        if ((c == '}' && stack.back() == '{') || (c == ']' && stack.back() == '['))
+        {
+            stack.pop_back();
+            end_value();
+            return true;
+        }
+        return false;
+    case kString:
+        if (c == '"')
+        {
+            if (in_key)
+            {
+                in_key = false;
+                state = kColon;
+            }
+            else
+            {
+                end_value();
+            }
+            return true;
+        }
+        if (c == '\\')
+        {
+            state = kEscape;
+            return true;
+        }
+        if (c < 0x20)
+        {
+            return false;
+        }
+        if (c < 0x80)
+        {
+            return true;
+        }
+        //RFC 3629：排除过长编码、代理区与超出 U+10FFFF 的码点
+        utf8_lower = 0x80;
+        utf8_upper = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF)
+        {
+            pending = 1;
+        }
+        else if (c >= 0xE0 && c <= 0xEF)
+        {
+            pending = 2;
+            if (c == 0xE0)
+            {
+                utf8_lower = 0xA0;
+            }
+            else if (c == 0xED)
+            {
+                utf8_upper = 0x9F;
+            }
+        }
+        else if (c >= 0xF0 && c <= 0xF4)
+        {
+            pending = 3;
+            if (c == 0xF0)
+            {
+                utf8_lower = 0x90;
+            }
+            else if (c == 0xF4)
+            {
+                utf8_upper = 0x8F;
+            }
+        }
+        else
+        {
+            return false;
+        }
+        state = kUtf8;
+        return true;
+    case kUtf8:
+        if (c < utf8_lower || c > utf8_upper)
+        {
+            return false;
+        }
+        utf8_lower = 0x80;
+        utf8_upper = 0xBF;
+        if (--pending == 0)
+        {
+            state = kString;
+        }
+        return true;
+    case kEscape:
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            state = kString;
+            return true;
+        case 'u':
+            pending = 4;
+            code_unit = 0;
+            state = kUnicode;
+            return true;
+        default:
+            return false;
+        }
+    case kUnicode:
+    {
+        int value = hex_value(c);
+        if (value < 0)
+        {
+            return false;
+        }
+        code_unit = (code_unit << 4) | static_cast<uint32_t>(value);
+        if (--pending != 0)
+        {
+            return true;
+        }
+        bool is_high = code_unit >= 0xD800 && code_unit <= 0xDBFF;
+        bool is_low = code_unit >= 0xDC00 && code_unit <= 0xDFFF;
+        //高代理项后必须紧跟低代理项，低代理项不能单独出现
+        if (low_surrogate != is_low)
+        {
+            return false;
+        }
+        low_surrogate = false;
+        if (is_high)
+        {
+            low_surrogate = true;
+            state = kSurrogateEscape;
+        }
+        else
+        {
+            state = kString;
+        }
+        return true;
+    }
+    case kSurrogateEscape:
+        if (c != '\\')
+        {
+            return false;
+        }
+        state = kSurrogateU;
+        return true;
+    case kSurrogateU:
+        if (c != 'u')
+        {
+            return false;
+        }
+        pending = 4;
+        code_unit = 0;
+        state = kUnicode;
+        return true;
+    case kMinus:
+        if (c == '0')
+        {
+            state = kZero;
+            return true;
+        }
+        if (c >= '1' && c <= '9')
+        {
+            state = kInteger;
+            return true;
+        }
+        return false;
+    case kZero:
+    case kInteger:
+        if (is_digit(c) && state == kInteger)
+        {
+            return true;
+        }
+        if (c == '.')
+        {
+            state = kFractionStart;
+            return true;
+        }
+        if (c == 'e' || c == 'E')
+        {
+            state = kExponentStart;
+            return true;
+        }
+        return end_number(c);
+    case kFractionStart:
+        if (is_digit(c))
+        {
+            state = kFraction;
+            return true;
+        }
+        return false;
+    case kFraction:
+        if (is_digit(c))
+        {
+            return true;
+        }
+        if (c == 'e' || c == 'E')
+        {
+            state = kExponentStart;
+            return true;
+        }
+        return end_number(c);
+    case kExponentStart:
+        if (c == '+' || c == '-')
+        {
+            state = kExponentSign;
+            return true;
+        }
+        if (is_digit(c))
+        {
+            state = kExponent;
+            return true;
+        }
+        return false;
+    case kExponentSign:
+        if (is_digit(c))
+        {
+            state = kExponent;
+            return true;
+        }
+        return false;
+    case kExponent:
+        if (is_digit(c))
+        {
+            return true;
+        }
+        return end_number(c);
+    case kLiteral:
+        if (c != static_cast<unsigned char>(*literal))
+        {
+            return false;
+        }
+        if (*++literal == '\0')
+        {
+            end_value();
+        }
+        return true;
+    case kDone:
+        return is_space(c);
+    }
+    return false;
+}
+
+} // namespace openrasp
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OPENRASP_UTILS_JSON_VALIDATOR_H_
+#define _OPENRASP_UTILS_JSON_VALIDATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace openrasp
+{
+
+/**
+ * 流式 JSON 语法校验，按段喂入数据，不构建 DOM，只保留容器嵌套栈
+ * feed() 遇到语法错误立即返回 false；数据在上限处被截断时，只要已读部分是合法前缀即可视为通过
+ * 字符串内校验 UTF-8 编码、控制字符与 \u 代理项配对，与完整解析的判定一致
+ */
+class JsonValidator
+{
+public:
+    static const size_t max_depth = 512;
+
+    bool feed(const char *data, size_t length);
+    //数据全部喂入后调用，顶层值完整时返回 true
+    bool finish();
+    bool has_error() const
+    {
+        return error;
+    }
+    void reset();
+
+private:
+    enum State
+    {
+        kValue = 0,
+        kValueOrEnd,
+        kKey,
+        kKeyOrEnd,
+        kColon,
+        kCommaOrEnd,
+        kString,
+        kEscape,
+        kUnicode,
+        kSurrogateEscape,
+        kSurrogateU,
+        kUtf8,
+        kMinus,
+        kZero,
+        kInteger,
+        kFractionStart,
+        kFraction,
+        kExponentStart,
+        kExponentSign,
+        kExponent,
+        kLiteral,
+        kDone
+    };
+
+    State state = kValue;
+    //'{' 或 '['
+    std::string stack;
+    bool in_key = false;
+    bool error = false;
+    uint32_t pending = 0;
+    //\uXXXX 累积的码元
+    uint32_t code_unit = 0;
+    //已读到高代理项，当前 \uXXXX 须为低代理项
+    bool low_surrogate = false;
+    unsigned char utf8_lower = 0x80;
+    unsigned char utf8_upper = 0xBF;
+    const char *literal = nullptr;
+
+    bool step(unsigned char c);
+    bool begin_value(unsigned char c);
+    void end_value();
+    bool end_number(unsigned char c);
+};
+
+} // namespace openrasp
+
+#endif
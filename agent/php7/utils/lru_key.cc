@@ -0,0 +1,258 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lru_key.h"
+#include <cstring>
+#include <chrono>
+#include <random>
+
+namespace openrasp
+{
+
+static const uint64_t stable_seed = 0x9e3779b97f4a7c15ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+//MurmurHash3 x64 的单路混合与收尾
+static inline uint64_t mix_word(uint64_t h, uint64_t word)
+{
+    word *= 0x87c37b91114253d5ULL;
+    word = rotl64(word, 31);
+    word *= 0x4cf5ad432745937fULL;
+    h ^= word;
+    h = rotl64(h, 27);
+    return h * 5 + 0x52dce729;
+}
+
+static inline uint64_t fmix64(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+//每个进程首次使用时生成，攻击者无法离线构造冲突的键
+static uint64_t process_seed()
+{
+    static const uint64_t seed = []() {
+        std::random_device rd;
+        uint64_t value = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        return value ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }();
+    return seed;
+}
+
+LruKey::LruKey(uint64_t seed, bool)
+    : state(seed)
+{
+}
+
+LruKey::LruKey()
+    : LruKey(process_seed(), true)
+{
+}
+
+LruKey::LruKey(uint32_t type_id)
+    : LruKey(process_seed(), true)
+{
+    char buf[sizeof(type_id)];
+    memcpy(buf, &type_id, sizeof(type_id));
+    append_inline(buf, sizeof(buf));
+}
+
+LruKey LruKey::stable()
+{
+    return LruKey(stable_seed, true);
+}
+
+void LruKey::update(const char *data, size_t size)
+{
+    length += size;
+    if (pending_length > 0)
+    {
+        while (size > 0 && pending_length < 8)
+        {
+            pending |= static_cast<uint64_t>(static_cast<unsigned char>(*data++)) << (pending_length * 8);
+            ++pending_length;
+            --size;
+        }
+        if (pending_length < 8)
+        {
+            return;
+        }
+        state = mix_word(state, pending);
+        pending = 0;
+        pending_length = 0;
+    }
+    while (size >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        state = mix_word(state, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size > 0)
+    {
+        pending |= static_cast<uint64_t>(static_cast<unsigned char>(*data++)) << (pending_length * 8);
+        ++pending_length;
+        --size;
+    }
+}
+
+void LruKey::spill_slices()
+{
+    spill.reserve(length + inline_capacity);
+    for (size_t i = 0; i < slice_count; ++i)
+    {
+        spill.append(slice_data(slices[i]), slices[i].length);
+    }
+    slice_count = 0;
+    spilled = true;
+}
+
+void LruKey::append_inline(const char *data, size_t size)
+{
+    if (!spilled && inline_length + size > inline_capacity)
+    {
+        spill_slices();
+    }
+    if (spilled)
+    {
+        spill.append(data, size);
+        update(data, size);
+        return;
+    }
+    memcpy(inline_data + inline_length, data, size);
+    Slice *last = slice_count > 0 ? &slices[slice_count - 1] : nullptr;
+    //紧接上一段内部数据时直接延长
+    if (nullptr != last && nullptr == last->data && last->offset + last->length == inline_length)
+    {
+        last->length += size;
+    }
+    else
+    {
+        if (slice_count == max_slices)
+        {
+            spill_slices();
+            spill.append(data, size);
+            update(data, size);
+            return;
+        }
+        slices[slice_count++] = {nullptr, static_cast<uint32_t>(inline_length), static_cast<uint32_t>(size)};
+    }
+    inline_length += size;
+    update(data, size);
+}
+
+LruKey &LruKey::append(const char *data, size_t size)
+{
+    if (0 == size)
+    {
+        return *this;
+    }
+    if (!spilled && (slice_count == max_slices || size > UINT32_MAX))
+    {
+        spill_slices();
+    }
+    if (spilled)
+    {
+        spill.append(data, size);
+    }
+    else
+    {
+        slices[slice_count++] = {data, 0, static_cast<uint32_t>(size)};
+    }
+    update(data, size);
+    return *this;
+}
+
+LruKey &LruKey::append(char ch)
+{
+    append_inline(&ch, 1);
+    return *this;
+}
+
+LruKey &LruKey::append_number(int64_t number)
+{
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    char *p = end;
+    uint64_t value = number < 0 ? 0 - static_cast<uint64_t>(number) : static_cast<uint64_t>(number);
+    do
+    {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    if (number < 0)
+    {
+        *--p = '-';
+    }
+    append_inline(p, end - p);
+    return *this;
+}
+
+size_t LruKey::hash() const
+{
+    uint64_t h = state;
+    if (pending_length > 0)
+    {
+        h = mix_word(h, pending);
+    }
+    h ^= static_cast<uint64_t>(length);
+    return static_cast<size_t>(fmix64(h));
+}
+
+bool LruKey::equals(const char *data, size_t size) const
+{
+    if (size != length)
+    {
+        return false;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < slice_count; ++i)
+    {
+        if (0 != memcmp(slice_data(slices[i]), data + offset, slices[i].length))
+        {
+            return false;
+        }
+        offset += slices[i].length;
+    }
+    return !spilled || 0 == memcmp(spill.data(), data + offset, spill.length());
+}
+
+std::string LruKey::bytes() const
+{
+    std::string result;
+    result.reserve(length);
+    for (size_t i = 0; i < slice_count; ++i)
+    {
+        result.append(slice_data(slices[i]), slices[i].length);
+    }
+    if (spilled)
+    {
+        result.append(spill);
+    }
+    return result;
+}
+
+} // namespace openrasp
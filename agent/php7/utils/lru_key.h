@@ -0,0 +1,114 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OPENRASP_UTILS_LRU_KEY_H_
+#define _OPENRASP_UTILS_LRU_KEY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace openrasp
+{
+
+/**
+ * 检测结果缓存的键，追加字段时增量计算带种子的 64 位哈希，不拼接中间字符串
+ * 字段只记录指针与长度，引用的数据在键使用期间必须有效；检测类型、分隔符与数字写入内部的小缓冲区
+ * 哈希只取决于拼接后的字节序列，与分段方式无关；equals()/bytes() 用于命中时校验哈希冲突
+ */
+class LruKey
+{
+public:
+    static const size_t max_slices = 16;
+    static const size_t inline_capacity = 64;
+
+    //空键表示不缓存
+    LruKey();
+    //以检测类型开头，使用进程内随机种子
+    explicit LruKey(uint32_t type_id);
+    //固定种子，哈希值可以跨进程比较（如共享内存中的日志去重）
+    static LruKey stable();
+
+    LruKey &append(const char *data, size_t length);
+    LruKey &append(const std::string &str)
+    {
+        return append(str.data(), str.length());
+    }
+    LruKey &append(char ch);
+    LruKey &append_number(int64_t number);
+
+    bool empty() const
+    {
+        return 0 == length;
+    }
+    size_t size() const
+    {
+        return length;
+    }
+    size_t hash() const;
+    bool equals(const char *data, size_t size) const;
+    std::string bytes() const;
+
+private:
+    struct Slice
+    {
+        //为空时引用 inline_data 中的 offset
+        const char *data;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    uint64_t state;
+    uint64_t pending = 0;
+    size_t pending_length = 0;
+    size_t length = 0;
+
+    Slice slices[max_slices];
+    size_t slice_count = 0;
+    char inline_data[inline_capacity];
+    size_t inline_length = 0;
+    //字段过多时退化为一次拼接
+    std::string spill;
+    bool spilled = false;
+
+    explicit LruKey(uint64_t seed, bool);
+    void update(const char *data, size_t size);
+    void append_inline(const char *data, size_t size);
+    void spill_slices();
+    const char *slice_data(const Slice &slice) const
+    {
+        return slice.data ? slice.data : inline_data + slice.offset;
+    }
+};
+
+inline size_t lru_key_hash(const LruKey &key)
+{
+    return key.hash();
+}
+
+inline bool lru_key_equals(const LruKey &key, const std::string &bytes)
+{
+    return key.equals(bytes.data(), bytes.length());
+}
+
+inline std::string lru_key_bytes(const LruKey &key)
+{
+    return key.bytes();
+}
+
+} // namespace openrasp
+
+#endif
@@ -14,9 +14,13 @@
  * limitations under the License.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE 1
+#endif
 #include "openrasp.h"
 #include "net.h"
 #include <string>
+#include <atomic>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sstream>
@@ -45,6 +49,7 @@
 #include <net/if.h>
 #include <netpacket/packet.h>
 #include <arpa/inet.h>
+#include <signal.h>
 #elif defined(__APPLE__) && defined(__MACH__)
 #include <netdb.h>
 #include <ifaddrs.h>
@@ -253,41 +258,160 @@ bool fetch_source_in_ip_packets(char *local_ip, size_t len, char *url)
     return false;
 }
 
-std::vector<std::string> lookup_host(const std::string &host)
+static void collect_addrinfo(struct addrinfo *res, std::vector<std::string> &ips)
 {
-    std::vector<std::string> ips;
-    struct addrinfo hints, *res;
-    int errcode;
-    char addrstr[100];
-    void *ptr;
+    char addrstr[INET6_ADDRSTRLEN];
+    for (struct addrinfo *cur = res; cur != nullptr; cur = cur->ai_next)
+    {
+        void *ptr = nullptr;
+        switch (cur->ai_family)
+        {
+        case AF_INET:
+            ptr = &((struct sockaddr_in *)cur->ai_addr)->sin_addr;
+            break;
+        case AF_INET6:
+            ptr = &((struct sockaddr_in6 *)cur->ai_addr)->sin6_addr;
+            break;
+        default:
+            continue;
+        }
+        if (inet_ntop(cur->ai_family, ptr, addrstr, sizeof(addrstr)) != nullptr)
+        {
+            ips.push_back(addrstr);
+        }
+    }
+    std::sort(ips.begin(), ips.end());
+}
 
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = PF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-    hints.ai_flags |= AI_CANONNAME;
+//只有域名确定不存在时才返回 kDnsNotFound，EAI_AGAIN 等临时错误不应被缓存
+static DnsStatus status_of_gai_error(int errcode)
+{
+    switch (errcode)
+    {
+    case EAI_NONAME:
+#if defined(EAI_NODATA) && EAI_NODATA != EAI_NONAME
+    case EAI_NODATA:
+#endif
+        return kDnsNotFound;
+    case EAI_AGAIN:
+        return kDnsTimeout;
+    default:
+        return kDnsError;
+    }
+}
 
-    errcode = getaddrinfo(host.c_str(), nullptr, &hints, &res);
-    if (errcode == 0)
+#ifdef HAVE_GETADDRINFO_A
+/**
+ * getaddrinfo_a 的请求在超时后可能仍在解析线程中执行，无法立即释放
+ * owners 初始为 2 (调用方 + 完成回调)，最后一个释放者负责回收
+ */
+struct AsyncLookup
+{
+    struct gaicb request;
+    struct addrinfo hints;
+    std::string host;
+    std::atomic<int> owners;
+};
+
+static void release_async_lookup(AsyncLookup *lookup)
+{
+    if (lookup->owners.fetch_sub(1) == 1)
     {
-        while (res)
+        if (lookup->request.ar_result != nullptr)
         {
-            inet_ntop(res->ai_family, res->ai_addr->sa_data, addrstr, 100);
+            freeaddrinfo(lookup->request.ar_result);
+        }
+        delete lookup;
+    }
+}
 
-            switch (res->ai_family)
-            {
-            case AF_INET:
-                ptr = &((struct sockaddr_in *)res->ai_addr)->sin_addr;
-                break;
-            case AF_INET6:
-                ptr = &((struct sockaddr_in6 *)res->ai_addr)->sin6_addr;
-                break;
-            }
-            inet_ntop(res->ai_family, ptr, addrstr, 100);
-            ips.push_back(addrstr);
-            res = res->ai_next;
+static void async_lookup_notify(union sigval sv)
+{
+    release_async_lookup(static_cast<AsyncLookup *>(sv.sival_ptr));
+}
+
+static DnsStatus lookup_host_async(const std::string &host, std::vector<std::string> &ips, long timeout_ms)
+{
+    AsyncLookup *lookup = new AsyncLookup();
+    lookup->host = host;
+    lookup->owners = 2;
+    memset(&lookup->hints, 0, sizeof(lookup->hints));
+    lookup->hints.ai_family = PF_UNSPEC;
+    lookup->hints.ai_socktype = SOCK_STREAM;
+    memset(&lookup->request, 0, sizeof(lookup->request));
+    lookup->request.ar_name = lookup->host.c_str();
+    lookup->request.ar_request = &lookup->hints;
+
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = async_lookup_notify;
+    sev.sigev_value.sival_ptr = lookup;
+
+    struct gaicb *list[1] = {&lookup->request};
+    if (getaddrinfo_a(GAI_NOWAIT, list, 1, &sev) != 0)
+    {
+        delete lookup;
+        return kDnsError;
+    }
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+    const struct gaicb *wait_list[1] = {&lookup->request};
+    gai_suspend(wait_list, 1, &timeout);
+
+    DnsStatus status = kDnsError;
+    int errcode = gai_error(&lookup->request);
+    if (errcode == 0)
+    {
+        collect_addrinfo(lookup->request.ar_result, ips);
+        status = kDnsOk;
+    }
+    else if (errcode == EAI_INPROGRESS)
+    {
+        status = kDnsTimeout;
+        if (gai_cancel(&lookup->request) == EAI_CANCELED)
+        {
+            // canceled before running, the completion callback will never fire
+            release_async_lookup(lookup);
         }
     }
-    std::sort(ips.begin(), ips.end());
+    else
+    {
+        status = status_of_gai_error(errcode);
+    }
+    release_async_lookup(lookup);
+    return status;
+}
+#endif
+
+DnsStatus lookup_host(const std::string &host, std::vector<std::string> &ips, long timeout_ms)
+{
+#ifdef HAVE_GETADDRINFO_A
+    if (timeout_ms > 0)
+    {
+        return lookup_host_async(host, ips, timeout_ms);
+    }
+#endif
+    struct addrinfo hints, *res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = PF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags |= AI_CANONNAME;
+    int errcode = getaddrinfo(host.c_str(), nullptr, &hints, &res);
+    if (errcode != 0)
+    {
+        return status_of_gai_error(errcode);
+    }
+    collect_addrinfo(res, ips);
+    freeaddrinfo(res);
+    return kDnsOk;
+}
+
+std::vector<std::string> lookup_host(const std::string &host)
+{
+    std::vector<std::string> ips;
+    lookup_host(host, ips, 0);
     return ips;
 }
 
@@ -27,7 +27,18 @@ namespace openrasp
 void fetch_if_addrs(std::map<std::string, std::string> &if_addr_map);
 void fetch_hw_addrs(std::vector<std::string> &hw_addrs);
 bool fetch_source_in_ip_packets(char *local_ip, size_t len, char *url);
+
+enum DnsStatus
+{
+    kDnsOk = 0,
+    kDnsError,
+    kDnsTimeout,
+    //域名不存在，结果确定，可以缓存
+    kDnsNotFound
+};
+
 std::vector<std::string> lookup_host(const std::string &host);
+DnsStatus lookup_host(const std::string &host, std::vector<std::string> &ips, long timeout_ms);
 
 } // namespace openrasp
 
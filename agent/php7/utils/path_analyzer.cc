@@ -0,0 +1,165 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "path_analyzer.h"
+#include "string_kernel.h"
+#include <cctype>
+
+namespace openrasp
+{
+
+static inline bool is_separator(char ch)
+{
+    return ch == '/' || ch == '\\';
+}
+
+static bool range_case_equal(const char *lhs, const char *rhs, size_t len)
+{
+    return kernel::equal_ignore_case(lhs, rhs, len);
+}
+
+PathAnalyzer::PathAnalyzer(const std::string &path, const std::string &realpath,
+                           const std::string &webroot, const std::vector<std::string> &sensitive_paths)
+{
+    traversal_depth = count_traversal(path.c_str(), path.length());
+    scheme = fetch_scheme(path.c_str(), path.length());
+    if (scheme.empty() && !realpath.empty())
+    {
+        outside_webroot = !webroot.empty() && !in_directory(realpath, webroot);
+        sensitive = match_sensitive(realpath, sensitive_paths);
+    }
+}
+
+int PathAnalyzer::get_traversal_depth() const
+{
+    return traversal_depth;
+}
+
+std::string PathAnalyzer::get_scheme() const
+{
+    return scheme;
+}
+
+bool PathAnalyzer::is_outside_webroot() const
+{
+    return outside_webroot;
+}
+
+bool PathAnalyzer::is_sensitive() const
+{
+    return sensitive;
+}
+
+int PathAnalyzer::count_traversal(const char *path, size_t len)
+{
+    static const kernel::ByteSet separators("/\\");
+    int depth = 0;
+    size_t seg_start = 0;
+    while (seg_start <= len)
+    {
+        size_t i = seg_start + kernel::find_first_of(path + seg_start, len - seg_start, separators);
+        if (i - seg_start == 2 && path[seg_start] == '.' && path[seg_start + 1] == '.')
+        {
+            ++depth;
+        }
+        seg_start = i + 1;
+    }
+    return depth;
+}
+
+std::string PathAnalyzer::fetch_scheme(const char *path, size_t len)
+{
+    std::string result;
+    size_t pos = 0;
+    while (pos < len &&
+           (std::isalnum(static_cast<unsigned char>(path[pos])) || path[pos] == '+' || path[pos] == '-' || path[pos] == '.'))
+    {
+        ++pos;
+    }
+    if (pos < len && path[pos] == ':')
+    {
+        // same rule as php_stream_locate_url_wrapper, "data:" is the only wrapper without "//"
+        bool with_slashes = pos > 1 && pos + 2 < len && path[pos + 1] == '/' && path[pos + 2] == '/';
+        bool data_wrapper = pos == 4 && range_case_equal(path, "data", 4);
+        if (with_slashes || data_wrapper)
+        {
+            result.reserve(pos);
+            for (size_t i = 0; i < pos; ++i)
+            {
+                result.push_back(std::tolower(static_cast<unsigned char>(path[i])));
+            }
+        }
+    }
+    return result;
+}
+
+bool PathAnalyzer::in_directory(const std::string &realpath, const std::string &directory)
+{
+    size_t dir_len = directory.length();
+    while (dir_len > 0 && is_separator(directory[dir_len - 1]))
+    {
+        --dir_len;
+    }
+    if (dir_len == 0)
+    {
+        return !realpath.empty() && is_separator(realpath[0]);
+    }
+    if (realpath.length() < dir_len || realpath.compare(0, dir_len, directory, 0, dir_len) != 0)
+    {
+        return false;
+    }
+    return realpath.length() == dir_len || is_separator(realpath[dir_len]);
+}
+
+bool PathAnalyzer::match_sensitive(const std::string &realpath, const std::vector<std::string> &sensitive_paths)
+{
+    size_t basename_pos = realpath.find_last_of("/\\");
+    basename_pos = (basename_pos == std::string::npos) ? 0 : basename_pos + 1;
+    const char *basename = realpath.c_str() + basename_pos;
+    size_t basename_len = realpath.length() - basename_pos;
+    for (const std::string &entry : sensitive_paths)
+    {
+        if (entry.empty())
+        {
+            continue;
+        }
+        if (entry.find_first_of("/\\") == std::string::npos)
+        {
+            if (entry.length() == basename_len && range_case_equal(entry.c_str(), basename, basename_len))
+            {
+                return true;
+            }
+        }
+        else if (is_separator(entry.back()) && entry.length() > 1)
+        {
+            size_t dir_len = entry.length() - 1;
+            if (realpath.length() >= dir_len &&
+                range_case_equal(entry.c_str(), realpath.c_str(), dir_len) &&
+                (realpath.length() == dir_len || is_separator(realpath[dir_len])))
+            {
+                return true;
+            }
+        }
+        else if (entry.length() == realpath.length() && range_case_equal(entry.c_str(), realpath.c_str(), entry.length()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace openrasp
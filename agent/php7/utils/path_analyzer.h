@@ -0,0 +1,59 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OPENRASP_UTILS_PATH_ANALYZER_H_
+#define _OPENRASP_UTILS_PATH_ANALYZER_H_
+
+#include <string>
+#include <vector>
+
+namespace openrasp
+{
+
+/**
+ * 对已经解析过的路径做预分析，结果直接交给插件，避免在 v8 中做字符串处理
+ * 
+ * traversal_depth  原始路径中 .. 片段的个数 (/ 与 \ 同等对待)
+ * scheme           原始路径中的 wrapper 协议，小写，没有则为空
+ * outside_webroot  realpath 不在 webroot 之下 (webroot 为空或者带协议时恒为 false)
+ * sensitive        realpath 命中敏感路径列表
+ */
+class PathAnalyzer
+{
+private:
+    int traversal_depth = 0;
+    std::string scheme;
+    bool outside_webroot = false;
+    bool sensitive = false;
+
+public:
+    PathAnalyzer(const std::string &path, const std::string &realpath,
+                 const std::string &webroot, const std::vector<std::string> &sensitive_paths);
+
+    int get_traversal_depth() const;
+    std::string get_scheme() const;
+    bool is_outside_webroot() const;
+    bool is_sensitive() const;
+
+    static int count_traversal(const char *path, size_t len);
+    static std::string fetch_scheme(const char *path, size_t len);
+    static bool in_directory(const std::string &realpath, const std::string &directory);
+    static bool match_sensitive(const std::string &realpath, const std::vector<std::string> &sensitive_paths);
+};
+
+} // namespace openrasp
+
+#endif
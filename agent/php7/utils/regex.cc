@@ -15,37 +15,282 @@
  */
 
 #include "regex.h"
-#include <regex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <cstring>
+#include <unordered_map>
+
+extern "C"
+{
+#include "php.h"
+#include "ext/pcre/php_pcre.h"
+}
+
+#if (PHP_MAJOR_VERSION == 7 && PHP_MINOR_VERSION < 3)
+#define OPENRASP_PCRE1
+#endif
 
 namespace openrasp
 {
 
-bool regex_match(const char *str, const char *regex)
+class CompiledRegex
 {
-    try
+private:
+#ifdef OPENRASP_PCRE1
+    pcre *re = nullptr;
+    pcre_extra *extra = nullptr;
+#else
+    pcre2_code *re = nullptr;
+#endif
+
+public:
+    explicit CompiledRegex(const std::string &pattern)
+    {
+#ifdef OPENRASP_PCRE1
+        const char *error = nullptr;
+        int erroffset = 0;
+        re = pcre_compile(pattern.c_str(), 0, &error, &erroffset, nullptr);
+        if (nullptr != re)
+        {
+#ifdef PCRE_STUDY_JIT_COMPILE
+            extra = pcre_study(re, PCRE_STUDY_JIT_COMPILE, &error);
+#else
+            extra = pcre_study(re, 0, &error);
+#endif
+        }
+#else
+        int errorcode = 0;
+        PCRE2_SIZE erroffset = 0;
+        re = pcre2_compile(reinterpret_cast<PCRE2_SPTR>(pattern.c_str()), pattern.length(), 0, &errorcode, &erroffset, nullptr);
+        if (nullptr != re)
+        {
+            //不支持 JIT 时返回错误，仍使用解释执行
+            pcre2_jit_compile(re, PCRE2_JIT_COMPLETE);
+        }
+#endif
+    }
+    ~CompiledRegex()
     {
-        const std::regex re(regex);
-        return std::regex_match(str, re);
+#ifdef OPENRASP_PCRE1
+        if (nullptr != extra)
+        {
+#ifdef PCRE_STUDY_JIT_COMPILE
+            pcre_free_study(extra);
+#else
+            pcre_free(extra);
+#endif
+        }
+        if (nullptr != re)
+        {
+            pcre_free(re);
+        }
+#else
+        if (nullptr != re)
+        {
+            pcre2_code_free(re);
+        }
+#endif
     }
-    catch (std::regex_error &e)
+    CompiledRegex(const CompiledRegex &) = delete;
+    CompiledRegex &operator=(const CompiledRegex &) = delete;
+
+    bool is_valid() const
+    {
+        return nullptr != re;
+    }
+    bool search(const char *str, size_t length) const
     {
-        //skip
+#ifdef OPENRASP_PCRE1
+        int ovector[3];
+        return pcre_exec(re, extra, str, static_cast<int>(length), 0, 0, ovector, 3) >= 0;
+#else
+        pcre2_match_data *match_data = thread_match_data.get();
+        if (nullptr == match_data)
+        {
+            return false;
+        }
+        return pcre2_match(re, reinterpret_cast<PCRE2_SPTR>(str), length, 0, 0, match_data, nullptr) >= 0;
+#endif
     }
-    return false;
+
+private:
+#ifndef OPENRASP_PCRE1
+    /**
+     * 只判断是否匹配，不取分组，每个线程复用一块 match data
+     */
+    class MatchData
+    {
+    private:
+        pcre2_match_data *data = nullptr;
+
+    public:
+        ~MatchData()
+        {
+            if (nullptr != data)
+            {
+                pcre2_match_data_free(data);
+            }
+        }
+        pcre2_match_data *get()
+        {
+            if (nullptr == data)
+            {
+                data = pcre2_match_data_create(1, nullptr);
+            }
+            return data;
+        }
+    };
+    static thread_local MatchData thread_match_data;
+#endif
+};
+
+#ifndef OPENRASP_PCRE1
+thread_local CompiledRegex::MatchData CompiledRegex::thread_match_data;
+#endif
+
+static const size_t max_patterns = 1024;
+static std::mutex registry_mtx;
+static std::unordered_map<std::string, RegexHandle> registry;
+static std::atomic<long> compile_count(0);
+static std::atomic<long> compile_micros(0);
+static std::atomic<long> match_count(0);
+static std::atomic<long> match_micros(0);
+static std::atomic<bool> timing_enabled(false);
+
+/**
+ * 不带句柄的调用按 pattern 字符串比较命中线程内的缓存，不构造 key、不加锁
+ */
+struct RecentRegex
+{
+    std::string pattern;
+    bool full_match = false;
+    RegexHandle handle;
+};
+static const size_t recent_size = 16;
+static thread_local RecentRegex recent[recent_size];
+static thread_local size_t recent_next = 0;
+
+static long elapsed_micros(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static RegexHandle fetch_compiled_regex(const std::string &pattern)
+{
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    auto found = registry.find(pattern);
+    if (found != registry.end())
+    {
+        return found->second;
+    }
+    auto start = std::chrono::steady_clock::now();
+    RegexHandle compiled = std::make_shared<const CompiledRegex>(pattern);
+    compile_count++;
+    compile_micros += elapsed_micros(start);
+    if (registry.size() >= max_patterns)
+    {
+        registry.clear();
+    }
+    //编译失败的 pattern 同样缓存，避免重复编译
+    registry.emplace(pattern, compiled);
+    return compiled;
+}
+
+static std::string full_match_pattern(const std::string &regex)
+{
+    return "\\A(?:" + regex + ")\\z";
+}
+
+RegexHandle regex_compile(const std::string &regex, bool full_match)
+{
+    return fetch_compiled_regex(full_match ? full_match_pattern(regex) : regex);
+}
+
+static const RegexHandle &fetch_recent_regex(const char *regex, bool full_match)
+{
+    size_t length = strlen(regex);
+    for (RecentRegex &item : recent)
+    {
+        if (item.handle &&
+            item.full_match == full_match &&
+            item.pattern.length() == length &&
+            memcmp(item.pattern.data(), regex, length) == 0)
+        {
+            return item.handle;
+        }
+    }
+    RecentRegex &item = recent[recent_next];
+    recent_next = (recent_next + 1) % recent_size;
+    item.pattern.assign(regex, length);
+    item.full_match = full_match;
+    item.handle = regex_compile(item.pattern, full_match);
+    return item.handle;
+}
+
+void regex_set_timing(bool enabled)
+{
+    timing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool regex_run(const RegexHandle &handle, const char *str, size_t length)
+{
+    if (nullptr == str ||
+        !handle ||
+        !handle->is_valid())
+    {
+        return false;
+    }
+    if (!timing_enabled.load(std::memory_order_relaxed))
+    {
+        return handle->search(str, length);
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool matched = handle->search(str, length);
+    match_count++;
+    match_micros += elapsed_micros(start);
+    return matched;
+}
+
+bool regex_match(const char *str, const char *regex)
+{
+    if (nullptr == str || nullptr == regex)
+    {
+        return false;
+    }
+    return regex_run(fetch_recent_regex(regex, true), str, strlen(str));
 }
 
 bool regex_search(const char *str, const char *regex)
 {
-    try
+    if (nullptr == str || nullptr == regex)
     {
-        const std::regex re(regex);
-        return std::regex_search(str, re);
+        return false;
     }
-    catch (std::regex_error &e)
+    return regex_run(fetch_recent_regex(regex, false), str, strlen(str));
+}
+
+RegexStats regex_stats()
+{
+    RegexStats stats;
     {
-        //skip
+        std::lock_guard<std::mutex> lock(registry_mtx);
+        stats.patterns = registry.size();
     }
-    return false;
+    stats.compile_count = compile_count;
+    stats.compile_micros = compile_micros;
+    stats.match_count = match_count;
+    stats.match_micros = match_micros;
+    return stats;
+}
+
+std::string regex_stats_to_string()
+{
+    RegexStats stats = regex_stats();
+    return std::to_string(stats.patterns) + " patterns, " +
+           std::to_string(stats.compile_count) + " compiles (" + std::to_string(stats.compile_micros) + "us), " +
+           std::to_string(stats.match_count) + " matches (" + std::to_string(stats.match_micros) + "us)";
 }
 
-} // namespace openrasp
\ No newline at end of file
+} // namespace openrasp
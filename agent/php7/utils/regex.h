@@ -17,10 +17,41 @@
 #ifndef _OPENRASP_UTILS_REGEX_H_
 #define _OPENRASP_UTILS_REGEX_H_
 
+#include <cstddef>
+#include <memory>
+#include <string>
+
 namespace openrasp
 {
+class CompiledRegex;
+typedef std::shared_ptr<const CompiledRegex> RegexHandle;
+
+struct RegexStats
+{
+    size_t patterns = 0;
+    long compile_count = 0;
+    long compile_micros = 0;
+    long match_count = 0;
+    long match_micros = 0;
+};
+
+/**
+ * 正则以 pattern 字符串为键在进程内编译一次（PHP 自带的 PCRE，支持时开启 JIT），之后复用
+ * regex_match 要求整个字符串匹配，regex_search 只需部分匹配
+ */
 bool regex_match(const char *str, const char *regex);
 bool regex_search(const char *str, const char *regex);
-}
+/**
+ * 固定 pattern 的调用点可以保存句柄，省去每次的查表；registry 清空后句柄依然有效
+ */
+RegexHandle regex_compile(const std::string &regex, bool full_match = false);
+bool regex_run(const RegexHandle &handle, const char *str, size_t length);
+/**
+ * 匹配次数与耗时只在开启时统计（debug.level 不为 0），编译次数与耗时始终统计
+ */
+void regex_set_timing(bool enabled);
+RegexStats regex_stats();
+std::string regex_stats_to_string();
+} // namespace openrasp
 
-#endif
\ No newline at end of file
+#endif
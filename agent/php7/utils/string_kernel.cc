@@ -0,0 +1,518 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "string_kernel.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OPENRASP_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace openrasp
+{
+namespace kernel
+{
+
+static inline unsigned char ascii_lower(unsigned char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+static inline bool is_utf8_trail(unsigned char ch)
+{
+    return (ch & 0xC0) == 0x80;
+}
+
+ByteSet::ByteSet(const char *bytes)
+    : ByteSet(bytes, strlen(bytes))
+{
+}
+
+ByteSet::ByteSet(const char *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        unsigned char ch = static_cast<unsigned char>(bytes[i]);
+        if (table[ch])
+        {
+            continue;
+        }
+        table[ch] = true;
+        if (count < sizeof(members))
+        {
+            members[count] = ch;
+        }
+        ++count;
+    }
+}
+
+/**
+ * 标量实现，同时用于向量化实现处理不足一个向量的尾部
+ */
+static const char *find_bytes_scalar(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len)
+{
+    const char *end = haystack + haystack_len - needle_len + 1;
+    for (const char *it = haystack; it < end; ++it)
+    {
+        it = static_cast<const char *>(memchr(it, needle[0], end - it));
+        if (nullptr == it)
+        {
+            return nullptr;
+        }
+        if (memcmp(it + 1, needle + 1, needle_len - 1) == 0)
+        {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+static bool equal_ignore_case_scalar(const char *lhs, const char *rhs, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (ascii_lower(static_cast<unsigned char>(lhs[i])) != ascii_lower(static_cast<unsigned char>(rhs[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static size_t find_first_of_scalar(const char *data, size_t length, const ByteSet &set)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (set.contains(static_cast<unsigned char>(data[i])))
+        {
+            return i;
+        }
+    }
+    return length;
+}
+
+static size_t ascii_prefix_scalar(const char *data, size_t length)
+{
+    size_t i = 0;
+    while (i < length && static_cast<unsigned char>(data[i]) < 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+#ifdef OPENRASP_KERNEL_X86
+
+/**
+ * 子串查找先比较首尾两个字节，两者都命中的位置再比较中间部分
+ */
+__attribute__((target("sse2"))) static const char *find_bytes_sse2(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len)
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    size_t i = 0;
+    for (; i + needle_len - 1 + 16 <= haystack_len; i += 16)
+    {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + needle_len - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (0 != mask)
+        {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, needle_len - 2) == 0)
+            {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    if (i + needle_len > haystack_len)
+    {
+        return nullptr;
+    }
+    return find_bytes_scalar(haystack + i, haystack_len - i, needle, needle_len);
+}
+
+__attribute__((target("avx2"))) static const char *find_bytes_avx2(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    size_t i = 0;
+    for (; i + needle_len - 1 + 32 <= haystack_len; i += 32)
+    {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + needle_len - 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        while (0 != mask)
+        {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, needle_len - 2) == 0)
+            {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    if (i + needle_len > haystack_len)
+    {
+        return nullptr;
+    }
+    return find_bytes_scalar(haystack + i, haystack_len - i, needle, needle_len);
+}
+
+__attribute__((target("sse2"))) static inline __m128i lower_sse2(__m128i value)
+{
+    __m128i shifted = _mm_sub_epi8(value, _mm_set1_epi8('A'));
+    __m128i upper = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('Z' - 'A')), shifted);
+    return _mm_or_si128(value, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+}
+
+__attribute__((target("avx2"))) static inline __m256i lower_avx2(__m256i value)
+{
+    __m256i shifted = _mm256_sub_epi8(value, _mm256_set1_epi8('A'));
+    __m256i upper = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('Z' - 'A')), shifted);
+    return _mm256_or_si256(value, _mm256_and_si256(upper, _mm256_set1_epi8('a' - 'A')));
+}
+
+__attribute__((target("sse2"))) static bool equal_ignore_case_sse2(const char *lhs, const char *rhs, size_t length)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i left = lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + i)));
+        __m128i right = lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(left, right)) != 0xFFFF)
+        {
+            return false;
+        }
+    }
+    return equal_ignore_case_scalar(lhs + i, rhs + i, length - i);
+}
+
+__attribute__((target("avx2"))) static bool equal_ignore_case_avx2(const char *lhs, const char *rhs, size_t length)
+{
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i left = lower_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i)));
+        __m256i right = lower_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i)));
+        if (static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(left, right))) != 0xFFFFFFFFu)
+        {
+            return false;
+        }
+    }
+    return equal_ignore_case_scalar(lhs + i, rhs + i, length - i);
+}
+
+__attribute__((target("sse2"))) static size_t find_first_of_sse2(const char *data, size_t length, const ByteSet &set)
+{
+    const unsigned char *members = set.get_members();
+    size_t count = set.size();
+    __m128i needles[8];
+    for (size_t k = 0; k < count; ++k)
+    {
+        needles[k] = _mm_set1_epi8(static_cast<char>(members[k]));
+    }
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i hit = _mm_setzero_si128();
+        for (size_t k = 0; k < count; ++k)
+        {
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[k]));
+        }
+        unsigned mask = _mm_movemask_epi8(hit);
+        if (0 != mask)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + find_first_of_scalar(data + i, length - i, set);
+}
+
+__attribute__((target("avx2"))) static size_t find_first_of_avx2(const char *data, size_t length, const ByteSet &set)
+{
+    const unsigned char *members = set.get_members();
+    size_t count = set.size();
+    __m256i needles[8];
+    for (size_t k = 0; k < count; ++k)
+    {
+        needles[k] = _mm256_set1_epi8(static_cast<char>(members[k]));
+    }
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i hit = _mm256_setzero_si256();
+        for (size_t k = 0; k < count; ++k)
+        {
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, needles[k]));
+        }
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (0 != mask)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + find_first_of_scalar(data + i, length - i, set);
+}
+
+__attribute__((target("sse2"))) static size_t ascii_prefix_sse2(const char *data, size_t length)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        unsigned mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+        if (0 != mask)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + ascii_prefix_scalar(data + i, length - i);
+}
+
+__attribute__((target("avx2"))) static size_t ascii_prefix_avx2(const char *data, size_t length)
+{
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i))));
+        if (0 != mask)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + ascii_prefix_scalar(data + i, length - i);
+}
+
+#endif
+
+struct KernelTable
+{
+    const char *name;
+    const char *(*find_bytes)(const char *, size_t, const char *, size_t);
+    bool (*equal_ignore_case)(const char *, const char *, size_t);
+    size_t (*find_first_of)(const char *, size_t, const ByteSet &);
+    size_t (*ascii_prefix)(const char *, size_t);
+};
+
+static KernelTable select_kernels()
+{
+    KernelTable table = {"scalar", find_bytes_scalar, equal_ignore_case_scalar, find_first_of_scalar, ascii_prefix_scalar};
+#ifdef OPENRASP_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        table = {"avx2", find_bytes_avx2, equal_ignore_case_avx2, find_first_of_avx2, ascii_prefix_avx2};
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        table = {"sse2", find_bytes_sse2, equal_ignore_case_sse2, find_first_of_sse2, ascii_prefix_sse2};
+    }
+#endif
+    return table;
+}
+
+static const KernelTable &kernels()
+{
+    static const KernelTable table = select_kernels();
+    return table;
+}
+
+const char *find_bytes(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len)
+{
+    if (0 == needle_len)
+    {
+        return haystack;
+    }
+    if (nullptr == haystack || needle_len > haystack_len)
+    {
+        return nullptr;
+    }
+    if (1 == needle_len)
+    {
+        return static_cast<const char *>(memchr(haystack, needle[0], haystack_len));
+    }
+    return kernels().find_bytes(haystack, haystack_len, needle, needle_len);
+}
+
+bool equal_ignore_case(const char *lhs, const char *rhs, size_t length)
+{
+    return kernels().equal_ignore_case(lhs, rhs, length);
+}
+
+bool starts_with_ignore_case(const char *str, size_t length, const char *prefix, size_t prefix_len)
+{
+    return prefix_len <= length && kernels().equal_ignore_case(str, prefix, prefix_len);
+}
+
+size_t find_first_of(const char *data, size_t length, const ByteSet &set)
+{
+    if (0 == set.size() || set.size() > 8)
+    {
+        return find_first_of_scalar(data, length, set);
+    }
+    return kernels().find_first_of(data, length, set);
+}
+
+/**
+ * p 处合法 UTF-8 序列的长度，非法时返回 0
+ */
+static size_t utf8_sequence_length(const unsigned char *p, size_t remaining)
+{
+    unsigned char lead = p[0];
+    if (lead < 0x80)
+    {
+        return 1;
+    }
+    size_t trails = 0;
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        trails = 1;
+    }
+    else if (lead == 0xE0)
+    {
+        trails = 2;
+        lower = 0xA0;
+    }
+    else if (lead == 0xED)
+    {
+        trails = 2;
+        upper = 0x9F;
+    }
+    else if (lead >= 0xE1 && lead <= 0xEF)
+    {
+        trails = 2;
+    }
+    else if (lead == 0xF0)
+    {
+        trails = 3;
+        lower = 0x90;
+    }
+    else if (lead >= 0xF1 && lead <= 0xF3)
+    {
+        trails = 3;
+    }
+    else if (lead == 0xF4)
+    {
+        trails = 3;
+        upper = 0x8F;
+    }
+    else
+    {
+        return 0;
+    }
+    if (remaining <= trails || p[1] < lower || p[1] > upper)
+    {
+        return 0;
+    }
+    for (size_t i = 2; i <= trails; ++i)
+    {
+        if (!is_utf8_trail(p[i]))
+        {
+            return 0;
+        }
+    }
+    return trails + 1;
+}
+
+size_t utf8_valid_length(const char *data, size_t length)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    auto ascii_prefix = kernels().ascii_prefix;
+    size_t i = 0;
+    while (i < length)
+    {
+        if (p[i] < 0x80)
+        {
+            i += ascii_prefix(data + i, length - i);
+            continue;
+        }
+        size_t sequence = utf8_sequence_length(p + i, length - i);
+        if (0 == sequence)
+        {
+            return i;
+        }
+        i += sequence;
+    }
+    return length;
+}
+
+static void append_utf8(std::string &out, char32_t cp)
+{
+    if (cp < 0x80)
+    {
+        out.push_back(static_cast<char>(cp));
+    }
+    else if (cp < 0x800)
+    {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000)
+    {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+std::string utf8_replace_invalid(const char *data, size_t length, char32_t replacement)
+{
+    std::string result;
+    result.reserve(length);
+    size_t pos = 0;
+    while (pos < length)
+    {
+        size_t valid = utf8_valid_length(data + pos, length - pos);
+        result.append(data + pos, valid);
+        pos += valid;
+        if (pos >= length)
+        {
+            break;
+        }
+        append_utf8(result, replacement);
+        unsigned char lead = static_cast<unsigned char>(data[pos++]);
+        //续字节或 0xF8 以上不是合法首字节，只跳过自身；否则连同后面的续字节一起视为一个非法序列
+        if (!is_utf8_trail(lead) && lead < 0xF8)
+        {
+            while (pos < length && is_utf8_trail(static_cast<unsigned char>(data[pos])))
+            {
+                ++pos;
+            }
+        }
+    }
+    return result;
+}
+
+const char *implementation()
+{
+    return kernels().name;
+}
+
+} // namespace kernel
+} // namespace openrasp
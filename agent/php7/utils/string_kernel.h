@@ -0,0 +1,77 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OPENRASP_UTILS_STRING_KERNEL_H_
+#define _OPENRASP_UTILS_STRING_KERNEL_H_
+
+#include <cstddef>
+#include <string>
+
+namespace openrasp
+{
+namespace kernel
+{
+
+/**
+ * 热点路径上的字符串原语，进程启动时按 CPUID 选择 AVX2 / SSE2 / 标量实现，结果与标量实现一致
+ */
+
+/**
+ * 字节集合，find_first_of 在集合不超过 8 个字节时走向量化实现
+ */
+class ByteSet
+{
+private:
+    bool table[256] = {false};
+    unsigned char members[8] = {0};
+    size_t count = 0;
+
+public:
+    explicit ByteSet(const char *bytes);
+    ByteSet(const char *bytes, size_t length);
+
+    bool contains(unsigned char ch) const
+    {
+        return table[ch];
+    }
+    size_t size() const
+    {
+        return count;
+    }
+    const unsigned char *get_members() const
+    {
+        return members;
+    }
+};
+
+//与 memmem 相同，未找到返回 nullptr
+const char *find_bytes(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len);
+//仅 ASCII 字母忽略大小写
+bool equal_ignore_case(const char *lhs, const char *rhs, size_t length);
+bool starts_with_ignore_case(const char *str, size_t length, const char *prefix, size_t prefix_len);
+//返回第一个属于集合的字节位置，未找到返回 length
+size_t find_first_of(const char *data, size_t length, const ByteSet &set);
+//返回最长合法 UTF-8 前缀的长度（RFC 3629，不接受过长编码、代理区与超出 U+10FFFF 的码点）
+size_t utf8_valid_length(const char *data, size_t length);
+//与 utfcpp replace_invalid 行为一致：每个非法序列替换为一个 replacement
+std::string utf8_replace_invalid(const char *data, size_t length, char32_t replacement);
+
+const char *implementation();
+
+} // namespace kernel
+} // namespace openrasp
+
+#endif
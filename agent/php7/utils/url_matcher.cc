@@ -0,0 +1,331 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "url_matcher.h"
+#include <cstring>
+#include <vector>
+
+namespace openrasp
+{
+
+static const uint32_t url_matcher_magic = 0x4C525557; // "WURL"
+
+struct MatcherHeader
+{
+    uint32_t magic;
+    uint32_t exact_count;
+    uint32_t suffix_count;
+    uint32_t any_begin;
+    uint32_t any_end;
+    uint32_t rule_count;
+};
+
+struct HostRecord
+{
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t rule_begin;
+    uint32_t rule_end;
+};
+
+struct RuleRecord
+{
+    uint32_t path_offset;
+    uint32_t path_length;
+    int64_t mask;
+};
+
+static inline char lower_char(char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+//共享内存中的数据不保证对齐，统一按字节复制读取
+template <typename T>
+static inline T load_record(const char *data, size_t offset)
+{
+    T record;
+    memcpy(&record, data + offset, sizeof(T));
+    return record;
+}
+
+void UrlMatcherBuilder::add(const std::string &pattern, long mask)
+{
+    std::string host;
+    std::string path;
+    if (pattern != "*")
+    {
+        size_t slash = pattern.find('/');
+        host = pattern.substr(0, slash);
+        if (slash != std::string::npos)
+        {
+            path = pattern.substr(slash);
+        }
+    }
+    for (char &ch : host)
+    {
+        ch = lower_char(ch);
+    }
+    PathRules *rules = nullptr;
+    if (host.empty() || host == "*")
+    {
+        rules = &any_host;
+    }
+    else if (host.size() > 2 && host.compare(0, 2, "*.") == 0)
+    {
+        rules = &suffix_hosts[host.substr(2)];
+    }
+    else
+    {
+        rules = &exact_hosts[host];
+    }
+    (*rules)[path] |= mask;
+}
+
+std::string UrlMatcherBuilder::build() const
+{
+    std::vector<HostRecord> hosts;
+    std::vector<RuleRecord> rules;
+    std::string pool;
+    auto append_rules = [&](const PathRules &path_rules, uint32_t &begin, uint32_t &end) {
+        begin = rules.size();
+        for (auto &item : path_rules)
+        {
+            rules.push_back({static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(item.first.size()), item.second});
+            pool.append(item.first);
+        }
+        end = rules.size();
+    };
+    auto append_hosts = [&](const std::map<std::string, PathRules> &host_rules) {
+        for (auto &item : host_rules)
+        {
+            HostRecord record;
+            record.name_offset = pool.size();
+            record.name_length = item.first.size();
+            pool.append(item.first);
+            append_rules(item.second, record.rule_begin, record.rule_end);
+            hosts.push_back(record);
+        }
+    };
+    MatcherHeader header;
+    header.magic = url_matcher_magic;
+    header.exact_count = exact_hosts.size();
+    header.suffix_count = suffix_hosts.size();
+    append_hosts(exact_hosts);
+    append_hosts(suffix_hosts);
+    append_rules(any_host, header.any_begin, header.any_end);
+    header.rule_count = rules.size();
+
+    size_t pool_offset = sizeof(MatcherHeader) + hosts.size() * sizeof(HostRecord) + rules.size() * sizeof(RuleRecord);
+    for (auto &host : hosts)
+    {
+        host.name_offset += pool_offset;
+    }
+    for (auto &rule : rules)
+    {
+        rule.path_offset += pool_offset;
+    }
+    std::string result;
+    result.reserve(pool_offset + pool.size());
+    result.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    result.append(reinterpret_cast<const char *>(hosts.data()), hosts.size() * sizeof(HostRecord));
+    result.append(reinterpret_cast<const char *>(rules.data()), rules.size() * sizeof(RuleRecord));
+    result.append(pool);
+    return result;
+}
+
+UrlMatcher::UrlMatcher(const char *data, size_t size)
+        : data(data), size(size)
+{
+    if (nullptr == data || size < sizeof(MatcherHeader))
+    {
+        return;
+    }
+    MatcherHeader header = load_record<MatcherHeader>(data, 0);
+    size_t records_size = sizeof(MatcherHeader) +
+                                                (static_cast<size_t>(header.exact_count) + header.suffix_count) * sizeof(HostRecord) +
+                                                static_cast<size_t>(header.rule_count) * sizeof(RuleRecord);
+    if (header.magic != url_matcher_magic ||
+            records_size > size ||
+            header.any_begin > header.any_end ||
+            header.any_end > header.rule_count)
+    {
+        return;
+    }
+    exact_count = header.exact_count;
+    suffix_count = header.suffix_count;
+    any_begin = header.any_begin;
+    any_end = header.any_end;
+    rule_count = header.rule_count;
+    is_valid = true;
+}
+
+static int compare_host(const char *name, size_t name_length, const char *host, size_t host_length)
+{
+    size_t length = name_length < host_length ? name_length : host_length;
+    for (size_t i = 0; i < length; ++i)
+    {
+        unsigned char left = name[i];
+        unsigned char right = lower_char(host[i]);
+        if (left != right)
+        {
+            return left < right ? -1 : 1;
+        }
+    }
+    if (name_length == host_length)
+    {
+        return 0;
+    }
+    return name_length < host_length ? -1 : 1;
+}
+
+/**
+ * 前缀匹配，* 不跨越 /；* 只能在一段内回溯，保留最近一个 * 的回溯点即可
+ */
+static bool match_path(const char *pattern, size_t pattern_length, const char *path, size_t path_length)
+{
+    size_t p = 0;
+    size_t t = 0;
+    size_t star = pattern_length;
+    size_t mark = 0;
+    while (p < pattern_length)
+    {
+        if (pattern[p] == '*')
+        {
+            star = p++;
+            mark = t;
+        }
+        else if (t < path_length && pattern[p] == path[t])
+        {
+            ++p;
+            ++t;
+        }
+        else if (star != pattern_length && mark < path_length && path[mark] != '/')
+        {
+            p = star + 1;
+            t = ++mark;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+long UrlMatcher::match_rules(uint32_t begin, uint32_t end, const char *path, size_t path_length) const
+{
+    long mask = 0;
+    if (begin > end || end > rule_count)
+    {
+        return mask;
+    }
+    size_t rule_table = sizeof(MatcherHeader) + (static_cast<size_t>(exact_count) + suffix_count) * sizeof(HostRecord);
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        RuleRecord rule = load_record<RuleRecord>(data, rule_table + i * sizeof(RuleRecord));
+        if (static_cast<size_t>(rule.path_offset) + rule.path_length > size)
+        {
+            continue;
+        }
+        if (match_path(data + rule.path_offset, rule.path_length, path, path_length))
+        {
+            mask |= rule.mask;
+        }
+    }
+    return mask;
+}
+
+long UrlMatcher::match_host(uint32_t table, uint32_t count, const char *host, size_t host_length, const char *path, size_t path_length) const
+{
+    size_t low = 0;
+    size_t high = count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        HostRecord record = load_record<HostRecord>(data, sizeof(MatcherHeader) + (table + mid) * sizeof(HostRecord));
+        if (static_cast<size_t>(record.name_offset) + record.name_length > size)
+        {
+            return 0;
+        }
+        int result = compare_host(data + record.name_offset, record.name_length, host, host_length);
+        if (result == 0)
+        {
+            return match_rules(record.rule_begin, record.rule_end, path, path_length);
+        }
+        if (result < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return 0;
+}
+
+long UrlMatcher::match(const char *url, size_t length) const
+{
+    if (!is_valid)
+    {
+        return 0;
+    }
+    size_t host_length = 0;
+    while (host_length < length && url[host_length] != '/' && url[host_length] != '?' && url[host_length] != '#')
+    {
+        ++host_length;
+    }
+    const char *path = url + host_length;
+    size_t path_length = length - host_length;
+    //带端口时，不带端口的规则同样适用；IPv6 地址中的 : 不是端口分隔符
+    size_t name_length = host_length;
+    for (size_t i = host_length; i > 0; --i)
+    {
+        if (url[i - 1] == ':')
+        {
+            name_length = i - 1;
+            break;
+        }
+        if (url[i - 1] == ']' || url[i - 1] == '.')
+        {
+            break;
+        }
+    }
+
+    long mask = match_rules(any_begin, any_end, path, path_length);
+    size_t candidates[2] = {host_length, name_length};
+    size_t candidate_count = name_length == host_length ? 1 : 2;
+    for (size_t c = 0; c < candidate_count; ++c)
+    {
+        size_t candidate = candidates[c];
+        if (candidate == 0)
+        {
+            continue;
+        }
+        mask |= match_host(0, exact_count, url, candidate, path, path_length);
+        for (size_t i = 0; i < candidate; ++i)
+        {
+            if (url[i] == '.' && i + 1 < candidate)
+            {
+                mask |= match_host(exact_count, suffix_count, url + i + 1, candidate - i - 1, path, path_length);
+            }
+        }
+    }
+    return mask;
+}
+
+} // namespace openrasp
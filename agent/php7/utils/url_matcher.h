@@ -0,0 +1,78 @@
+/*
+ * Copyright 2017-2021 Baidu Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OPENRASP_UTILS_URL_MATCHER_H_
+#define _OPENRASP_UTILS_URL_MATCHER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace openrasp
+{
+
+/**
+ * hook.white 规则编译后的匹配器，规则格式为 host[/path]：
+ * host 为 * 或为空表示任意主机，*.example.com 匹配其任意子域名，不带端口时同时匹配任意端口；
+ * path 按前缀匹配，其中的 * 匹配路径中一段内的任意字符（不跨越 /）
+ *
+ * 编译结果是一段位置无关的连续内存，可以直接放入共享内存；条目数不设上限，只受字节数限制
+ */
+class UrlMatcherBuilder
+{
+public:
+    void add(const std::string &pattern, long mask);
+    std::string build() const;
+
+private:
+    typedef std::map<std::string, long> PathRules;
+    PathRules any_host;
+    std::map<std::string, PathRules> exact_hosts;
+    std::map<std::string, PathRules> suffix_hosts;
+};
+
+/**
+ * 只读视图，不复制也不分配内存；url 不含协议部分，如 www.example.com:8080/index.php?a=1
+ */
+class UrlMatcher
+{
+public:
+    UrlMatcher(const char *data, size_t size);
+
+    bool valid() const { return is_valid; }
+    /**
+     * 一次遍历返回所有命中规则的 mask 的并集
+     */
+    long match(const char *url, size_t length) const;
+
+private:
+    const char *data;
+    size_t size;
+    bool is_valid = false;
+    uint32_t exact_count = 0;
+    uint32_t suffix_count = 0;
+    uint32_t any_begin = 0;
+    uint32_t any_end = 0;
+    uint32_t rule_count = 0;
+
+    long match_host(uint32_t table, uint32_t count, const char *host, size_t host_length, const char *path, size_t path_length) const;
+    long match_rules(uint32_t begin, uint32_t end, const char *path, size_t path_length) const;
+};
+
+} // namespace openrasp
+
+#endif
@@ -15,14 +15,14 @@
  */
 
 #include "utf.h"
-#include "third_party/utfcpp/utf8.h"
+#include "string_kernel.h"
 
 namespace openrasp
 {
 
 std::string replace_invalid_utf8(const std::string &origin, char32_t replacement)
 {
-    return utf8::replace_invalid(origin, replacement);
+    return kernel::utf8_replace_invalid(origin.data(), origin.length(), replacement);
 }
 
 } // namespace openrasp
@@ -316,11 +316,23 @@ std::string YamlReader::detect_unknown_config_key()
         "body.maxbytes",
         "clientip.header",
         "security.weak_passwords",
+        "security.sensitive_paths",
+        "ssrf.custom_cidrs",
+        "ssrf.dns_timeout_millis",
+        "ssrf.dns_cache_ttl",
+        "mongo.maxbytes",
+        "input.max_depth",
+        "input.max_entries",
         "lru.max_size",
         "debug.level",
         "hook.white",
         "response.sampler_interval",
         "response.sampler_burst",
+        "response.chunk_size",
+        "response.overlap_window",
+        "response.prescan.enable",
+        "response.prescan.min_digits",
+        "response.prescan.signatures",
         "decompile.enable"};
     std::vector<std::string> found_keys = fetch_object_keys({});
     for (auto &key : found_keys)
@@ -1780,7 +1780,8 @@ if (! algorithmConfig.meta.is_dev && RASP.get_jsengine() !== 'v8') {
         }
 
         // 算法1: 匹配用户输入，简单识别逻辑是否发生改变
-        if (algorithmConfig.sql_userinput.action != 'ignore') {
+        // 开启污点追踪时，params.tainted 为 false 说明语句是常量、确定不含用户输入，无需匹配；未设置表示未知，仍需匹配
+        if (algorithmConfig.sql_userinput.action != 'ignore' && params.tainted !== false) {
             // 匹配 GET/POST/multipart 参数
             Object.keys(parameters).some(function (name) {
                 // 覆盖场景，后者仅PHP支持
@@ -1843,6 +1844,23 @@ if (! algorithmConfig.meta.is_dev && RASP.get_jsengine() !== 'v8') {
                 }
             }
 
+            // 污点追踪给出了用户输入在语句中的确切位置，可识别经过拼接、截取的参数
+            if (reason === false && params.taint_spans) {
+                params.taint_spans.some(function (span) {
+                    var value = params.query.substring(span.start, span.end)
+                    if (value.length < min_length) {
+                        return false
+                    }
+                    if (raw_tokens.length == 0) {
+                        raw_tokens = RASP.sql_tokenize(params.query, params.server)
+                    }
+                    if (is_token_changed(raw_tokens, span.start, value.length, 2, is_sql=true)) {
+                        reason = _("SQLi - SQL query structure altered by user input, request parameter name: %1%, value: %2%", [span.name, value])
+                        return true
+                    }
+                })
+            }
+
             if (reason !== false && !sqliWhiteManager.test(params.stack[0])) {
                 return {
                     action:     algorithmConfig.sql_userinput.action,
@@ -2597,7 +2615,8 @@ plugin.register('command', function (params, context) {
     }
 
     // 算法2: 检测命令注入，或者命令执行后门
-    if (algorithmConfig.command_userinput.action != 'ignore') {
+    // 开启污点追踪时，params.tainted 为 false 说明命令是常量、确定不含用户输入，无需匹配；未设置表示未知，仍需匹配
+    if (algorithmConfig.command_userinput.action != 'ignore' && params.tainted !== false) {
         var reason     = false
         var min_length = algorithmConfig.command_userinput.min_length
         var parameters = context.parameter || {}
@@ -2703,6 +2722,23 @@ plugin.register('command', function (params, context) {
             }
         }
 
+        // 污点追踪给出了用户输入在命令中的确切位置
+        if (reason === false && params.taint_spans) {
+            params.taint_spans.some(function (span) {
+                var value = cmd.substring(span.start, span.end)
+                if (value.length <= min_length) {
+                    return false
+                }
+                if (raw_tokens.length == 0) {
+                    raw_tokens = RASP.cmd_tokenize(cmd)
+                }
+                if (is_token_changed(raw_tokens, span.start, value.length)) {
+                    reason = _("Command injection - command structure altered by user input, request parameter name: %1%, value: %2%", [span.name, value])
+                    return true
+                }
+            })
+        }
+
         if (reason !== false)
         {
             return {